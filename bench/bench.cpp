@@ -0,0 +1,198 @@
+// renders a handful of heavy workloads into a `VirtualTerminal` and reports how long each
+// frame took, how many bytes it produced, and how many heap allocations it made.
+//
+// build and run with `make bench`. pass a workload name to only run that one, `--cached` to
+// turn on `Renderer::enableCaching`, `--parallel` to turn on `Renderer::enableParallelRendering`,
+// and `--frames N` to change how many frames are timed.
+
+#define STUI_IMPLEMENTATION
+#include <stui.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+using namespace stui;
+
+struct Workload
+{
+	string name;
+	Component* root;
+	function<void(int)> update;		// changes something before each frame
+};
+
+static size_t list_length = 100000;
+static vector<unique_ptr<TreeView::Node>> tree_nodes;
+
+static TreeView::Node* makeTreeNode(string name, uint32_t id)
+{
+	tree_nodes.emplace_back(new TreeView::Node{ name, {}, id, true });
+	return tree_nodes.back().get();
+}
+
+// the same boxes inside boxes as the nesting workload, but as a single static layout type
+template<int DEPTH>
+struct StaticNesting
+{
+	using type = conditional_t<DEPTH % 2 == 0, VBox<Label, typename StaticNesting<DEPTH - 1>::type>, HBox<Label, typename StaticNesting<DEPTH - 1>::type>>;
+
+	static type make() { return type(Label(string(1, static_cast<char>('a' + (DEPTH % 26))), -1), StaticNesting<DEPTH - 1>::make()); }
+	static Label& deepest(type& box) { return StaticNesting<DEPTH - 1>::deepest(box.template get<1>()); }
+};
+
+template<>
+struct StaticNesting<-1>
+{
+	using type = Label;
+
+	static type make() { return Label("0", -1); }
+	static Label& deepest(Label& label) { return label; }
+};
+
+static double percentile(const vector<double>& sorted, double p)
+{
+	if (sorted.empty()) return 0.0;
+	size_t index = static_cast<size_t>(p * (sorted.size() - 1));
+	return sorted[index];
+}
+
+static void runWorkload(const Workload& workload, VirtualTerminal& terminal, int frames)
+{
+	Renderer::requestFullRepaint();
+	for (int i = 0; i < 3; i++)
+	{
+		workload.update(i);
+		Renderer::render(workload.root);
+	}
+
+	vector<double> times;
+	times.reserve(frames);
+	size_t bytes = 0;
+	size_t allocations = 0;
+	size_t cells = 0;
+	for (int i = 0; i < frames; i++)
+	{
+		workload.update(i + 3);
+		auto start = chrono::steady_clock::now();
+		Renderer::render(workload.root);
+		auto end = chrono::steady_clock::now();
+		times.push_back(chrono::duration<double, milli>(end - start).count());
+		Renderer::RenderStats stats = Renderer::getLastRenderStats();
+		bytes += stats.bytes_emitted;
+		allocations += stats.allocations;
+		cells += stats.cells_changed;
+	}
+
+	double total = 0.0;
+	for (double t : times) total += t;
+	sort(times.begin(), times.end());
+	printf("%-10s %8.3f %8.3f %8.3f %8.3f %10zu %8zu %10.1f\n", workload.name.c_str(),
+		total / frames, percentile(times, 0.5), percentile(times, 0.99), times.back(),
+		bytes / frames, cells / frames, static_cast<double>(allocations) / frames);
+}
+
+int main(int argc, char** argv)
+{
+	const char* only = nullptr;
+	int frames = 200;
+	bool cached = false;
+	bool parallel = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--cached") == 0) cached = true;
+		else if (strcmp(argv[i], "--parallel") == 0) parallel = true;
+		else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) frames = max(1, atoi(argv[++i]));
+		else only = argv[i];
+	}
+
+	Renderer::enableCaching(cached);
+	Renderer::enableParallelRendering(parallel);
+	VirtualTerminal terminal(Coordinate{ 160, 50 });
+	Terminal::setBackend(&terminal);
+
+	// 40 levels of boxes inside boxes, with a label changing at the bottom
+	vector<unique_ptr<Component>> boxes;
+	Label deepest("0", -1);
+	Component* inner = &deepest;
+	for (int depth = 0; depth < 40; depth++)
+	{
+		Label* label = new Label(string(1, static_cast<char>('a' + (depth % 26))), -1);
+		boxes.emplace_back(label);
+		if (depth % 2 == 0) boxes.emplace_back(new VerticalBox({ label, inner }));
+		else boxes.emplace_back(new HorizontalBox({ label, inner }));
+		inner = boxes.back().get();
+	}
+	Component* nesting_root = inner;
+	StaticNesting<39>::type static_nesting = StaticNesting<39>::make();
+	Label& static_deepest = StaticNesting<39>::deepest(static_nesting);
+
+	// a list too long to hold as strings, scrolling a row at a time
+	ListView list([]() { return list_length; }, [](size_t i) { return "row " + to_string(i); }, 0, 0);
+	BorderedBox list_box(&list, "list");
+
+	// 200 branches of 1000 leaves each, with the selection walking down
+	TreeView::Node* tree_root = makeTreeNode("root", 0);
+	for (uint32_t b = 0; b < 200; b++)
+	{
+		TreeView::Node* branch = makeTreeNode("branch " + to_string(b), b + 1);
+		for (uint32_t l = 0; l < 1000; l++)
+			branch->children.push_back(makeTreeNode("leaf " + to_string(l), 1000 + (b * 1000) + l));
+		tree_root->children.push_back(branch);
+	}
+	TreeView tree(tree_root, 0, 0);
+	BorderedBox tree_box(&tree, "tree");
+
+	// about a megabyte of wrapped text, scrolling a line at a time
+	string text;
+	text.reserve(1 << 20);
+	while (text.size() < (1 << 20))
+		text += "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua. ";
+	TextArea text_area(text, 0);
+	BorderedBox text_box(&text_area, "text");
+
+	// a moving gradient which changes every cell of the screen each frame, scaled down from twice the size
+	Coordinate image_size{ 320, 200 };
+	vector<uint8_t> image_pixels(static_cast<size_t>(image_size.x) * image_size.y * 4, 255);
+	ColourImageView image(image_pixels.data(), image_size, ColourImageView::RGBA);
+
+	// the list, tree and text side by side, all changing at once
+	HorizontalBox split({ &list_box, &tree_box, &text_box });
+	auto update_list = [&](int f) { list.selected_index = f % 1000; list.scroll = f % 1000; list.markDirty(); };
+	auto update_tree = [&](int f) { tree.selected_index = static_cast<size_t>(f) * 37; tree.scroll = tree.selected_index; tree.markDirty(); };
+	auto update_text = [&](int f) { text_area.scroll = f; text_area.markDirty(); };
+
+	vector<Workload> workloads =
+	{
+		{ "nesting", nesting_root, [&](int f) { deepest.text = to_string(f); deepest.markDirty(); } },
+		{ "static", &static_nesting, [&](int f) { static_deepest.text = to_string(f); static_deepest.markDirty(); } },
+		{ "list", &list_box, update_list },
+		{ "tree", &tree_box, update_tree },
+		{ "text", &text_box, update_text },
+		{ "image", &image, [&](int f)
+			{
+				for (int y = 0; y < image_size.y; y++)
+					for (int x = 0; x < image_size.x; x++)
+					{
+						uint8_t* pixel = image_pixels.data() + ((x + (y * image_size.x)) * 4);
+						pixel[0] = static_cast<uint8_t>(((x / 2) + f) * 4) & 0xF8;
+						pixel[1] = static_cast<uint8_t>(((y / 2) + f) * 4) & 0xF8;
+						pixel[2] = static_cast<uint8_t>((x + y) & 0xF8);
+					}
+				image.imageChanged();
+			} },
+		{ "split", &split, [&](int f) { update_list(f); update_tree(f); update_text(f); } },
+	};
+
+	printf("%d frames at %dx%d%s%s\n", frames, terminal.getSize().x, terminal.getSize().y,
+		cached ? ", with caching" : "", parallel ? ", in parallel" : "");
+	printf("%-10s %8s %8s %8s %8s %10s %8s %10s\n", "workload", "mean ms", "p50 ms", "p99 ms", "max ms", "bytes", "cells", "allocs");
+	for (const Workload& workload : workloads)
+		if (only == nullptr || workload.name == only)
+			runWorkload(workload, terminal, frames);
+
+	Renderer::enableParallelRendering(false);
+	Terminal::setBackend(nullptr);
+	return 0;
+}
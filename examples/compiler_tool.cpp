@@ -1,6 +1,12 @@
 #define STUI_IMPLEMENTATION
 #include <stui.h>
 #include <stui_extensions.h>
+#include <memory>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 using namespace stui;
 
@@ -13,7 +19,23 @@ BorderedBox output_file_box(&output_file, "output file");
 VerticalBox left_box({ &input_files_box, &output_file_box });
 SizeLimiter slm(&left_box, Coordinate{ 32, -1 });
 
-RadioButton compiler_selection({ "g++", "clang++", }, 0, true);
+void updateCommandHelp();
+
+// fetches the help text for whichever compiler was just picked
+class CompilerSelection : public RadioButton
+{
+public:
+    CompilerSelection(vector<string> _options) : RadioButton(_options, 0, true) { }
+
+    bool handleInput(uint8_t input_character, Input::ControlKeys modifiers) override
+    {
+        bool consumed = RadioButton::handleInput(input_character, modifiers);
+        updateCommandHelp();
+        return consumed;
+    }
+};
+
+CompilerSelection compiler_selection({ "g++", "clang++", });
 HorizontalDivider hdv;
 TextArea compiler_help("", 0);
 TextInputBox options_input("-Wall", nullptr, true);
@@ -30,7 +52,7 @@ HorizontalBox main_view({ &slm, &mid_box, &slm2 });
 
 Spinner activity_indicator(0, 0);
 HorizontalSpacer sp(1);
-TextArea command_output("", 0);
+LogView command_output(5000);
 HorizontalBox command_box({ &activity_indicator, &sp, &command_output });
 Label shortcut_label("", -1);
 
@@ -48,36 +70,36 @@ VerticalBox dialog_root({ &dialog_box, &bvs, &hdv, &dialog_shortcuts });
 
 Page dialog_page;
 
-bool continue_dialog_rendering = false;
-
 void cancelDialog()
 {
-    continue_dialog_rendering = false;
+    dialog_page.stop();
+}
+
+// shows the dialog until it's confirmed or cancelled, then goes back to the main page
+void runDialog(string name, void (*callback)())
+{
+    add_file.text = "";
+    add_file.callback = callback;
+    add_file.markDirty();
+    dialog_box.name = name;
+    dialog_box.markDirty();
+
+    dialog_page.run();
 }
 
 void endAddInputFile()
 {
     if (add_file.text != "")
     {
-        continue_dialog_rendering = false;
+        dialog_page.stop();
         selected_input_files.elements.push_back(add_file.text);
+        selected_input_files.markDirty();
     }
 }
 
 void addInputFileCallback()
 {
-    add_file.text = "";
-    add_file.callback = endAddInputFile;
-    dialog_box.name = "add input file";
-
-    continue_dialog_rendering = true;
-
-    while (continue_dialog_rendering)
-    {
-        dialog_page.framerate(24);
-        dialog_page.checkInput();
-        dialog_page.render();
-    }
+    runDialog("add input file", endAddInputFile);
 }
 
 void removeInputFileCallback()
@@ -86,31 +108,22 @@ void removeInputFileCallback()
     for (size_t i = selected_input_files.selected_index; i < selected_input_files.elements.size() - 1; i--)
         selected_input_files.elements[i] = selected_input_files.elements[i + 1];
     selected_input_files.elements.pop_back();
+    selected_input_files.markDirty();
 }
 
 void endAddIncludeDir()
 {   
     if (add_file.text != "")
     {
-        continue_dialog_rendering = false;
+        dialog_page.stop();
         include_dirs.elements.push_back(add_file.text);
+        include_dirs.markDirty();
     }
 }
 
 void addIncludeDirCallback()
 {
-    add_file.text = "";
-    add_file.callback = endAddIncludeDir;
-    dialog_box.name = "add include directory";
-
-    continue_dialog_rendering = true;
-
-    while (continue_dialog_rendering)
-    {
-        dialog_page.framerate(24);
-        dialog_page.checkInput();
-        dialog_page.render();
-    }
+    runDialog("add include directory", endAddIncludeDir);
 }
 
 void removeIncludeDirCallback()
@@ -119,29 +132,57 @@ void removeIncludeDirCallback()
     for (size_t i = include_dirs.selected_index; i < include_dirs.elements.size() - 1; i--)
         include_dirs.elements[i] = include_dirs.elements[i + 1];
     include_dirs.elements.pop_back();
+    include_dirs.markDirty();
 }
 
-bool command_running = false;
-string command_output_text = "";
-void commandThread(string cmd)
+// runs a command on the task's thread, sending its output to the target as it arrives. the output
+// is polled rather than waited on, so that cancelling the task stops the command straight away
+template <typename T>
+void streamCommandOutput(string cmd, Task& task, T* target)
 {
-    char buffer[128];
-    command_output_text = "";
-    FILE* pipe = popen(("2>&1 " + cmd).c_str(), "r");
-    if (!pipe) command_output_text = "unable to open command pipe";
-    try {
-        while (fgets(buffer, 128, pipe) != nullptr)
+    int fds[2];
+    pid_t pid = -1;
+    if (pipe2(fds, O_CLOEXEC) == 0)
+    {
+        pid = fork();
+        if (pid == 0)
         {
-            command_output_text += buffer;
+            // in its own process group, so that cancelling stops anything the command starts too
+            setpgid(0, 0);
+            dup2(fds[1], STDOUT_FILENO);
+            dup2(fds[1], STDERR_FILENO);
+            execl("/bin/sh", "sh", "-c", cmd.c_str(), (char*)nullptr);
+            _exit(127);
         }
-    } catch (...)
+        close(fds[1]);
+        if (pid < 0) close(fds[0]);
+    }
+    if (pid < 0)
+    {
+        task.post(target, [target]() { target->append("unable to open command pipe"); });
+        return;
+    }
+
+    char buffer[128];
+    while (!task.isCancelled())
     {
-        command_output_text = "exception capturing command output";
+        pollfd readable{ fds[0], POLLIN, 0 };
+        int ready = poll(&readable, 1, 50);
+        if (ready < 0 && errno != EINTR) break;
+        if (ready <= 0) continue;
+        ssize_t length = read(fds[0], buffer, sizeof(buffer));
+        if (length <= 0) break;
+        string output(buffer, length);
+        task.post(target, [target, output]() { target->append(output); });
     }
-    pclose(pipe);
-    command_running = false;
+    if (task.isCancelled()) kill(-pid, SIGTERM);
+    close(fds[0]);
+    waitpid(pid, nullptr, 0);
 }
 
+bool command_running = false;
+unique_ptr<Task> command_task;
+
 void compileCallback()
 {
     string cmd = compiler_selection.options[compiler_selection.selected_index];
@@ -156,82 +197,60 @@ void compileCallback()
     for (string s : selected_input_files.elements)
         cmd += " " + s;
     
-    command_output.text = "running command '" + cmd + "'...";
-    main_page.render();
+    if (command_running) return;
+    command_output.appendLine("running command '" + cmd + "'...");
+    command_output.markDirty();
     
+    // the output is posted to the page while the command runs
     command_running = true;
-    thread t(commandThread, cmd);
-
-    float timer = 0.0f;
-    while (command_running)
-    {
-        auto ft = main_page.framerate(12);
-        timer += ft.delta_time;
-        if (timer >= 0.25f)
-        {
-            activity_indicator.state++;
-            timer -= 0.25f;
-        }
+    activity_indicator.animate(0.25f);
+    command_task = make_unique<Task>(main_page, [cmd](Task& task) { streamCommandOutput(cmd, task, &command_output); },
+        []() { command_output.appendLine("done."); command_output.markDirty(); command_running = false; activity_indicator.animate(0.0f); });
+}
 
-        main_page.render();
-    }
+// shortcuts which only apply while their list is focused
+Keymap input_files_keymap(
+{
+    Input::Shortcut{ Input::Key{ 'a', Input::ControlKeys::NONE }, addInputFileCallback },
+    Input::Shortcut{ Input::Key{ 'r', Input::ControlKeys::NONE }, removeInputFileCallback }
+});
+Keymap include_dirs_keymap(
+{
+    Input::Shortcut{ Input::Key{ 'a', Input::ControlKeys::NONE }, addIncludeDirCallback },
+    Input::Shortcut{ Input::Key{ 'r', Input::ControlKeys::NONE }, removeIncludeDirCallback }
+});
 
-    t.join();
+Component* last_focused = nullptr;
 
-    command_output.text = "output: " + command_output_text + "\ndone.";
-    main_page.render();
-}
-
-void updateShortcutsFromFocus()
+void updateShortcutLabel()
 {
-    if (selected_input_files.focused)
-    {
+    Component* focused = nullptr;
+    for (Component* c : main_page.focusable_component_sequence)
+        if (c->focused) focused = c;
+    if (focused == last_focused) return;
+    last_focused = focused;
+
+    if (focused == &selected_input_files)
         shortcut_label.text = "next step [tab]   trigger compile [ctrl b]   navigate [up/down arrows]   add input file [a]   remove input file [r]";
-        main_page.shortcuts = 
-        {
-            Input::Shortcut{ Input::Key{ 'a', Input::ControlKeys::NONE }, addInputFileCallback },
-            Input::Shortcut{ Input::Key{ 'r', Input::ControlKeys::NONE }, removeInputFileCallback },
-            Input::Shortcut{ Input::Key{ 'B', Input::ControlKeys::CTRL }, compileCallback }
-        };
-    }
-    else if (output_file.focused)
-    {
-        shortcut_label.text = "next step [tab]   trigger compile [ctrl b]";
-        main_page.shortcuts = { Input::Shortcut{ Input::Key{ 'B', Input::ControlKeys::CTRL }, compileCallback } };
-    }
-    else if (compiler_selection.focused)
-    {
+    else if (focused == &compiler_selection)
         shortcut_label.text = "next step [tab]   trigger compile [ctrl b]   navigate [up/down arrows]   select compiler [enter]";
-        main_page.shortcuts = { Input::Shortcut{ Input::Key{ 'B', Input::ControlKeys::CTRL }, compileCallback } };
-    }
-    else if (compiler_help.focused)
-    {
+    else if (focused == &compiler_help || focused == &command_output)
         shortcut_label.text = "next step [tab]   trigger compile [ctrl b]   scroll [up/down arrows]";
-        main_page.shortcuts = { Input::Shortcut{ Input::Key{ 'B', Input::ControlKeys::CTRL }, compileCallback } };
-    }
-    else if (options_input.focused)
-    {
-        shortcut_label.text = "next step [tab]   trigger compile [ctrl b]";
-        main_page.shortcuts = { Input::Shortcut{ Input::Key{ 'B', Input::ControlKeys::CTRL }, compileCallback } };
-    }
-    else if (include_dirs.focused)
-    {
+    else if (focused == &include_dirs)
         shortcut_label.text = "next step [tab]   trigger compile [ctrl b]   navigate [up/down arrows]   add include directory [a]   remove include directory [r]";
-        main_page.shortcuts = 
-        {
-            Input::Shortcut{ Input::Key{ 'a', Input::ControlKeys::NONE }, addIncludeDirCallback },
-            Input::Shortcut{ Input::Key{ 'r', Input::ControlKeys::NONE }, removeIncludeDirCallback },
-            Input::Shortcut{ Input::Key{ 'B', Input::ControlKeys::CTRL }, compileCallback }
-        };
-    }
-    else if (command_output.focused)
-    {
-        shortcut_label.text = "next step [tab]   trigger compile [ctrl b]   scroll [up/down arrows]";
-        main_page.shortcuts = { Input::Shortcut{ Input::Key{ 'B', Input::ControlKeys::CTRL }, compileCallback } };
-    }
+    else
+        shortcut_label.text = "next step [tab]   trigger compile [ctrl b]";
+    shortcut_label.markDirty();
+}
+
+void nextStepCallback()
+{
+    Page::advanceFocus();
+    updateShortcutLabel();
 }
 
 int last_selected_compiler = -1;
+unique_ptr<Task> help_task;
 
 void updateCommandHelp()
 {
@@ -239,22 +258,14 @@ void updateCommandHelp()
     {
         last_selected_compiler = compiler_selection.selected_index;
 
-        char buffer[128];
-        string result = "";
-        FILE* pipe = popen(("2>&1 " + compiler_selection.options[last_selected_compiler] + " --help").c_str(), "r");
-        if (!pipe) result = "unable to open command pipe";
-        try {
-            while (fgets(buffer, 128, pipe) != nullptr)
-            {
-                result += buffer;
-            }
-        } catch (...)
+        // stop the old task before starting the new one, so its output always arrives before this clears the text
+        help_task.reset();
+        string cmd = compiler_selection.options[last_selected_compiler] + " --help";
+        help_task = make_unique<Task>(main_page, [cmd](Task& task)
         {
-            result = "exception capturing command output";
-        }
-        pclose(pipe);
-
-        compiler_help.text = result;
+            task.post(&compiler_help, []() { compiler_help.text = ""; });
+            streamCommandOutput(cmd, task, &compiler_help);
+        });
     }
 }
 
@@ -265,22 +276,20 @@ int main()
     main_page.focusable_component_sequence = { &selected_input_files, &output_file, &compiler_selection, &compiler_help, &options_input, &include_dirs, &command_output };
     main_page.setRoot(&root);
     main_page.updateFocus();
+    main_page.keymap.bind(Input::Key{ 'B', Input::ControlKeys::CTRL }, compileCallback);
+    main_page.keymap.bind(Input::Key{ '\t', Input::ControlKeys::NONE }, nextStepCallback);
+    selected_input_files.keymap = &input_files_keymap;
+    include_dirs.keymap = &include_dirs_keymap;
 
     dialog_page.focusable_component_sequence = { &add_file };
-    dialog_page.shortcuts = { Input::Shortcut{ Input::Key{ '\e', Input::ControlKeys::NONE }, cancelDialog } };
+    dialog_page.keymap.bind(Input::Key{ '\e', Input::ControlKeys::NONE }, cancelDialog);
     dialog_page.setRoot(&dialog_root);
 
-    while (true)
-    {
-        main_page.framerate(32);
-        
-        main_page.checkInput();
-        Terminal::isTerminalResized();
-
-        updateShortcutsFromFocus();
-        updateCommandHelp();
-        main_page.render();
-    }
+    // only what's changed is redrawn, and only when input, a task or the spinner changes something
+    Renderer::enableCaching(true);
+    updateShortcutLabel();
+    updateCommandHelp();
+    main_page.run();
 
     return 0;
 }
\ No newline at end of file
@@ -38,22 +38,10 @@ int main()
     page.focusable_component_sequence.push_back(&text_field);
     page.focusable_component_sequence.push_back(&dummy_button);
     page.focusable_component_sequence.push_back(&disabled_button);
-    page.shortcuts.push_back(Input::Shortcut
-    {
-        Input::Key{ 'S', Input::ControlKeys::CTRL },
-        ctrlSCallback
-    });
+    page.keymap.bind(Input::Key{ 'S', Input::ControlKeys::CTRL }, ctrlSCallback);
     
-    bool dirty = true;
-    while(true)
-    {
-        Renderer::FrameData frame_data = page.framerate(12);
-
-        dirty |= page.checkInput();
-
-        if (dirty) page.render();
-        dirty = false;
-    }
+    // sleeps until there's input or the terminal is resized, then redraws
+    page.run();
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,76 @@
+#define STUI_IMPLEMENTATION
+#include <stui.h>
+#include <stui_extensions.h>
+
+// serves a little monitoring page to anyone who connects. try it with
+// `socat -,raw,echo=0 TCP:127.0.0.1:7001` from as many terminals as you like
+
+using namespace stui;
+
+void messageCallback();
+void leaveCallback();
+
+Page page;
+SessionServer server(&page);
+
+Label status_label("nobody here yet", -1);
+ProgressBar load_bar(0.0f);
+LogView event_log(200);
+BorderedBox event_log_border(&event_log, "events");
+TextInputBox message_field("", messageCallback, true);
+BorderedBox message_field_border(&message_field, "say something");
+Button leave_button("leave", leaveCallback, true);
+VerticalBox vertical({ &status_label, &load_bar, &event_log_border, &message_field_border, &leave_button });
+
+int tick = 0;
+
+void updateStatus(size_t watching)
+{
+    status_label.text = to_string(watching) + " watching";
+    status_label.markDirty();
+}
+
+void timerCallback()
+{
+    tick++;
+    load_bar.fraction = 0.5f + (0.5f * sin(tick * 0.3f));
+    load_bar.markDirty();
+}
+
+void messageCallback()
+{
+    if (message_field.text.empty()) return;
+    event_log.appendLine(message_field.text);
+    message_field.text.clear();
+    message_field.markDirty();
+}
+
+void leaveCallback()
+{
+    // callbacks run with the session whose user pressed the key active
+    server.disconnect(Terminal::getSession());
+}
+
+int main()
+{
+    page.setRoot(&vertical);
+    page.focusable_component_sequence.push_back(&message_field);
+    page.focusable_component_sequence.push_back(&leave_button);
+    page.keymap.bind(Input::Key{ '\e', Input::ControlKeys::NONE }, leaveCallback);
+
+    server.on_connect = [](Session*) { event_log.appendLine("someone joined"); updateStatus(server.getSessionCount()); };
+    // the connection which is leaving is still counted at this point
+    server.on_disconnect = [](Session*) { event_log.appendLine("someone left"); updateStatus(server.getSessionCount() - 1); };
+
+    if (!server.listenTCP(7001))
+    {
+        cerr << "couldn't listen on port 7001" << endl;
+        return 1;
+    }
+    cout << "listening on 127.0.0.1:7001" << endl;
+
+    // sleeps until someone connects, types something, or the timer fires
+    server.run(0.5f, timerCallback);
+
+    return 0;
+}
@@ -110,7 +110,7 @@ int main(int argc, char** argv)
         timer += delta.delta_time;
 
         pb.fraction = delta.active_fraction;//fmod(timer, 1.0f);
-        t1.text = "fps: " + to_string(1.0f / delta.delta_time);
+        t1.text = "fps: " + to_string(1.0f / delta.delta_time) + "  bytes: " + to_string(stui::Renderer::getLastRenderStats().bytes_emitted);
         s1.state = (timer * 8);
         s2.state = s1.state;
         s3.state = s1.state;
@@ -22,14 +22,18 @@
 #ifndef STUI_ONLY_UNDEFS
 
 #define RENDER_STUB virtual void render(Tixel* output_buffer, Coordinate size) override
+#define RENDERVIEW_STUB virtual void render(BufferView target) override
+#define LAYOUT_STUB virtual void layout(Coordinate size) override
 #define GETMINSIZE_STUB virtual inline Coordinate getMinSize() override
 #define GETMAXSIZE_STUB virtual inline Coordinate getMaxSize() override
+#define FIXEDSIZE_STUB(min_x, min_y, max_x, max_y) static constexpr bool has_fixed_size = true; auto fixedSizeOwner() const -> decltype(this); static constexpr Coordinate fixed_min_size{ min_x, min_y }; static constexpr Coordinate fixed_max_size{ max_x, max_y }; GETMINSIZE_STUB { return fixed_min_size; } GETMAXSIZE_STUB { return fixed_max_size; }
 #define HANDLEINPUT_STUB virtual bool handleInput(uint8_t input_character, Input::ControlKeys modifiers) override
+#define HANDLETEXTINPUT_STUB virtual bool handleTextInput(string_view text) override
 #define	ISFOCUSABLE_STUB virtual inline bool isFocusable() override
 #define GETTYPENAME_STUB(n) virtual inline string getTypeName() override { return n; }
 #define GETALLCHILDREN_STUB virtual inline vector<Component*> getAllChildren() override
-
-#define OUTPUT_TARGET cout
+#define GETCHILDCOUNT_STUB virtual inline size_t getChildCount() override
+#define GETCHILD_STUB virtual inline Component* getChild(size_t index) override
 
 #define ANSI_ESCAPE '\033'
 #define ANSI_CLEAR_SCREEN ANSI_ESCAPE << "[2J" 
@@ -91,10 +95,23 @@
 #include <vector>
 #include <chrono>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
+#include <memory>
 #include <cstring>
 #include <cmath>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <string_view>
+#include <tuple>
+#include <array>
+#include <type_traits>
+#include <cstdarg>
 
 using namespace std;
 
@@ -113,6 +130,14 @@ using namespace std;
 	#include <signal.h>
 	#include <termios.h>
 	#include <poll.h>
+	#include <unistd.h>
+	#include <fcntl.h>
+	#include <cerrno>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+	#include <emmintrin.h>
+	#define STUI_SSE2
 #endif
 
 
@@ -171,6 +196,87 @@ inline void debug(string str)
 #define DEBUG_TIMER_E(type)
 #endif
 
+#if defined(STUI_COUNT_ALLOCATIONS) && defined(STUI_IMPLEMENTATION)
+// incremented by the replacement `operator new` at the bottom of this file
+static thread_local size_t allocation_count = 0;
+#endif
+
+#ifdef STUI_IMPLEMENTATION
+/**
+ * @brief memory for short-lived bits of text built while drawing a frame.
+ * 
+ * everything is thrown away at the start of each frame, but the blocks themselves are kept,
+ * so once a frame has been drawn once, drawing it again doesn't need to allocate.
+ **/
+static thread_local struct ScratchArena
+{
+	vector<pair<char*, size_t>> blocks;
+	size_t current_block = 0;
+	size_t used = 0;
+
+	char* allocate(size_t size)
+	{
+		while (current_block < blocks.size() && used + size > blocks[current_block].second)
+		{
+			current_block++;
+			used = 0;
+		}
+		if (current_block == blocks.size())
+		{
+			size_t block_size = max(size, static_cast<size_t>(4096));
+			blocks.push_back(pair<char*, size_t>(new char[block_size], block_size));
+		}
+		char* memory = blocks[current_block].first + used;
+		used += size;
+		return memory;
+	}
+
+	void reset() { current_block = 0; used = 0; }
+
+	~ScratchArena() { for (auto& block : blocks) delete[] block.first; }
+} scratch_arena;
+#endif
+
+/**
+ * @brief checks whether a character should be kept by `stripNullsAndMore`.
+ * 
+ * @param c character to check
+ * @param others array of additional characters that should be excluded
+ * @return true if the character is renderable and not in `others`
+ **/
+inline bool isKeptCharacter(char c, const char* others)
+{
+	// auto-strip if the character is a non-renderable (compared unsigned, so UTF-8 bytes are kept)
+	if (static_cast<uint8_t>(c) < ' ' && c != '\n' && c != '\t' && c != '\b') return false;
+	// check if the current char is inside list to remove
+	for (size_t i = 0; others[i] != '\0'; i++)
+		if (c == others[i]) return false;
+	return true;
+}
+
+/**
+ * @brief checks whether a byte carries on a multi-byte UTF-8 character, rather than starting
+ * a new one.
+ * 
+ * @param c byte to check
+ * @return true if the byte belongs to the character before it
+ **/
+inline bool isContinuationByte(char c) { return (static_cast<uint8_t>(c) & 0xC0) == 0x80; }
+
+/**
+ * @brief get how many cells a byte of text takes up when drawn: tabs take four, the rest of a
+ * multi-byte UTF-8 character and other control characters take none, and everything else one.
+ * 
+ * @param c byte to measure
+ * @return width of the byte in cells
+ **/
+inline int getCharacterWidth(char c)
+{
+	if (c == '\t') return 4;
+	if (isContinuationByte(c)) return 0;
+	return (static_cast<uint8_t>(c) >= ' ' || c == '\b') ? 1 : 0;
+}
+
 /**
  * @brief removes any invalid characters from a string, as well as other
  * specified illegal characters
@@ -179,24 +285,16 @@ inline void debug(string str)
  * @param others array of additional characters that should be excluded
  * @return repaired string 
  **/
-string stripNullsAndMore(string str, const char* others)
+string stripNullsAndMore(string_view str, const char* others)
 #ifdef STUI_IMPLEMENTATION
 {
 	string result = "";
 	for (char c : str)
 	{
-		// auto-strip if the character is a non-renderable
-		if (c < ' ' && c != '\n' && c != '\t' && c != '\b') continue;
-		// check if the current char is inside list to remove
-		bool is_valid = true;
-		for (size_t i = 0; others[i] != '\0'; i++)
-			if (c == others[i]) is_valid = false;
-		if (is_valid)
-		{
-			// if not, keep it, swapping tab for some spaces
-			if (c == '\t') result += "    ";
-			else result += c;
-		}
+		if (!isKeptCharacter(c, others)) continue;
+		// keep it, swapping tab for some spaces
+		if (c == '\t') result += "    ";
+		else result += c;
 	}
 	return result;
 }
@@ -220,10 +318,22 @@ struct Coordinate
  * then this `Tixel` will inherit the colour configuration of the
  * previous pixel (for whichever of FG/BG were not specified for this
  * `Tixel`).
+ * 
+ * by default this is packed into 5 bytes. if `STUI_TRUECOLOUR` is defined
+ * (before including any STUI header, in every file), it's an aligned 8 bytes
+ * instead, with room for text attributes and 24-bit colours. the 24-bit
+ * colours are kept in a shared palette, and each `Tixel` only stores the
+ * index of its entry, so that comparing and copying `Tixel`s stays cheap.
+ * the palette is emptied by `Renderer::render` once it's half full, so
+ * palette entries only last until the end of the frame they're made in.
  **/
 #pragma pack(push)
+#ifdef STUI_TRUECOLOUR
+struct alignas(8) Tixel
+#else
 #pragma pack(1)
 struct Tixel
+#endif
 {
 	/**
 	 * @brief enumerates possible foreground and background colours
@@ -254,13 +364,100 @@ struct Tixel
 		BG_WHITE	= 0b11110000
 	};
 
+#ifdef STUI_TRUECOLOUR
+	/**
+	 * @brief enumerates text attributes, which can be or-ed together.
+	 **/
+	enum Attributes : uint8_t
+	{
+		BOLD			= 0b00000001,
+		DIM				= 0b00000010,
+		ITALIC			= 0b00000100,
+		UNDERLINE		= 0b00001000,
+		BLINK			= 0b00010000,
+		REVERSE			= 0b00100000,
+		STRIKETHROUGH	= 0b01000000
+	};
+
+	static constexpr uint32_t KEEP_COLOUR = 0xFFFFFFFF;	// use `colour` for this side, rather than a 24-bit colour
+#endif
+
 	uint32_t character = ' ';
 	ColourCommand colour = (ColourCommand)(ColourCommand::FG_WHITE | ColourCommand::BG_BLUE);
+#ifdef STUI_TRUECOLOUR
+	uint8_t attributes = 0;		// `Attributes` to draw this `Tixel` with
+	uint16_t true_colour = 0;	// palette entry from `makeTrueColour`, or 0 to just use `colour`
+#endif
 
 	inline void operator=(uint32_t c) { character = static_cast<uint32_t>(c); }
 	inline void operator=(uint8_t c) { character = static_cast<uint32_t>(c); }
 	inline void operator=(char c) { character = static_cast<uint32_t>(static_cast<uint8_t>(c)); }
 
+	/**
+	 * @brief adds the next byte of a multi-byte UTF-8 character to `character`, after the
+	 * bytes already there.
+	 * 
+	 * @param c continuation byte to add
+	 **/
+	inline void appendByte(char c)
+	{
+		for (int shift = 8; shift < 32; shift += 8)
+		{
+			if ((character >> shift) != 0) continue;
+			character |= static_cast<uint32_t>(static_cast<uint8_t>(c)) << shift;
+			return;
+		}
+	}
+
+	/**
+	 * @brief get everything about how this `Tixel` looks apart from its character, as a
+	 * single value, so that it's quick to tell when the terminal needs to switch style.
+	 * 
+	 * @returns style of the `Tixel`
+	 **/
+	inline uint32_t getStyle() const
+	{
+#ifdef STUI_TRUECOLOUR
+		return static_cast<uint32_t>(colour) | (static_cast<uint32_t>(attributes) << 8) | (static_cast<uint32_t>(true_colour) << 16);
+#else
+		return static_cast<uint32_t>(colour);
+#endif
+	}
+
+#ifdef STUI_TRUECOLOUR
+	/**
+	 * @brief find (or add) the palette entry for a pair of 24-bit colours. the result can be
+	 * reused until `getTrueColourGeneration` changes, which happens when the palette is
+	 * emptied at the start of a frame (and everything is drawn again).
+	 * 
+	 * the palette has room for 65535 pairs, and is emptied once it's half full, so each frame
+	 * has room for at least 32767 new ones. if one frame uses even more, this returns 0, and
+	 * `Tixel`s fall back to their `colour` until the next frame.
+	 * 
+	 * @param foreground colour as `0xRRGGBB`, or `KEEP_COLOUR`
+	 * @param background colour as `0xRRGGBB`, or `KEEP_COLOUR`
+	 * 
+	 * @returns value for `true_colour`
+	 **/
+	static uint16_t makeTrueColour(uint32_t foreground, uint32_t background);
+
+	/**
+	 * @brief get a number which changes whenever the palette is emptied, after which values
+	 * from `makeTrueColour` mean something else.
+	 * 
+	 * @returns current palette generation
+	 **/
+	static size_t getTrueColourGeneration();
+
+	/**
+	 * @brief set this `Tixel` to use a pair of 24-bit colours (see `makeTrueColour`).
+	 * 
+	 * @param foreground colour as `0xRRGGBB`, or `KEEP_COLOUR`
+	 * @param background colour as `0xRRGGBB`, or `KEEP_COLOUR`
+	 **/
+	inline void setTrueColour(uint32_t foreground, uint32_t background) { true_colour = makeTrueColour(foreground, background); }
+#endif
+
 	static int toANSI(ColourCommand c)
 #ifdef STUI_IMPLEMENTATION
 	{
@@ -292,6 +489,292 @@ struct Tixel
 };
 #pragma pack(pop)
 
+#ifdef STUI_TRUECOLOUR
+static_assert(sizeof(Tixel) == 8, "Tixel should be 8 bytes with STUI_TRUECOLOUR");
+
+#ifdef STUI_IMPLEMENTATION
+static vector<pair<uint32_t, uint32_t>> true_colour_palette{ { Tixel::KEEP_COLOUR, Tixel::KEEP_COLOUR } };	// entry 0 means no 24-bit colour
+static vector<uint16_t> true_colour_slots;	// hash table of palette entries by colour pair, where 0 is an empty slot
+static size_t true_colour_generation = 1;	// goes up each time the palette is emptied
+static mutex true_colour_lock;
+static bool true_colour_locking = false;	// components may be drawing on several threads at once
+
+static constexpr size_t TRUE_COLOUR_SLOTS = 1 << 17;	// twice the largest palette, so the table never gets too full
+
+uint16_t Tixel::makeTrueColour(uint32_t foreground, uint32_t background)
+{
+	if (foreground > 0xFFFFFF) foreground = KEEP_COLOUR;
+	if (background > 0xFFFFFF) background = KEEP_COLOUR;
+	if (foreground == KEEP_COLOUR && background == KEEP_COLOUR) return 0;
+
+	unique_lock<mutex> lock(true_colour_lock, defer_lock);
+	if (true_colour_locking) lock.lock();
+	if (true_colour_slots.empty())
+	{
+		// allocated once, and then reused each time the palette is emptied
+		true_colour_slots.assign(TRUE_COLOUR_SLOTS, 0);
+		true_colour_palette.reserve(0x10000);
+	}
+
+	// linear probing from the pair's hash, until it's found or there's an empty slot
+	uint64_t key = (static_cast<uint64_t>(foreground) << 32) | background;
+	size_t slot = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 47) & (TRUE_COLOUR_SLOTS - 1);
+	while (true_colour_slots[slot] != 0)
+	{
+		const pair<uint32_t, uint32_t>& entry = true_colour_palette[true_colour_slots[slot]];
+		if (entry.first == foreground && entry.second == background) return true_colour_slots[slot];
+		slot = (slot + 1) & (TRUE_COLOUR_SLOTS - 1);
+	}
+	if (true_colour_palette.size() > 0xFFFF) return 0;
+
+	uint16_t index = static_cast<uint16_t>(true_colour_palette.size());
+	true_colour_palette.push_back(pair<uint32_t, uint32_t>(foreground, background));
+	true_colour_slots[slot] = index;
+	return index;
+}
+
+size_t Tixel::getTrueColourGeneration() { return true_colour_generation; }
+
+/**
+ * @brief empties the palette if it's half full. anything drawn with the old entries has to
+ * be drawn again, which the caller must arrange.
+ * 
+ * @returns whether the palette was emptied
+ **/
+static bool recycleTrueColourPalette()
+{
+	if (true_colour_palette.size() <= 0x8000) return false;
+	true_colour_palette.resize(1);
+	fill(true_colour_slots.begin(), true_colour_slots.end(), static_cast<uint16_t>(0));
+	true_colour_generation++;
+	return true;
+}
+#endif
+#endif
+
+/**
+ * @brief checks whether two `Tixel`s are identical.
+ **/
+inline bool tixelsEqual(const Tixel& a, const Tixel& b) { return memcmp(&a, &b, sizeof(Tixel)) == 0; }
+
+/**
+ * @brief copies one `Tixel` into every cell of a range.
+ * 
+ * @param destination first `Tixel` of the range
+ * @param count number of `Tixel`s in the range
+ * @param value `Tixel` to copy
+ **/
+inline void fillTixels(Tixel* destination, size_t count, const Tixel& value)
+{
+	if (count == 0) return;
+	size_t filled = 0;
+#if defined(STUI_TRUECOLOUR) && defined(STUI_SSE2)
+	// two `Tixel`s per store
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	__m128i pair_of_tixels = _mm_set1_epi64x(static_cast<long long>(bits));
+	for (; filled + 2 <= count; filled += 2)
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + filled), pair_of_tixels);
+	for (; filled < count; filled++) memcpy(static_cast<void*>(destination + filled), &bits, sizeof(bits));
+#else
+	// copy in doubling blocks, which lets `memcpy` use whatever wide stores it likes
+	memcpy(destination, &value, sizeof(Tixel));
+	filled = 1;
+	while (filled < count)
+	{
+		size_t block = min(filled, count - filled);
+		memcpy(destination + filled, destination, block * sizeof(Tixel));
+		filled += block;
+	}
+#endif
+}
+
+/**
+ * @brief finds the first position at which two ranges of `Tixel`s differ.
+ * 
+ * @param a first range
+ * @param b second range
+ * @param count number of `Tixel`s in each range
+ * 
+ * @returns index of the first `Tixel` which differs, or `count` if they're identical
+ **/
+inline size_t findTixelDifference(const Tixel* a, const Tixel* b, size_t count)
+{
+	const uint8_t* bytes_a = reinterpret_cast<const uint8_t*>(a);
+	const uint8_t* bytes_b = reinterpret_cast<const uint8_t*>(b);
+	size_t length = count * sizeof(Tixel);
+	size_t i = 0;
+#ifdef STUI_SSE2
+	// compare 16 bytes at a time, and only look closer once something differs
+	for (; i + 16 <= length; i += 16)
+	{
+		__m128i block_a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes_a + i));
+		__m128i block_b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes_b + i));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(block_a, block_b)) != 0xFFFF) break;
+	}
+#else
+	for (; i + 8 <= length; i += 8)
+	{
+		uint64_t word_a, word_b;
+		memcpy(&word_a, bytes_a + i, sizeof(word_a));
+		memcpy(&word_b, bytes_b + i, sizeof(word_b));
+		if (word_a != word_b) break;
+	}
+#endif
+	for (; i < length; i++)
+		if (bytes_a[i] != bytes_b[i]) return i / sizeof(Tixel);
+	return count;
+}
+
+/**
+ * @brief non-owning view onto a rectangular region of a larger `Tixel` surface.
+ * 
+ * rows of the view are `stride` `Tixel`s apart in the underlying surface, so a
+ * container can hand each of its children a view onto exactly the part of its
+ * own area where that child should appear, and the child draws straight into
+ * its final position without any intermediate buffers or copies.
+ **/
+struct BufferView
+{
+	Tixel* surface = nullptr;		// first `Tixel` of the underlying surface
+	int stride = 0;					// number of `Tixel`s per row of the underlying surface
+	Coordinate origin{ 0,0 };		// position of the top-left corner of the view within the surface
+	Coordinate size{ 0,0 };			// size of the view
+
+	BufferView() { }
+	BufferView(Tixel* _surface, Coordinate _size) : surface(_surface), stride(_size.x), size(_size) { }
+	BufferView(Tixel* _surface, int _stride, Coordinate _origin, Coordinate _size) : surface(_surface), stride(_stride), origin(_origin), size(_size) { }
+
+	/**
+	 * @brief get a pointer to the first `Tixel` in a row of the view.
+	 * 
+	 * @param y row index, must be inside the view
+	 * @returns pointer to the start of the row
+	 **/
+	inline Tixel* row(int y) const { return surface + origin.x + ((origin.y + y) * stride); }
+
+	/**
+	 * @brief access a single `Tixel` in the view. no bounds checking is performed.
+	 * 
+	 * @param x column within the view
+	 * @param y row within the view
+	 * @returns reference to the `Tixel` at that position
+	 **/
+	inline Tixel& at(int x, int y) const { return row(y)[x]; }
+
+	/**
+	 * @brief checks whether the rows of this view are packed next to each other in
+	 * memory, in which case it can be treated as a plain `Tixel` array.
+	 * 
+	 * @returns true if the view is contiguous
+	 **/
+	inline bool isContiguous() const { return size.x == stride; }
+
+	/**
+	 * @brief checks whether the view has any area to draw into.
+	 * 
+	 * @returns true if the view is non-empty and points at a surface
+	 **/
+	inline bool isValid() const { return surface != nullptr && size.x > 0 && size.y > 0; }
+
+	/**
+	 * @brief create a view onto a region of this view. the region is clamped so that
+	 * it never extends outside this view.
+	 * 
+	 * @param offset position of the top-left corner of the region relative to this view
+	 * @param sub_size size of the region
+	 * @returns view onto the region
+	 **/
+	inline BufferView subView(Coordinate offset, Coordinate sub_size) const
+	{
+		Coordinate start{ max(0, min(offset.x, size.x)), max(0, min(offset.y, size.y)) };
+		Coordinate end{ max(start.x, min(offset.x + sub_size.x, size.x)), max(start.y, min(offset.y + sub_size.y, size.y)) };
+		return BufferView(surface, stride, Coordinate{ origin.x + start.x, origin.y + start.y }, Coordinate{ end.x - start.x, end.y - start.y });
+	}
+
+	/**
+	 * @brief fill the whole view with a single `Tixel` value.
+	 * 
+	 * @param value `Tixel` to copy into every cell of the view
+	 **/
+	inline void fill(Tixel value) const
+	{
+		if (!isValid()) return;
+		if (stride == size.x) { fillTixels(row(0), static_cast<size_t>(size.x) * size.y, value); return; }
+		for (int y = 0; y < size.y; y++)
+			fillTixels(row(y), static_cast<size_t>(size.x), value);
+	}
+};
+
+/**
+ * @brief somewhere other than the real terminal for the `Renderer` to draw to. see
+ * `Terminal::setBackend`.
+ **/
+class TerminalBackend
+{
+public:
+	/**
+	 * @brief receives bytes which would have been written to the terminal.
+	 * 
+	 * @param data bytes being written
+	 * @param length number of bytes
+	 **/
+	virtual void write(const char* data, size_t length) = 0;
+
+	/**
+	 * @returns size of the screen, in characters
+	 **/
+	virtual Coordinate getSize() = 0;
+
+	/**
+	 * @returns whether key presses should be read from this backend instead of the real
+	 * terminal (only on Linux)
+	 **/
+	virtual bool providesInput() { return false; }
+
+	/**
+	 * @brief reads whatever input has arrived, without waiting for more. only used if
+	 * `providesInput` returns true.
+	 * 
+	 * @param buffer where to put the bytes
+	 * @param capacity size of `buffer`
+	 * 
+	 * @returns number of bytes read, which is 0 if nothing is waiting
+	 **/
+	virtual size_t read(char* buffer, size_t capacity) { return 0; }
+
+	virtual ~TerminalBackend() { }
+};
+
+#ifdef STUI_IMPLEMENTATION
+static TerminalBackend* terminal_backend = nullptr;	// where output and the screen size come from instead of the real terminal, if set
+static string input_pending;				// bytes read from the terminal which haven't been turned into events yet
+static bool input_in_paste = false;			// between the start and end markers of a bracketed paste
+static string input_paste;					// text pasted so far, while `input_in_paste` is set
+static clock_type::time_point input_paste_updated;	// when the last of `input_paste` arrived
+static const size_t input_paste_limit = 1 << 20;	// length at which a paste is handed over without waiting for its end marker
+static const clock_type::duration input_paste_timeout = chrono::seconds(1);	// how long a paste can go without any more text arriving before it's handed over anyway
+static vector<string> input_pasted_text;	// text belonging to the `PASTE` events from the last call to `getQueuedKeyEvents`
+static size_t input_pasted_taken = 0;		// how many of those have been taken
+static bool input_stalled = false;			// input from a backend was left cut off by the last call to `getQueuedKeyEvents`
+#if defined(_WIN32)
+static vector<INPUT_RECORD> input_records;		// key events read from the console which haven't been turned into `Key`s yet
+static bool windows_resized_triggered = true;	// a `WINDOW_BUFFER_SIZE_EVENT` has been read since `Terminal::isTerminalResized` last checked
+static Coordinate windows_screen_size{ -1,-1 };	// size of the console window, or negative if it needs asking for again
+static Coordinate windows_window_origin{ 0,0 };	// position of the console window within its screen buffer
+
+// reads the size of the console window, and where it is within its screen buffer
+static inline bool readConsoleWindow(Coordinate& size, Coordinate& origin)
+{
+	CONSOLE_SCREEN_BUFFER_INFO info;
+	if (!GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) return false;
+	size = Coordinate{ info.srWindow.Right - info.srWindow.Left + 1, info.srWindow.Bottom - info.srWindow.Top + 1 };
+	origin = Coordinate{ info.srWindow.Left, info.srWindow.Top };
+	return true;
+}
+#endif
+#endif
+
 /**
  * @brief class which encapsulates input functionality which is used to receive and handle
  * input in useful ways. another way of encapsulating functionality to hide it from the you!
@@ -300,6 +783,7 @@ struct Tixel
 class Input
 {
 	friend class Renderer;
+	friend class Terminal;
 
 public:
 	/**
@@ -327,6 +811,17 @@ public:
 		RIGHT		= 0x14
 	};
 
+	/**
+	 * @brief enumerates other events which aren't single key strokes.
+	 * 
+	 * `PASTE` means a block of text arrived all at once, either pasted into the terminal or
+	 * typed as a character outside of ASCII. the text itself is fetched with `takePastedText`.
+	 **/
+	enum SpecialKeys
+	{
+		PASTE		= 0x15
+	};
+
 	/**
 	 * @brief describes a key input event. though we only care about key down or key repeat
 	 * events.
@@ -381,144 +876,79 @@ private:
 	 * keys like CTRL, SHIFT, ALT. also moves some relevant key presses down into the
 	 * ASCII range to make them easier to read (specifically the arrow keys).
 	 * 
+	 * on linux, all of the available input is read, and escape sequences which are split
+	 * between reads are held on to until the rest arrives. pasted text (with bracketed paste
+	 * mode, which `Terminal::configure` turns on) and non-ASCII text come through as single
+	 * `PASTE` events, whose text is fetched with `takePastedText`. a paste which is never
+	 * finished is handed over once it reaches `input_paste_limit` bytes, or when nothing more
+	 * has arrived for `input_paste_timeout`.
+	 * 
 	 * @returns list of key-press events
 	 **/
 	static vector<Key> getQueuedKeyEvents()
 #ifdef STUI_IMPLEMENTATION
 	{
 		vector<Key> events;
+		input_pasted_text.clear();
+		input_pasted_taken = 0;
 #if defined(_WIN32)
-		// find available
-		DWORD events_available;
-		GetNumberOfConsoleInputEvents(GetStdHandle(STD_INPUT_HANDLE), &events_available);
-		if (events_available < 1) return events;
-
-		// grab 32 of them
-		INPUT_RECORD records[32] = { };
-		DWORD records_read;
-
-		if (ReadConsoleInput(GetStdHandle(STD_INPUT_HANDLE), records, 32, &records_read) == 0)
-			throw runtime_error("input error");
-		
-		for (size_t i = 0; i < records_read; i++)
-			if (records[i].EventType == KEY_EVENT && records[i].Event.KeyEvent.bKeyDown)
-			{
-				Key k{ };
-				k.key = (uint8_t)records[i].Event.KeyEvent.uChar.AsciiChar;
-				if (records[i].Event.KeyEvent.wVirtualKeyCode == VK_UP) k.key = ArrowKeys::UP;
-				else if (records[i].Event.KeyEvent.wVirtualKeyCode == VK_DOWN) k.key = ArrowKeys::DOWN;
-				else if (records[i].Event.KeyEvent.wVirtualKeyCode == VK_LEFT) k.key = ArrowKeys::LEFT;
-				else if (records[i].Event.KeyEvent.wVirtualKeyCode == VK_RIGHT) k.key = ArrowKeys::RIGHT;
-				if (k.key == '\r') k.key = '\n';
-				k.control_states = ControlKeys::NONE;
-				DWORD control_key = records[i].Event.KeyEvent.dwControlKeyState;
-				if (control_key & 0x04) k.control_states = ControlKeys::CTRL;
-				else if (control_key & 0x08)
-				{
-					k.control_states = ControlKeys::CTRL;
-					k.key += 96;
-				}
-				else if (control_key & 0x10) k.control_states = ControlKeys::SHIFT;
-				else if (control_key & 0x01) k.control_states = ControlKeys::ALT;
-				else if (control_key & 0x02) k.control_states = ControlKeys::ALT;
-				if (records[i].Event.KeyEvent.wVirtualKeyCode == VK_DELETE)
-				{
-					k.key = 127;
-					k.control_states = ControlKeys::NONE;
-				}
-				events.push_back(k);
-			}
-#elif defined(__linux__)
-		// check if there are any events to read
-		if (kbhit() < 1) return events;
-
-		// read a queue of 64 events (or as many are available)
-		uint8_t buffer[64] = { 0 };
-		ssize_t bytes_read = read(STDIN_FILENO, buffer, 64);
-		for (ssize_t i = 0; i < bytes_read; i++)
+		readAvailableInput();
+		const vector<INPUT_RECORD>& records = input_records;
+		for (size_t i = 0; i < records.size(); i++)
 		{
-			int c = buffer[i];
-			// process escape sequences
-			if (c == '\e')
-			{
-				// unless it's actually just escape
-				if (i == bytes_read - 1) events.push_back(Key{ '\e', ControlKeys::NONE });
-				else if (buffer[i + 1] != '[')
-				{
-					// if there's no bracket then it's an alt-event
-					int c_next = buffer[i + 1];
-					events.push_back(Key{ linux_keymap[c_next].key, ControlKeys::ALT });
-					// skip to the next char so we don't process the same one twice
-					i++;
-				}
-				else if (i == bytes_read - 2)
-				{
-					// it could just be alt-bracket, not an escape sequences
-					events.push_back(Key{ '[', ControlKeys::ALT });
-					i++;
-				}
-				else
-				{
-					// otherwise it's an escape sequence
-					int c_next = buffer[i + 2];
-					if (c_next == 0x41)
-					{
-						events.push_back(Key{ ArrowKeys::UP, ControlKeys::NONE });
-						i += 2;
-					}
-					else if (c_next == 0x42)
-					{
-						events.push_back(Key{ ArrowKeys::DOWN, ControlKeys::NONE });
-						i += 2;
-					}
-					else if (c_next == 0x44)
-					{
-						events.push_back(Key{ ArrowKeys::LEFT, ControlKeys::NONE });
-						i += 2;
-					}
-					else if (c_next == 0x43)
-					{
-						events.push_back(Key{ ArrowKeys::RIGHT, ControlKeys::NONE });
-						i += 2;
-					}
-					else if (i <= bytes_read - 5 && c_next == '1' && buffer[i + 3] == ';' && buffer[i + 4] == '2')
-					{
-						int c_next_next = buffer[i + 5];
-						if (c_next_next == 0x41) events.push_back(Key{ ArrowKeys::UP, ControlKeys::SHIFT });
-						else if (c_next_next == 0x42) events.push_back(Key{ ArrowKeys::DOWN, ControlKeys::SHIFT });
-						else if (c_next_next == 0x44) events.push_back(Key{ ArrowKeys::LEFT, ControlKeys::SHIFT });
-						else if (c_next_next == 0x43) events.push_back(Key{ ArrowKeys::RIGHT, ControlKeys::SHIFT });
-						i += 5;
-					}
-					else if (i <= bytes_read - 4 && c_next == '3' && buffer[i + 3] == '~')
-					{
-						events.push_back(Key{ 127, ControlKeys::NONE });
-						i += 4;
-					}
-					else
-					{
-						// debug if it isnt handled
-						DEBUG_LOG("unhandled ANSI code: " + string((char*)buffer + i));
-						break;
-					}
-				}
-			}
-			else if (c < 128)
+			Key k{ };
+			k.key = (uint8_t)records[i].Event.KeyEvent.uChar.AsciiChar;
+			if (records[i].Event.KeyEvent.wVirtualKeyCode == VK_UP) k.key = ArrowKeys::UP;
+			else if (records[i].Event.KeyEvent.wVirtualKeyCode == VK_DOWN) k.key = ArrowKeys::DOWN;
+			else if (records[i].Event.KeyEvent.wVirtualKeyCode == VK_LEFT) k.key = ArrowKeys::LEFT;
+			else if (records[i].Event.KeyEvent.wVirtualKeyCode == VK_RIGHT) k.key = ArrowKeys::RIGHT;
+			if (k.key == '\r') k.key = '\n';
+			k.control_states = ControlKeys::NONE;
+			DWORD control_key = records[i].Event.KeyEvent.dwControlKeyState;
+			if (control_key & 0x04) k.control_states = ControlKeys::CTRL;
+			else if (control_key & 0x08)
 			{
-				// normal keypress, use the keymap as a look-up table
-				events.push_back(linux_keymap[c]);
+				k.control_states = ControlKeys::CTRL;
+				k.key += 96;
 			}
-			else
+			else if (control_key & 0x10) k.control_states = ControlKeys::SHIFT;
+			else if (control_key & 0x01) k.control_states = ControlKeys::ALT;
+			else if (control_key & 0x02) k.control_states = ControlKeys::ALT;
+			if (records[i].Event.KeyEvent.wVirtualKeyCode == VK_DELETE)
 			{
-				DEBUG_LOG("uh oh! unhandled UTF-8");
-				// TODO: handle utf8 oh dear god
-				break;
+				k.key = 127;
+				k.control_states = ControlKeys::NONE;
 			}
+			events.push_back(k);
 		}
-#endif
-		return events;
-	}
-#endif
+		input_records.clear();
+#elif defined(__linux__)
+		// read everything that's waiting, on top of anything left over from last time
+		bool read_any = readAvailableInput();
+		// a paste whose end marker never turns up would otherwise swallow everything typed after it
+		if (input_in_paste && clock_type::now() - input_paste_updated >= input_paste_timeout) finishPaste(events);
+		if (input_pending.empty()) return events;
+
+		size_t consumed = parseInput(input_pending, 0, false, events);
+		bool from_backend = terminal_backend != nullptr && terminal_backend->providesInput();
+		if (consumed < input_pending.size() && !from_backend)
+		{
+			// something got cut off part-way through, so give the rest of it a moment to arrive.
+			// if nothing else turns up, a lone escape was really just the escape key
+			if (kbhit(25) > 0) readAvailableInput();
+			consumed = parseInput(input_pending, consumed, true, events);
+		}
+		else if (consumed < input_pending.size())
+		{
+			// a backend can't be waited on, so the rest has until the next call to turn up
+			if (input_stalled && !read_any) consumed = parseInput(input_pending, consumed, true, events);
+			input_stalled = consumed < input_pending.size();
+		}
+		input_pending.erase(0, consumed);
+#endif
+		return events;
+	}
+#endif
 	;
 
 	/**
@@ -543,11 +973,11 @@ private:
 	 * @param shortcuts list of keyboard shortcut bindings
 	 * @param key_events list of key events to check
 	 **/
-	static void processShortcuts(vector<Shortcut> shortcuts, vector<Key>& key_events)
+	static void processShortcuts(const vector<Shortcut>& shortcuts, vector<Key>& key_events)
 #ifdef STUI_IMPLEMENTATION
 	{
 #ifdef DEBUG
-		for (Shortcut s : shortcuts)
+		for (const Shortcut& s : shortcuts)
 			if (s.binding.control_states != ControlKeys::ALT
 			 && s.binding.control_states != ControlKeys::SHIFT
 			 && s.binding.control_states != ControlKeys::CTRL
@@ -560,7 +990,7 @@ private:
 		{
 			Key k = key_events[i];
 			bool consumed = false;
-			for (Shortcut s : shortcuts)
+			for (const Shortcut& s : shortcuts)
 			{
 				if (compare(k, s.binding)) { consumed = true; s.callback(); }
 			}
@@ -590,16 +1020,7 @@ private:
 		for (size_t i = 0; i < key_events.size(); i++)
 		{
 			Key k = key_events[i];
-			if ((k.control_states == ControlKeys::NONE || k.control_states == ControlKeys::SHIFT) && (
-			      (k.key >= 32 && k.key <= 127) 
-			    || k.key == '\n' 
-			    || k.key == '\t' 
-			    || k.key == '\b'
-			    || k.key == 127
-			    || k.key == ArrowKeys::UP
-			    || k.key == ArrowKeys::DOWN
-			    || k.key == ArrowKeys::LEFT
-			    || k.key == ArrowKeys::RIGHT))
+			if (isTextCharacter(k))
 			{
 				result.push_back(pair<uint8_t, ControlKeys>(static_cast<uint8_t>(k.key), k.control_states));
 			}
@@ -616,2044 +1037,8458 @@ private:
 #endif
 	;
 
-#if defined(__linux__)
-	static inline int kbhit()
-	{
-		pollfd pfd;
-		pfd.fd = STDIN_FILENO;
-		pfd.events = POLLIN;
-		return poll(&pfd, 1, 0);
-	}
-#endif
-};
-
-/**
- * @brief base class from which all UI components inherit.
- * 
- * all `Component` subclasses must override the `render`, `getMaxSize`, and 
- * `getMinSize` methods (ideally using the relevant macros).
- **/
-#pragma pack(push)
-#pragma pack(8)
-class Component
-{
-public:
-	bool focused = false;
-
-	/**
-	 * @brief draws the `Component` into a `Tixel` buffer, with a specified size.
-	 * 
-	 * implementations should assume that the `output_buffer` has been allocated to be the correct
-	 * `size`, but should also check that any drawing is performed within the limits of the `size`
-	 * (otherwise you'll corrupt the heap, yippee!).
-	 * 
-	 * @param output_buffer buffer allocated by the caller to be drawn into. ordered left
-	 * to right, top to bottom
-	 * @param size size of the buffer
-	 **/
-	virtual inline void render(Tixel* output_buffer, Coordinate size) { }
-	
-	/**
-	 * @brief returns the maximum desired size that this component should be given.
-	 * 
-	 * note that the component may still be givena buffer larger than this size, so this should 
-	 * be handled if appropriate in `render`. either or both of these values can be given the 
-	 * value `-1` to indicate no maximum size in that dimension.
-	 * 
-	 * @returns a `Coordinate` representing the maximum size for the `Component`
-	 **/
-	virtual inline Coordinate getMaxSize() { return { 0, 0 }; }
-
-	/**
-	 * @brief returns the minimum size that this component should be given to draw into.
-	 *
-	 * functions which call `render` will try to ensure all components have at least
-	 * their minimum size requirements met, otherwise if not enough space cannot be allocated,
-	 * the `Component` will not be rendered. this function should never return negative values
-	 * for either dimension.
-	 *
-	 * @returns a `Coordinate` representing the minimum size for the `Component`
-	 **/
-	virtual inline Coordinate getMinSize() { return { 0, 0 }; }
-
 	/**
-	 * @brief handle a single key-press event.
+	 * @brief checks if a key event is one which text-handling components care about (printable
+	 * characters, and the keys used for editing).
 	 * 
-	 * not all subclasses need to implement this, but if you want to handle input you probably
-	 * should.
-	 * 
-	 * @param input_character the character to handle
-	 * @returns true if the input was consumed or false if not
+	 * @param k key event to check
+	 * @returns whether the key event should be passed on as text
 	 **/
-	virtual inline bool handleInput(uint8_t input_character, Input::ControlKeys modifiers) { return false; }
+	static inline bool isTextCharacter(Key k)
+	{
+		return (k.control_states == ControlKeys::NONE || k.control_states == ControlKeys::SHIFT) && (
+			  (k.key >= 32 && k.key <= 127) 
+			|| k.key == '\n' 
+			|| k.key == '\t' 
+			|| k.key == '\b'
+			|| k.key == 127
+			|| k.key == ArrowKeys::UP
+			|| k.key == ArrowKeys::DOWN
+			|| k.key == ArrowKeys::LEFT
+			|| k.key == ArrowKeys::RIGHT);
+	}
 
 	/**
-	 * @brief returns whether or not the component can be focused for input.
-	 * 
-	 * should be overriden by subclasses which want to receive input.
+	 * @brief fetches the text belonging to the next `PASTE` event returned by the last call to
+	 * `getQueuedKeyEvents`. call this once for each `PASTE` event, in order.
 	 * 
-	 * @returns true if the component is focusable
+	 * @returns the pasted text, or an empty string if there isn't any left
 	 **/
-	virtual inline bool isFocusable() { return false; }
-
-	/**
-	 * @brief get the string description of this component type. should be
-	 * overridden by subclasses and return a string that matches the class name.
-	 * 
-	 * @returns string name of the class/component type
-	 */
-	virtual inline string getTypeName() { return ""; }
-
-	/**
-	 * @brief return a list of any children this component has. subclasses
-	 * which allow child components should return them here.
-	 * 
-	 * @returns list of contained children
-	 */
-	virtual inline vector<Component*> getAllChildren() { return { }; }
-
-	virtual ~Component() { }
-};
-#pragma pack(pop)
+	static string takePastedText()
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (input_pasted_taken >= input_pasted_text.size()) return string();
+		return move(input_pasted_text[input_pasted_taken++]);
+	}
+#endif
+	;
 
-/**
- * @brief class which encapsulates the utility functions that many of `Component`s reuse but
- * which probably shouldn't be publicly accessible outside the header file. basically ignore
- * this.
- **/
-class Utility
-{
-protected:
+#if defined(_WIN32)
 	/**
-	 * @brief draws a box outline using IBM box drawing characters from standard extended ASCII.
-	 * 
-	 * it's up to the caller to ensure `buffer` is allocated to the size specified by `buffer_size`
+	 * @brief reads every record waiting in the console's input buffer. key presses are added to
+	 * `input_records`, and resizes are remembered for `Terminal::isTerminalResized`, so the size
+	 * of the console never has to be polled.
 	 * 
-	 * @param box_origin offset of the start of the box from the top-left corner of the buffer.
-	 * may be negative, though areas of the box outside the buffer won't be drawn
-	 * @param box_size size of the box. must be positive in both axes. can result in a box which
-	 * ends outside the bounds of the buffer, but areas outside won't be drawn
-	 * @param buffer pointer to a character array ordered left-to-right, top-to-bottom
-	 * @param buffer_size size of the allocated buffer, must match with the size of the `buffer`
+	 * @returns whether any key presses were read
 	 **/
-	static void drawBox(Coordinate box_origin, Coordinate box_size, Tixel* buffer, Coordinate buffer_size)
+	static bool readAvailableInput()
 #ifdef STUI_IMPLEMENTATION
 	{
-		if (buffer == nullptr) return;
-		if (box_size.x <= 0 || box_size.y <= 0) return;
-
-		if (box_origin.y >= 0 && box_origin.y < buffer_size.y)
+		HANDLE input = GetStdHandle(STD_INPUT_HANDLE);
+		size_t records_before = input_records.size();
+		DWORD events_available = 0;
+		while (GetNumberOfConsoleInputEvents(input, &events_available) && events_available > 0)
 		{
-			for (int x = box_origin.x; x < box_origin.x + box_size.x; x++)
-			{
-				if (x < 0) continue;
-				if (x >= buffer_size.x) break;
-
-				buffer[x + (box_origin.y * buffer_size.x)] = (x == box_origin.x ? UNICODE_BOX_TOPLEFT : (x == box_origin.x + box_size.x - 1 ? UNICODE_BOX_TOPRIGHT : UNICODE_BOX_HORIZONTAL));
-			}
-		}
-
-		for (int y = box_origin.y + 1; y < box_origin.y + box_size.y - 1; y++)
-		{
-			if (y < 0) continue;
-			if (y >= buffer_size.y) break;
-
-			if (box_origin.x >= 0 && box_origin.x < buffer_size.x)
-				buffer[box_origin.x + (y * buffer_size.x)] = UNICODE_BOX_VERTICAL;
-
-			if (box_origin.x + box_size.x - 1 >= 0 && box_origin.x + box_size.x - 1 < buffer_size.x)
-				buffer[box_origin.x + box_size.x + (y * buffer_size.x) - 1] = UNICODE_BOX_VERTICAL;
-		}
+			INPUT_RECORD records[32] = { };
+			DWORD records_read = 0;
+			if (ReadConsoleInput(input, records, 32, &records_read) == 0)
+				throw runtime_error("input error");
+			if (records_read == 0) break;
 
-		if (box_origin.y + box_size.y - 1 >= 0 && box_origin.y + box_size.y - 1 < buffer_size.y)
-		{
-			for (int x = box_origin.x; x < box_origin.x + box_size.x; x++)
+			for (DWORD i = 0; i < records_read; i++)
 			{
-				if (x < 0) continue;
-				if (x >= buffer_size.x) break;
-
-				buffer[x + ((box_origin.y + box_size.y - 1) * buffer_size.x)] = (x == box_origin.x ? UNICODE_BOX_BOTTOMLEFT : (x == box_origin.x + box_size.x - 1 ? UNICODE_BOX_BOTTOMRIGHT : UNICODE_BOX_HORIZONTAL));
+				if (records[i].EventType == WINDOW_BUFFER_SIZE_EVENT)
+				{
+					windows_resized_triggered = true;
+					windows_screen_size = Coordinate{ -1,-1 };
+				}
+				else if (records[i].EventType == KEY_EVENT && records[i].Event.KeyEvent.bKeyDown)
+					input_records.push_back(records[i]);
 			}
 		}
+		return input_records.size() > records_before;
 	}
 #endif
 	;
+#elif defined(__linux__)
+	static inline int kbhit(int timeout_ms = 0)
+	{
+		pollfd pfd;
+		pfd.fd = STDIN_FILENO;
+		pfd.events = POLLIN;
+		return poll(&pfd, 1, timeout_ms);
+	}
 
 	/**
-	 * @brief split a string at a delimiter character.
+	 * @brief reads everything which is currently waiting on stdin (or from the terminal backend,
+	 * if it `providesInput`) onto the end of `input_pending`.
 	 * 
-	 * @param text string to split
-	 * @param delim character to split at. this will be removed from the resulting array of strings
-	 * 
-	 * @returns array of strings
-	 */
-	static vector<string> splitString(string text, char delim)
+	 * @returns whether anything was read
+	 **/
+	static bool readAvailableInput()
+#ifdef STUI_IMPLEMENTATION
 	{
-		vector<string> result;
-		string current;
-
-		for (char c : text)
+		char buffer[4096];
+		size_t length_before = input_pending.size();
+		if (terminal_backend != nullptr && terminal_backend->providesInput())
 		{
-			if (c == delim)
-			{
-				result.push_back(current);
-				current = "";
-			}
-			else
-				current += c;
+			size_t bytes_read;
+			while ((bytes_read = terminal_backend->read(buffer, sizeof(buffer))) > 0)
+				input_pending.append(buffer, bytes_read);
+			return input_pending.size() > length_before;
 		}
-		result.push_back(current);
 
-		return result;
+		while (kbhit() > 0)
+		{
+			ssize_t bytes_read = read(STDIN_FILENO, buffer, sizeof(buffer));
+			if (bytes_read <= 0) break;
+			input_pending.append(buffer, static_cast<size_t>(bytes_read));
+		}
+		return input_pending.size() > length_before;
 	}
+#endif
+	;
 
 	/**
-	 * @brief converts a single string into an array of lines of a given maximum length.
-	 * 
-	 * respects line breaks, uses word-wrapping where possible, or forcibly breaks words 
-	 * if necessary.
+	 * @brief hands over the text pasted so far as a `PASTE` event, and goes back to reading
+	 * input normally.
 	 * 
-	 * @param text string on which to perform wrapping
-	 * @param max_width maximum number of characters to place in any row
-	 * 
-	 * @returns list of individual lines of text
+	 * @param events list to add the event to
 	 **/
-	static vector<string> wrapText(string text, size_t max_width)
+	static void finishPaste(vector<Key>& events)
 #ifdef STUI_IMPLEMENTATION
 	{
-		if (text.length() < 1)
-			return vector<string>({""});
-		vector<string> result;
-		size_t start = 0;
-		while (start != string::npos)
-		{
-			start++;
-			size_t end = text.find('\n', start);
-			vector<string> tmp = wrapTextInner(text.substr(start, end - start), max_width);
-			for (string s : tmp) result.push_back(s);
-			start = end;
-		}
-		//	i hate this
-		if (result.size() > 0)
-			result[0] = string(1, text[0]) + result[0];
-		return result;
+		input_in_paste = false;
+		events.push_back(Key{ SpecialKeys::PASTE, ControlKeys::NONE });
+		input_pasted_text.push_back(move(input_paste));
+		input_paste.clear();
 	}
 #endif
 	;
 
-	static vector<string> wrapTextInner(string text, size_t max_width)
+	/**
+	 * @brief turns raw terminal input into key events, starting from `start`.
+	 * 
+	 * stops at anything which has been cut off part-way through (an escape sequence or a
+	 * UTF-8 character), so it can be finished once the rest has been read. if `settle` is set,
+	 * no more input is expected for now, so an escape on its own (or with only an 'O' after it)
+	 * is taken to be a key press instead.
+	 * 
+	 * @param data raw bytes read from the terminal
+	 * @param start position in `data` to start from
+	 * @param settle whether to resolve an escape which might be the start of a sequence
+	 * @param events list to add the resulting key events to
+	 * @returns position in `data` up to which everything has been handled
+	 **/
+	static size_t parseInput(const string& data, size_t start, bool settle, vector<Key>& events)
 #ifdef STUI_IMPLEMENTATION
 	{
-		vector<string> lines;
-		size_t last_index = 0;
-		while (last_index != text.length())
+		static const string paste_end = "\033[201~";
+		size_t i = start;
+		size_t n = data.length();
+		while (i < n)
 		{
-			size_t max_end = min(last_index + max_width - 1, text.length() - 1);
-			size_t next_end = max_end;
-			bool trim_whitespace = false;
-			while (text[next_end] != ' ')
+			if (input_in_paste)
 			{
-				if (next_end == text.length() - 1)
+				size_t end = data.find(paste_end, i);
+				if (end == string::npos)
 				{
-					trim_whitespace = false;
-					break;
+					// keep back anything which could be the start of the end marker
+					size_t safe = n;
+					size_t last_escape = data.rfind('\033');
+					if (last_escape != string::npos && last_escape >= i && n - last_escape < paste_end.length()
+						&& paste_end.compare(0, n - last_escape, data, last_escape, n - last_escape) == 0)
+						safe = last_escape;
+					input_paste.append(data, i, safe - i);
+					if (safe > i) input_paste_updated = clock_type::now();
+					if (input_paste.length() < input_paste_limit) return safe;
+					// too long to still be a real paste, so it's handed over and the rest is read normally
+					finishPaste(events);
+					i = safe;
+					continue;
 				}
+				input_paste.append(data, i, end - i);
+				finishPaste(events);
+				i = end + paste_end.length();
+				continue;
+			}
 
-				if (next_end == last_index)
+			uint8_t c = static_cast<uint8_t>(data[i]);
+			if (c == '\e')
+			{
+				if (i + 1 >= n)
 				{
-					next_end = max_end;
-					trim_whitespace = false;
-					break;
+					// could be the escape key, or the start of a sequence which hasn't finished arriving
+					if (!settle) return i;
+					events.push_back(Key{ '\e', ControlKeys::NONE });
+					i++;
+					continue;
 				}
-				next_end--;
+
+				uint8_t introducer = static_cast<uint8_t>(data[i + 1]);
+				if (introducer != '[' && introducer != 'O')
+				{
+					// if there's no bracket then it's an alt-event
+					if (introducer < 128) events.push_back(Key{ linux_keymap[introducer].key, ControlKeys::ALT });
+					i += (introducer < 128) ? 2 : 1;
+					continue;
+				}
+
+				// find the end of the sequence: parameter and intermediate bytes, then a final byte
+				size_t final_index = i + 2;
+				if (introducer == '[')
+					while (final_index < n && data[final_index] >= 0x20 && data[final_index] <= 0x3F) final_index++;
+				if (final_index >= n)
+				{
+					// it could just be alt-O, not an escape sequence. anything longer is assumed to
+					// be a sequence which hasn't finished arriving
+					if (settle && introducer == 'O')
+					{
+						events.push_back(Key{ linux_keymap[introducer].key, ControlKeys::ALT });
+						i += 2;
+						continue;
+					}
+					return i;
+				}
+
+				string_view parameters = string_view(data).substr(i + 2, final_index - (i + 2));
+				handleSequence(introducer, parameters, static_cast<uint8_t>(data[final_index]), events);
+				i = final_index + 1;
+			}
+			else if (c < 128)
+			{
+				// normal keypress, use the keymap as a look-up table
+				events.push_back(linux_keymap[c]);
+				i++;
+			}
+			else
+			{
+				// a run of UTF-8 text, which is passed on in one go (minus any character which
+				// hasn't finished arriving)
+				size_t end = i;
+				while (end < n && static_cast<uint8_t>(data[end]) >= 128) end++;
+				if (end == n)
+				{
+					size_t lead = end;
+					while (lead > i && (static_cast<uint8_t>(data[lead - 1]) & 0xC0) == 0x80 && end - lead < 3) lead--;
+					if (lead > i)
+					{
+						uint8_t lead_byte = static_cast<uint8_t>(data[lead - 1]);
+						size_t length = (lead_byte < 0xE0) ? 2 : (lead_byte < 0xF0) ? 3 : 4;
+						if (lead_byte >= 0xC0 && end - (lead - 1) < length) end = lead - 1;
+					}
+					if (end == i) return i;
+				}
+				events.push_back(Key{ SpecialKeys::PASTE, ControlKeys::NONE });
+				input_pasted_text.push_back(data.substr(i, end - i));
+				i = end;
 			}
-			lines.push_back(text.substr(last_index, ((next_end - last_index) + 1) - trim_whitespace));
-			last_index = next_end + 1;
 		}
-		return lines;
+		return n;
 	}
 #endif
 	;
 
 	/**
-	 * @brief draws a line of text into a buffer.
+	 * @brief turns a complete escape sequence into key events, or ignores it if it isn't one
+	 * we know about.
 	 * 
-	 * supports single-line drawing (out-of-bounds characters are skipped). it's up to the 
-	 * caller to ensure `buffer` is allocated to the size specified by `buffer_size`. 
-	 * newlines, nulls or other special characters should not be passed into this function, 
-	 * as it will fuck up the output stage at the end of rendering.
-	 * 
-	 * @param text text to draw to the buffer
-	 * @param text_origin position in the output buffer of the top-left-most corner of the
-	 * text
-	 * @param max_size maximum size of the drawn text, measured from the `text_origin`. must 
-	 * be positive in both dimensions. text that runs outside this area is not drawn
-	 * @param buffer pointer to a `Tixel` array ordered left-to-right, top-to-bottom
-	 * @param buffer_size size of the allocated buffer, must match with the size of the `buffer`
+	 * @param introducer '[' for a CSI sequence, or 'O' for an SS3 sequence
+	 * @param parameters parameter bytes between the introducer and final byte
+	 * @param final_byte the character which ends the sequence
+	 * @param events list to add the resulting key events to
 	 **/
-	static void drawText(string text, Coordinate text_origin, Coordinate max_size, Tixel* buffer, Coordinate buffer_size)
+	static void handleSequence(uint8_t introducer, string_view parameters, uint8_t final_byte, vector<Key>& events)
 #ifdef STUI_IMPLEMENTATION
 	{
-		if (buffer == nullptr) return;
-		if (buffer_size.x <= 0 || buffer_size.y <= 0) return;
-
-		for (int i = 0; i < static_cast<int>(text.length()); i++)
+		// parameters look like "code;modifiers", where the modifiers are 1 + a bitmask of shift, alt and ctrl
+		int code = 0;
+		int modifiers = 0;
+		size_t p = 0;
+		for (; p < parameters.length() && isdigit(static_cast<unsigned char>(parameters[p])); p++) code = (code * 10) + (parameters[p] - '0');
+		if (p < parameters.length() && parameters[p] == ';')
+			for (p++; p < parameters.length() && isdigit(static_cast<unsigned char>(parameters[p])); p++) modifiers = (modifiers * 10) + (parameters[p] - '0');
+		uint16_t control_states = ControlKeys::NONE;
+		if (modifiers > 1)
 		{
-			if (text_origin.x + i < 0) continue;
-			if (text_origin.x + i >= buffer_size.x || i >= max_size.x) break;
-			if (text_origin.y < 0 || text_origin.y >= buffer_size.y) break;
-			if (text[i] == '\n') break;
-
-			buffer[(text_origin.x + i) + (text_origin.y * buffer_size.x)] = text[i];
+			if ((modifiers - 1) & 0b001) control_states |= ControlKeys::SHIFT;
+			if ((modifiers - 1) & 0b010) control_states |= ControlKeys::ALT;
+			if ((modifiers - 1) & 0b100) control_states |= ControlKeys::CTRL;
 		}
-	}
-#endif
-	;
-
-	/**
-	 * @brief draws a block of text into a buffer.
-	 * 
-	 * supports either multi-line wrapped drawing, where lines are wrapped to fit into the
-	 * box specified by `max_size`. it's up to the caller to ensure `buffer` is allocated 
-	 * to the size specified by `buffer_size`. newlines, nulls or other special characters 
-	 * should not be passed into this function, as it will fuck up the output stage at the
-	 * end of rendering.
-	 * 
-	 * @param text text to draw to the buffer
-	 * @param text_origin position in the output buffer of the top-left-most corner of the
-	 * text
-	 * @param max_size maximum size of the drawn text, measured from the `text_origin`. must 
-	 * be positive in both dimensions. text that runs outside this area will be wrapped to 
-	 * fit inside this horizontally
-	 * @param buffer pointer to a `Tixel` array ordered left-to-right, top-to-bottom
-	 * @param buffer_size size of the allocated buffer, must match with the size of the `buffer`
-	 **/
-	static vector<size_t> drawTextWrapped(string text, Coordinate text_origin, Coordinate max_size, Tixel* buffer, Coordinate buffer_size)
-#ifdef STUI_IMPLEMENTATION
-	{
-		if (buffer == nullptr) return vector<size_t>();
-		if (buffer_size.x <= 0 || buffer_size.y <= 0) return vector<size_t>();
 
-		vector<string> lines = wrapText(text, min(max_size.x, buffer_size.x - text_origin.x));
-		
-		int row = -1;
-		for (string line : lines)
+		switch (final_byte)
 		{
-			row++;
-			if (row >= max_size.y || row + text_origin.y >= buffer_size.y) break;
-			if (row + text_origin.y < 0) continue;
-
-			for (size_t col = 0; col < line.length(); col++)
+		case 'A': events.push_back(Key{ ArrowKeys::UP, static_cast<ControlKeys>(control_states) }); return;
+		case 'B': events.push_back(Key{ ArrowKeys::DOWN, static_cast<ControlKeys>(control_states) }); return;
+		case 'C': events.push_back(Key{ ArrowKeys::RIGHT, static_cast<ControlKeys>(control_states) }); return;
+		case 'D': events.push_back(Key{ ArrowKeys::LEFT, static_cast<ControlKeys>(control_states) }); return;
+		case '~':
+			if (introducer != '[') break;
+			if (code == 3) { events.push_back(Key{ 127, ControlKeys::NONE }); return; }
+			if (code == 200)
 			{
-				buffer[(text_origin.x + col) + ((text_origin.y + row) * buffer_size.x)] = line[col];
+				input_in_paste = true;
+				input_paste.clear();
+				input_paste_updated = clock_type::now();
+				return;
 			}
+			if (code == 201) return;
+			break;
 		}
-
-		vector<size_t> line_lengths;
-		for (string l : lines) line_lengths.push_back(l.length());
-
-		return line_lengths;
+		// debug if it isnt handled
+		DEBUG_LOG("unhandled ANSI code: " + string(1, (char)introducer) + string(parameters) + string(1, (char)final_byte));
 	}
 #endif
 	;
+#endif
+};
+
+/**
+ * @brief maps key-binds to the functions which should be called when they're pressed.
+ * 
+ * each binding is stored under a hash of its key and control keys, so looking up a key event
+ * takes the same time no matter how many bindings there are. `Renderer::handleInput` checks
+ * keymaps in layers: the focused `Component`'s `keymap` first, then the one it was given
+ * (usually the `Page`'s), and finally the global one from `Renderer::getGlobalKeymap`. the first
+ * layer with a binding for a key consumes it.
+ **/
+class Keymap
+{
+private:
+	unordered_map<uint32_t, function<void()>> bindings;
+
+public:
+	Keymap() { }
+	Keymap(initializer_list<Input::Shortcut> shortcuts) { for (const Input::Shortcut& s : shortcuts) bind(s.binding, s.callback); }
 
 	/**
-	 * @brief simplifies allocation of 2D text buffers.
+	 * @brief calculates the value which a key event is stored under.
 	 * 
-	 * automatically clears the buffer with spaces and adds an extra null-terminator on the end. this
-	 * function allocates memory with `new`, and callers are responsible for `delete[]`ing the buffers
-	 * after it is no longer being used.
-	 * 
-	 * @param buffer_size two-dimensional size of the buffer required. must be positive and non-zero in
-	 * both axes
+	 * letters are matched case-insensitively when any control keys are held (in the same way as
+	 * `Input::compare`), so they're folded to upper case first.
 	 * 
-	 * @returns pointer to newly-allocated block of memory, or `nullptr` if the buffer size would be
-	 * less than 1
+	 * @param key key event to hash
+	 * @returns hash of the key event, which is unique to each distinct key-bind
 	 **/
-	static Tixel* makeBuffer(Coordinate buffer_size)
-#ifdef STUI_IMPLEMENTATION
+	static inline uint32_t hash(Input::Key key)
 	{
-		if (buffer_size.x <= 0 || buffer_size.y <= 0) return nullptr;
-
-		size_t size = buffer_size.x * buffer_size.y;
-		Tixel* buf = new Tixel[size + 1];
-		Tixel fill{ ' ', getDefaultColour() };
-		for (size_t i = 0; i < size; i++)
-			memcpy(buf + i, &fill, sizeof(fill));
-		buf[size] = Tixel{ '\0', getDefaultColour() };
-
-		return buf;
+		uint16_t k = key.key;
+		if (key.control_states != Input::ControlKeys::NONE && k < 128) k = static_cast<uint16_t>(toupper(k));
+		return (static_cast<uint32_t>(key.control_states) << 16) | k;
 	}
-#endif
-	;
 
 	/**
-	 * @brief copy an area from one buffer to another.
-	 * 
-	 * useful for transferring an area into a larger, differently-shaped buffer for combining elements.
-	 * it's up to the caller to ensure `src` is allocated to the size specified by `src_size`, and to
-	 * ensure 'dst' is allocated to the size specified by `dst_size`. also, this function does not
-	 * clamp the bounds of the box, so trying to copy a box which overflows outside `src` or `dst`, or
-	 * both at once, is likely to corrupt the heap or cause an exception.
+	 * @brief binds a function to a key, replacing anything which was already bound to it.
 	 * 
-	 * @param src source buffer to copy characters from. must be appropriately sized and allocated, see
-	 * above
-	 * @param src_size size of the source buffer, must match with the allocated size of `src`
-	 * @param src_offset position of the top-left corner of the box to copy in the source buffer. must
-	 * be positive in both dimensions
-	 * @param area_size size of the area to be copied between buffers. must fit inside both buffers
-	 * @param dst destination buffer to copy characters into. must be appropriately sized and allocated,
-	 * see above
-	 * @param dst_size size of the destination buffer, must match with the allocated size of `dst`
-	 * @param dst_offset position of the top-left corner of the box to copy to in the destination buffer.
-	 * must be positive in both dimensions
+	 * @param key key-bind which should trigger the function
+	 * @param callback function to call
 	 **/
-	static void copyBox(const Tixel* src, Coordinate src_size, Coordinate src_offset, Coordinate area_size, Tixel* dst, Coordinate dst_size, Coordinate dst_offset)
-#ifdef STUI_IMPLEMENTATION
-	{
-		if (src == nullptr || dst == nullptr) return;
-		if (area_size.x <= 0 || area_size.y <= 0) return;
-		if (src_offset.x < 0 || src_offset.y < 0) return;
-		if (dst_offset.x < 0 || dst_offset.y < 0) return;
-		if (src_offset.x + area_size.x > src_size.x || src_offset.y + area_size.y > src_size.y) return;
-		if (dst_offset.x + area_size.x > dst_size.x || dst_offset.y + area_size.y > dst_size.y) return;
-
-		for (int y = 0; y < area_size.y; y++)
-		{
-			memcpy(dst + dst_offset.x + ((y + dst_offset.y) * dst_size.x), src + src_offset.x + ((y + src_offset.y) * src_size.x), area_size.x * sizeof(Tixel));
-		}
-	}
-#endif
-	;
+	inline void bind(Input::Key key, function<void()> callback) { bindings.insert_or_assign(hash(key), move(callback)); }
 
 	/**
-	 * @brief get the current default colour configuration for the interface.
+	 * @brief removes the binding for a key, if there is one.
 	 * 
-	 * @returns the current colour configuration
+	 * @param key key-bind to remove
+	 * @returns true if something was bound to the key
 	 **/
-	static inline Tixel::ColourCommand getDefaultColour()
-	{
-		return (Tixel::ColourCommand)(Tixel::ColourCommand::BG_BLACK | Tixel::ColourCommand::FG_WHITE);
-	}
+	inline bool unbind(Input::Key key) { return bindings.erase(hash(key)) != 0; }
 
 	/**
-	 * @brief get the current highlighted colour configuration for the interface.
+	 * @brief checks whether anything is bound to a key.
 	 * 
-	 * @returns the current highlighted colour configuration
+	 * @param key key-bind to check for
+	 * @returns true if the key is bound
 	 **/
-	static inline Tixel::ColourCommand getHighlightedColour()
-	{
-		return (Tixel::ColourCommand)(Tixel::ColourCommand::FG_BLACK | Tixel::ColourCommand::BG_WHITE);
-	}
+	inline bool isBound(Input::Key key) const { return bindings.count(hash(key)) != 0; }
 
 	/**
-	 * @brief get the current unfocused colour configuration for the interface.
+	 * @brief calls the function bound to a key, if there is one.
 	 * 
-	 * @returns the current unfocused colour configuration
+	 * @param key key event which was received
+	 * @returns true if the key was bound (and so should be consumed)
 	 **/
-	static inline Tixel::ColourCommand getUnfocusedColour()
+	inline bool trigger(Input::Key key) const
 	{
-		return (Tixel::ColourCommand)(Tixel::ColourCommand::FG_BLACK | Tixel::ColourCommand::BG_GRAY);
+		auto it = bindings.find(hash(key));
+		if (it == bindings.end()) return false;
+		if (it->second) it->second();
+		return true;
 	}
 
 	/**
-	 * @brief fill a specified box area with a particular colour command.
-	 * 
-	 * @param colour colour command to fill the area with
-	 * @param origin starting offset of the area
-	 * @param size size of the area. must be positive in both axes
-	 * @param buffer output buffer into which the filled box should be drawn
-	 * @param buffer_size size of the output buffer
+	 * @brief removes all bindings.
 	 **/
-	static void fillColour(Tixel::ColourCommand colour, Coordinate origin, Coordinate size, Tixel* buffer, Coordinate buffer_size)
-#ifdef STUI_IMPLEMENTATION
-	{
-		if (size.x <= 0 || size.y <= 0) return;
-		if (buffer == nullptr) return;
-		if (buffer_size.x <= 0 || buffer_size.y <= 0) return;
-
-		for (int y = 0; y < size.y; y++)
-		{
-			if (y + origin.y < 0) continue;
-			if (y + origin.y >= buffer_size.y) break;
+	inline void clear() { bindings.clear(); }
 
-			for (int x = 0; x < size.x; x++)
-			{
-				if (x + origin.x < 0) continue;
-				if (x + origin.x >= buffer_size.x) break;
-				buffer[x + origin.x + ((y + origin.y) * buffer_size.x)].colour = colour;
-			}
-		}
-	}
-#endif
-	;
+	/**
+	 * @returns number of keys which are bound
+	 **/
+	inline size_t size() const { return bindings.size(); }
 };
 
+class Component;
+
 /**
- * @brief single-line text box.
- * 
- * text `alignment` can be specified as < 0 for left-aligned, = 0 for center-aligned, or
- * > 0 for right-aligned
+ * @brief receives notifications when children are added to or removed from a `Component`, or
+ * when a `Component` is destroyed. `Page` uses this to keep its registry up to date without
+ * searching the whole tree.
  **/
-class Label : public Component, public Utility
+class ChildListener
 {
 public:
-	string text;
-	int alignment;
-	
-	Label(string _text, int _alignment) : text(_text), alignment(_alignment) { }
-
-	GETTYPENAME_STUB("Label");
-
-	RENDER_STUB
-#ifdef STUI_IMPLEMENTATION
-	{
-		if (size.y < 1) return;
+	/**
+	 * @brief called after a child has been added to a container.
+	 * 
+	 * @param container `Component` which the child was added to
+	 * @param child the new child
+	 **/
+	virtual void childAttached(Component* container, Component* child) = 0;
 
-		Coordinate offset{ 0,0 };
-		if (alignment < 0)
-			offset.x = 0;
-		else if (alignment == 0)
-			offset.x = static_cast<int>((size.x - text.length()) / 2);
-		else if (alignment > 0)
-			offset.x = static_cast<int>(size.x - text.length());
+	/**
+	 * @brief called after a child has been removed from a container.
+	 * 
+	 * @param container `Component` which the child was removed from
+	 * @param child the old child
+	 **/
+	virtual void childDetached(Component* container, Component* child) = 0;
 
-		drawText(stripNullsAndMore(text, "\n\t"), offset, Coordinate{ static_cast<int>(text.length()), 1 }, output_buffer, size);
-	}
-#endif
-	;
+	/**
+	 * @brief called when a `Component` which this is listening to is destroyed. it has already
+	 * stopped being listened to, so there's no need to call `removeListener`.
+	 * 
+	 * @param component `Component` being destroyed
+	 **/
+	virtual void componentDestroyed(Component* component) = 0;
 
-	GETMAXSIZE_STUB { return Coordinate{ -1, 1 }; }
-	GETMINSIZE_STUB { return Coordinate{ static_cast<int>(text.length()), 1 }; }
+	virtual ~ChildListener() { }
 };
 
 /**
- * @brief simple clickable button.
+ * @brief purely static class which measures how long each frame takes, and where the time
+ * goes, while the program is running.
+ * 
+ * this is always compiled in, but does nothing until it's turned on with `enable`, so it can
+ * be left in a finished program and switched on when something is slow. when it's on, each
+ * call to `Renderer::render` records a `FrameProfile`, how long each `Component` which was
+ * laid out or drawn took (not including its children), and which bucket of the frame time
+ * histogram the frame fell into.
  **/
-class Button : public Component, public Utility
+class Profiler
 {
-public:
-	string text;
-	void (*callback)();
-	bool enabled;
-
-	Button(string _text, void (*_callback)(), bool _enabled) : text(_text), callback(_callback), enabled(_enabled) { }
+	friend class Renderer;
+	friend class Component;
 
-	GETTYPENAME_STUB("Button");
+public:
+	/**
+	 * @brief describes a single call to `Renderer::render`.
+	 **/
+	struct FrameProfile
+	{
+		size_t frame;					// number of the frame, which goes up by one every frame
+		float total_seconds;			// time spent in `Renderer::render`
+		float layout_seconds;			// time spent laying out the tree
+		float draw_seconds;				// time spent drawing components
+		float output_seconds;			// time spent finding changed cells, building escape codes, and writing to the terminal
+		size_t components_laid_out;		// number of components whose `layout` was called
+		size_t components_drawn;		// number of components which were drawn, rather than left in place from the last frame
+		size_t bytes_emitted;			// see `Renderer::RenderStats`
+		size_t cells_changed;			// see `Renderer::RenderStats`
+		size_t allocations;				// see `Renderer::RenderStats`
+		bool full_repaint;				// see `Renderer::RenderStats`
+	};
 
-	RENDER_STUB
-#ifdef STUI_IMPLEMENTATION
+	/**
+	 * @brief describes the time one `Component` took during a frame, not including the time
+	 * taken by its children.
+	 **/
+	struct ComponentTiming
 	{
-		if (size.y < 1) return;
+		Component* component;
+		float layout_seconds;			// time spent in `layout`
+		float render_seconds;			// time spent in `render`
+		size_t renders;					// number of times it was drawn (more than one if it appears in more than one place)
+	};
 
-		int offset = (size.x - static_cast<int>(text.length()) - 4) / 2;
-		drawText("> " + text + " <", Coordinate{ offset,0 }, Coordinate{ static_cast<int>(text.length()) + 4,1 }, output_buffer, size);
-		if (focused)
-			fillColour(enabled ? getHighlightedColour() : getUnfocusedColour(), Coordinate{ offset,0 }, Coordinate{ static_cast<int>(text.length()) + 4,1 }, output_buffer, size);
-	}
-#endif
-	;
+	/**
+	 * @brief counts how many frames took how long. bucket `i` holds frames which took less
+	 * than `getUpperLimit(i)` seconds (and at least the limit of the bucket before it); the
+	 * last bucket holds everything slower than that.
+	 **/
+	struct FrameHistogram
+	{
+		static constexpr int BUCKETS = 10;
+		size_t counts[BUCKETS];
 
-	GETMAXSIZE_STUB { return Coordinate{ -1,1 }; }
-	GETMINSIZE_STUB { return Coordinate{ static_cast<int>(text.length()) + 4,1 }; }
+		static inline float getUpperLimit(int bucket) { return (bucket >= BUCKETS - 1) ? INFINITY : 0.00025f * static_cast<float>(1 << bucket); }
+	};
 
-	HANDLEINPUT_STUB
-#ifdef STUI_IMPLEMENTATION
-	{
-		if ((input_character == '\n' || input_character == ' ') && callback != nullptr && focused && enabled) { callback(); return true; }
-		return false;
-	}
-#endif
-	;
+	/**
+	 * @brief turns profiling on or off. it is off by default.
+	 * 
+	 * @param enabled whether frames should be measured
+	 **/
+	static void enable(bool enabled);
 
-	ISFOCUSABLE_STUB { return enabled; }
-};
+	/**
+	 * @returns whether profiling is turned on
+	 **/
+	static bool isEnabled();
 
-/**
- * @brief list of options from which the user can select one by navigating up/down and
- * pressing enter/space.
- **/
-class RadioButton : public Component, public Utility
-{
-	int highlighted_index = 0;
+	/**
+	 * @brief get the measurements from the most recent frame which was drawn with profiling on.
+	 * 
+	 * @returns profile of the last frame
+	 **/
+	static const FrameProfile& getLastFrame();
+
+	/**
+	 * @brief get the time taken by each `Component` which was laid out or drawn during the most
+	 * recent profiled frame, in the order they were first visited. only valid until the next frame.
+	 * 
+	 * @returns list of timings
+	 **/
+	static const vector<ComponentTiming>& getComponentTimings();
+
+	/**
+	 * @brief get the frame time histogram, which covers every profiled frame since profiling was
+	 * turned on (or `resetHistogram` was called).
+	 * 
+	 * @returns histogram of frame times
+	 **/
+	static const FrameHistogram& getHistogram();
+
+	/**
+	 * @brief empties the frame time histogram.
+	 **/
+	static void resetHistogram();
+
+	/**
+	 * @brief adds a function to be called at the end of every profiled frame, for sending the
+	 * measurements somewhere else (like your own metrics). `getComponentTimings` can be used from
+	 * inside the callback. callbacks must not draw anything.
+	 * 
+	 * @param callback function to call with the profile of each frame
+	 * 
+	 * @returns identifier to pass to `removeFrameCallback`
+	 **/
+	static size_t addFrameCallback(function<void(const FrameProfile&)> callback);
+
+	/**
+	 * @brief stops calling a function added with `addFrameCallback`.
+	 * 
+	 * @param identifier value returned by `addFrameCallback`
+	 **/
+	static void removeFrameCallback(size_t identifier);
+
+private:
+	static ComponentTiming& getTiming(Component* component);
+	static void finishFrame(FrameProfile frame);
+};
+
+/**
+ * @brief base class from which all UI components inherit.
+ * 
+ * all `Component` subclasses must override the `render`, `getMaxSize`, and 
+ * `getMinSize` methods (ideally using the relevant macros).
+ **/
+#pragma pack(push)
+#pragma pack(8)
+class Component
+{
+	friend class Renderer;
+	friend class Profiler;
+	friend struct RenderThreadPool;
+	friend class Animator;
+
+public:
+	bool focused = false;
+	Keymap* keymap = nullptr;	// shortcuts which only apply while this `Component` is focused, checked before any others
+
+	/**
+	 * @brief draws the `Component` into a `Tixel` buffer, with a specified size.
+	 * 
+	 * implementations should assume that the `output_buffer` has been allocated to be the correct
+	 * `size`, but should also check that any drawing is performed within the limits of the `size`
+	 * (otherwise you'll corrupt the heap, yippee!).
+	 * 
+	 * @param output_buffer buffer allocated by the caller to be drawn into. ordered left
+	 * to right, top to bottom
+	 * @param size size of the buffer
+	 **/
+	virtual inline void render(Tixel* output_buffer, Coordinate size) { }
+
+	/**
+	 * @brief draws the `Component` into a view onto a region of a larger buffer.
+	 * 
+	 * this is what containers call to draw their children, and the view will already have been
+	 * cleared. the default implementation hands the view straight to the plain `Tixel*` version
+	 * of `render` when its rows are contiguous, or otherwise draws into a scratch buffer and
+	 * copies the result into the view, so `Component`s which only override the plain version
+	 * still work. containers should override this instead, and pass sub-views of `target` to
+	 * their children, so that children draw straight into their final position.
+	 * 
+	 * @param target view to draw into. its size is the size the `Component` has been given
+	 **/
+	virtual void render(BufferView target);
+
+	/**
+	 * @brief flags this `Component` as having changed, so that it will be redrawn in the next frame.
+	 * 
+	 * this only matters if caching has been turned on with `Renderer::enableCaching`, in which case
+	 * you must call this whenever you change one of the `Component`'s properties yourself (input which
+	 * is consumed by `handleInput`, and focus changes made by `Page`, do this automatically). the
+	 * change is propagated up to the `Component`'s ancestors, so that they know to look inside it.
+	 * 
+	 * @param affects_layout whether the change could affect the size of this `Component` (or of
+	 * anything in its ancestors' layouts). pass false if only what it draws has changed, such as a
+	 * `Spinner` moving on, and the layout of the tree is kept
+	 **/
+	void markDirty(bool affects_layout = true);
+
+	/**
+	 * @brief checks whether this `Component` has changed since it was last drawn.
+	 * 
+	 * @returns true if the `Component` needs redrawing
+	 **/
+	inline bool isDirty() const { return dirty; }
+
+	/**
+	 * @brief get the minimum size of this `Component`, as calculated during the current layout pass.
+	 * 
+	 * the result of `getMinSize` is remembered until the next frame (or with caching enabled, until
+	 * this `Component` or something inside it is marked dirty), so containers should call this rather
+	 * than calling `getMinSize` on their children directly.
+	 * 
+	 * @returns the minimum size of the `Component`
+	 **/
+	Coordinate getLayoutMinSize();
+
+	/**
+	 * @brief get the maximum size of this `Component`, as calculated during the current layout pass.
+	 * see `getLayoutMinSize`.
+	 * 
+	 * @returns the maximum size of the `Component`
+	 **/
+	Coordinate getLayoutMaxSize();
+
+	/**
+	 * @brief get the size this `Component` was given during the most recent layout pass.
+	 * 
+	 * @returns the size of the area allocated to the `Component`
+	 **/
+	inline Coordinate getLayoutSize() const { return layout_size; }
+
+	/**
+	 * @brief get the position this `Component` was placed at during the most recent layout pass,
+	 * relative to the top-left corner of the container which placed it.
+	 * 
+	 * @returns offset of the `Component` within its parent
+	 **/
+	inline Coordinate getLayoutOffset() const { return layout_offset; }
+
+	/**
+	 * @brief find the innermost `Component` which was laid out over a particular position.
+	 * 
+	 * @param position position relative to the top-left corner of this `Component`
+	 * @returns the deepest `Component` covering the position, this `Component` if none of its
+	 * children do, or null if the position is outside this `Component` altogether
+	 **/
+	Component* findComponentAt(Coordinate position);
+	
+	/**
+	 * @brief returns the maximum desired size that this component should be given.
+	 * 
+	 * note that the component may still be givena buffer larger than this size, so this should 
+	 * be handled if appropriate in `render`. either or both of these values can be given the 
+	 * value `-1` to indicate no maximum size in that dimension.
+	 * 
+	 * @returns a `Coordinate` representing the maximum size for the `Component`
+	 **/
+	virtual inline Coordinate getMaxSize() { return { 0, 0 }; }
+
+	/**
+	 * @brief returns the minimum size that this component should be given to draw into.
+	 *
+	 * functions which call `render` will try to ensure all components have at least
+	 * their minimum size requirements met, otherwise if not enough space cannot be allocated,
+	 * the `Component` will not be rendered. this function should never return negative values
+	 * for either dimension.
+	 *
+	 * @returns a `Coordinate` representing the minimum size for the `Component`
+	 **/
+	virtual inline Coordinate getMinSize() { return { 0, 0 }; }
+
+	/**
+	 * @brief handle a single key-press event.
+	 * 
+	 * not all subclasses need to implement this, but if you want to handle input you probably
+	 * should.
+	 * 
+	 * @param input_character the character to handle
+	 * @returns true if the input was consumed or false if not
+	 **/
+	virtual inline bool handleInput(uint8_t input_character, Input::ControlKeys modifiers) { return false; }
+
+	/**
+	 * @brief handle a block of text arriving all at once, such as something being pasted in.
+	 * 
+	 * by default this is passed on to `handleInput` one character at a time, but components
+	 * which edit text should override this to insert it in one go.
+	 * 
+	 * @param text the text to handle
+	 * @returns true if the input was consumed or false if not
+	 **/
+	virtual inline bool handleTextInput(string_view text)
+	{
+		bool consumed = false;
+		for (char c : text) consumed |= handleInput(static_cast<uint8_t>(c), Input::ControlKeys::NONE);
+		return consumed;
+	}
+
+	/**
+	 * @brief returns whether or not the component can be focused for input.
+	 * 
+	 * should be overriden by subclasses which want to receive input.
+	 * 
+	 * @returns true if the component is focusable
+	 **/
+	virtual inline bool isFocusable() { return false; }
+
+	/**
+	 * @brief get the string description of this component type. should be
+	 * overridden by subclasses and return a string that matches the class name.
+	 * 
+	 * @returns string name of the class/component type
+	 */
+	virtual inline string getTypeName() { return ""; }
+
+	/**
+	 * @brief return a list of any children this component has. subclasses
+	 * which allow child components should return them here.
+	 * 
+	 * this allocates a new list every time, so prefer `getChildren` for looking
+	 * through them.
+	 * 
+	 * @returns list of contained children
+	 */
+	virtual inline vector<Component*> getAllChildren() { return { }; }
+
+	/**
+	 * @brief get the number of children this component has. subclasses which
+	 * allow child components should override this and `getChild`.
+	 * 
+	 * the default implementation uses `getAllChildren`, so older components which
+	 * only override that still work.
+	 * 
+	 * @returns number of children
+	 */
+	virtual inline size_t getChildCount() { return getAllChildren().size(); }
+
+	/**
+	 * @brief get one of this component's children.
+	 * 
+	 * @param index index of the child, less than `getChildCount`
+	 * 
+	 * @returns the child, which may be null
+	 */
+	virtual inline Component* getChild(size_t index)
+	{
+		vector<Component*> all = getAllChildren();
+		return (index < all.size()) ? all[index] : nullptr;
+	}
+
+	/**
+	 * @brief lets you go through the children of a `Component` with a range-based for
+	 * loop, without allocating anything. see `getChildren`.
+	 **/
+	struct ChildRange
+	{
+		struct Iterator
+		{
+			Component* component;
+			size_t index;
+
+			inline Component* operator*() const { return component->getChild(index); }
+			inline Iterator& operator++() { index++; return *this; }
+			inline bool operator!=(const Iterator& other) const { return index != other.index; }
+		};
+
+		Component* component;
+		size_t count;
+
+		inline Iterator begin() const { return Iterator{ component, 0 }; }
+		inline Iterator end() const { return Iterator{ component, count }; }
+	};
+
+	/**
+	 * @brief get the children of this `Component`, for use in a range-based for loop
+	 * (children may be null):
+	 * ```
+	 * for (Component* child : container->getChildren()) { ... }
+	 * ```
+	 * 
+	 * @returns range covering the children
+	 */
+	inline ChildRange getChildren() { return ChildRange{ this, getChildCount() }; }
+
+	/**
+	 * @brief start telling something about changes to this `Component`'s children. does
+	 * nothing if it's already listening.
+	 * 
+	 * @param listener object to notify
+	 **/
+	inline void addListener(ChildListener* listener)
+	{
+		if (find(listeners.begin(), listeners.end(), listener) == listeners.end()) listeners.push_back(listener);
+	}
+
+	/**
+	 * @brief stop telling something about changes to this `Component`'s children.
+	 * 
+	 * @param listener object to stop notifying
+	 **/
+	inline void removeListener(ChildListener* listener)
+	{
+		auto it = find(listeners.begin(), listeners.end(), listener);
+		if (it != listeners.end()) listeners.erase(it);
+	}
+
+	Component() { }
+
+	/**
+	 * @brief copies the settings of another `Component`. the copy starts out as if it had never
+	 * been drawn: it hasn't been placed anywhere, nothing is listening to it, and it has no timers.
+	 * 
+	 * @param other `Component` to copy
+	 **/
+	Component(const Component& other) : focused(other.focused), keymap(other.keymap) { }
+
+	/**
+	 * @brief copies the settings of another `Component` into this one (see the copy constructor).
+	 * this `Component` keeps its own place in the tree, listeners and timers, and is marked dirty.
+	 * 
+	 * @param other `Component` to copy
+	 * 
+	 * @returns this `Component`
+	 **/
+	inline Component& operator=(const Component& other)
+	{
+		focused = other.focused;
+		keymap = other.keymap;
+		markDirty();
+		return *this;
+	}
+
+	virtual ~Component()
+	{
+		if (animation_count > 0) stopAnimations();
+		vector<ChildListener*> to_notify = move(listeners);
+		listeners.clear();
+		for (ChildListener* l : to_notify) l->componentDestroyed(this);
+	}
+
+protected:
+	/**
+	 * @brief draws a child `Component` into a view of this `Component`'s own target. containers
+	 * should use this rather than calling the child's `render` directly.
+	 * 
+	 * if caching is enabled and the child (and everything inside it) hasn't changed since it was
+	 * last drawn in exactly the same place, its output from the previous frame is still on the
+	 * surface, so it isn't drawn again.
+	 * 
+	 * @param child child to draw. may be null
+	 * @param target view to draw the child into
+	 **/
+	inline void renderChild(Component* child, BufferView target) { drawCached(this, render_pass, child, target); }
+
+	/**
+	 * @brief tells the `Renderer` which line of this `Component`'s content its top row is showing.
+	 * scrollable components should call this from `render`.
+	 * 
+	 * if this is drawn in the same place as last time but scrolled, the `Renderer` can ask the
+	 * terminal to move the rows which are already on screen, and then only send the rows which
+	 * have scrolled into view, rather than the whole area (see `Renderer::enableHardwareScrolling`).
+	 * 
+	 * @param top_line index of the line shown in the top row, in whatever units move by one row at a time
+	 **/
+	inline void reportScroll(long long top_line) { scroll_position = top_line; scroll_reported = true; }
+
+	/**
+	 * @brief draws every child placed during the last layout pass into its place in `target`
+	 * (see `getPlacements`).
+	 * 
+	 * if parallel rendering is on (see `Renderer::enableParallelRendering`), children which took
+	 * long enough to draw last time are drawn on other threads at the same time, which is safe
+	 * because each child only draws into its own part of `target`. either way the result is the same.
+	 * 
+	 * @param target view to draw the children into, which should be the one this `Component` was given
+	 **/
+	void renderChildren(BufferView target);
+
+	/**
+	 * @brief draws a child whose exact type is known at compile time. this behaves just like
+	 * `renderChild`, but calls the child's `render` directly rather than through its vtable, so
+	 * that the compiler can inline it. this is what the static layout templates (see `VBox`) use.
+	 * 
+	 * while profiling or parallel rendering is on, every draw needs measuring, so this is
+	 * the same as `renderChild`.
+	 * 
+	 * @param child child to draw. `T` must be the type the child was created as, not a base class,
+	 * otherwise the wrong `render` will be called
+	 * @param target view to draw the child into
+	 **/
+	template<typename T> inline void renderChildAs(T& child, BufferView target);
+
+	/**
+	 * @brief checks whether draws are being timed, because profiling or parallel rendering is on.
+	 * containers which draw their children with `renderChildAs` should use `renderChildren`
+	 * instead while this is true, so that their children can still be drawn in parallel.
+	 * 
+	 * @returns true if draws are being timed
+	 **/
+	static bool isMeasuringDraws();
+
+	/**
+	 * @brief describes where a child was placed by its container during the layout pass.
+	 **/
+	struct Placement
+	{
+		Component* child;
+		Coordinate offset;	// position of the child relative to the container's top-left corner
+		Coordinate size;	// size allocated to the child
+	};
+
+	/**
+	 * @brief decides where each child of this `Component` should go, given the size it has been
+	 * allocated. containers should override this, and call `placeChild` once for each child they
+	 * intend to draw, in order. `render` can then fetch the results from `getPlacements`.
+	 * 
+	 * this is only called when the size changes or something inside the `Component` changes, not
+	 * every time the `Component` is drawn.
+	 * 
+	 * @param size size allocated to this `Component`
+	 **/
+	virtual void layout(Coordinate size) { }
+
+	/**
+	 * @brief records where a child should be drawn, and lays out the inside of the child too. should
+	 * only be called from within `layout`.
+	 * 
+	 * @param child child to place
+	 * @param offset position of the child relative to this `Component`'s top-left corner
+	 * @param size size allocated to the child
+	 **/
+	void placeChild(Component* child, Coordinate offset, Coordinate size);
+
+	/**
+	 * @brief makes sure this `Component`'s layout is up to date for a particular size, calling
+	 * `layout` if it isn't. containers should call this at the start of `render`.
+	 * 
+	 * @param size size allocated to this `Component`
+	 **/
+	void ensureLayout(Coordinate size);
+
+	/**
+	 * @brief get the list of children placed during the most recent layout pass, in the order they
+	 * were placed.
+	 * 
+	 * @returns list of child placements
+	 **/
+	inline const vector<Placement>& getPlacements() const { return placements; }
+
+	/**
+	 * @brief tells anything listening to this `Component` that a child has been added, and
+	 * marks it as changed. containers should call this whenever they gain a child after
+	 * construction.
+	 * 
+	 * @param child the new child. may be null, in which case nothing is notified
+	 **/
+	void attachChild(Component* child);
+
+	/**
+	 * @brief tells anything listening to this `Component` that a child has been removed, and
+	 * marks it as changed. containers should call this whenever they lose a child.
+	 * 
+	 * @param child the old child. may be null, in which case nothing is notified
+	 **/
+	void detachChild(Component* child);
+
+private:
+	vector<ChildListener*> listeners;	// things which want to know when children are added or removed
+	Component* parent = nullptr;		// container which most recently drew this component
+	bool dirty = true;					// this component has changed since it was last drawn
+	bool child_dirty = true;			// something inside this component has changed since it was last drawn
+	bool shared = false;				// this component is drawn in more than one place
+	bool contains_shared = false;		// something inside this component is drawn in more than one place
+	bool region_trusted = false;		// the surface under this component still holds what it drew last time
+	Component* drawn_by = nullptr;		// container which drew this component last time
+	size_t drawn_pass = 0;				// `render_pass` of `drawn_by` when it last drew this component
+	size_t drawn_frame = 0;				// frame in which this component was last drawn
+	size_t drawn_generation = 0;		// surface generation in which this component was last drawn
+	size_t render_pass = 0;				// number of times this component has drawn itself
+	BufferView drawn_target;			// where this component was last drawn
+
+	Coordinate cached_min_size{ 0,0 };	// result of `getMinSize` as of the last layout pass
+	Coordinate cached_max_size{ 0,0 };	// result of `getMaxSize` as of the last layout pass
+	bool sizes_valid = false;			// nothing has changed since the cached sizes were calculated
+	size_t sizes_frame = 0;				// frame in which the cached sizes were calculated
+	size_t sizes_generation = 0;		// surface generation in which the cached sizes were calculated
+	Coordinate layout_offset{ 0,0 };	// position this component was placed at by its parent
+	Coordinate layout_size{ -1,-1 };	// size this component was last laid out for
+	bool layout_valid = false;			// nothing has changed since the layout was calculated
+	size_t layout_frame = 0;			// frame in which the layout was calculated
+	size_t layout_generation = 0;		// surface generation in which the layout was calculated
+	vector<Placement> placements;		// children placed during the last layout pass
+	size_t profile_frame = 0;			// frame in which this component's entry in the `Profiler`'s timings was made
+	size_t profile_slot = 0;			// index of that entry
+	float draw_seconds = 0.0f;			// time it took to draw this and everything inside it last time, if parallel rendering is on
+	size_t tree_frame = 0;				// frame in which `findSharedComponents` last reached this component
+	uint8_t tree_parents = 0;			// number of places `findSharedComponents` found this component in, up to 2
+	size_t exclusive_frame = 0;			// frame in which `tree_exclusive` was worked out
+	bool tree_exclusive = false;		// this and everything inside it were only found in one place
+	size_t animation_count = 0;			// number of `Animator` timers belonging to this component
+	long long scroll_position = 0;		// last value passed to `reportScroll`
+	bool scroll_reported = false;		// `reportScroll` was called during the current draw
+	long long scrolled_position = 0;	// value passed to `reportScroll` the last time this was drawn
+	BufferView scrolled_target;			// where this was drawn the last time it reported its scroll position
+
+	static void drawCached(Component* parent, size_t parent_pass, Component* child, BufferView target);
+	static bool startDraw(Component* parent, size_t parent_pass, Component* child, BufferView target);
+	static bool clearForPlainRender(BufferView target);
+	static void findSharedComponents(Component* root);
+	static void countParents(Component* component);
+	static bool isExclusive(Component* component);
+	void markContainsShared();
+	void recordScroll(BufferView target);
+	void stopAnimations();
+};
+#pragma pack(pop)
+
+/**
+ * @brief static class which keeps the timers that make `Component`s change on their own,
+ * such as a `Spinner` spinning.
+ * 
+ * each timer belongs to a `Component`, and every time it's due, its function is called and
+ * (if that says something changed) the `Component` is marked dirty, so with caching enabled only
+ * that `Component` is redrawn. `Page::run` wakes up for timers by itself; other loops should call
+ * `update` regularly and redraw if it returns true, sleeping for up to `getTimeUntilNext` seconds
+ * in between (for instance with `Terminal::waitForEvents`).
+ * 
+ * timers which are due close together are run in the same frame, rather than each causing a
+ * redraw of their own. timers are only ever run from `update`, on whichever thread calls it,
+ * and should only be started and stopped from that thread too.
+ **/
+class Animator
+{
+public:
+	/**
+	 * @brief starts a timer for a `Component`. the timer is stopped automatically when the
+	 * `Component` is destroyed.
+	 * 
+	 * @param component `Component` the timer belongs to, which is marked dirty whenever `on_tick` returns true
+	 * @param interval_seconds time between ticks
+	 * @param on_tick function to call on each tick, which returns whether anything changed
+	 * 
+	 * @returns identifier for the timer, to pass to `stop`. never 0
+	 **/
+	static size_t start(Component* component, float interval_seconds, function<bool()> on_tick);
+
+	/**
+	 * @brief stops a timer. does nothing if it has already been stopped.
+	 * 
+	 * @param timer identifier returned by `start`
+	 **/
+	static void stop(size_t timer);
+
+	/**
+	 * @brief stops every timer belonging to a `Component`.
+	 * 
+	 * @param component `Component` whose timers should be stopped
+	 **/
+	static void stopAll(Component* component);
+
+	/**
+	 * @brief runs every timer which is due, or will be within the batching window.
+	 * 
+	 * @returns true if any `Component` was marked dirty, meaning the interface should be redrawn
+	 **/
+	static bool update();
+
+	/**
+	 * @brief get how long it is until the next timer is due.
+	 * 
+	 * @returns time in seconds (0 if one is already due), or -1 if there are no timers
+	 **/
+	static float getTimeUntilNext();
+
+	/**
+	 * @brief sets how close together timers have to be due to be run in the same frame. the
+	 * default is 5 milliseconds.
+	 * 
+	 * @param seconds size of the window
+	 **/
+	static void setBatchWindow(float seconds);
+};
+
+#ifdef STUI_IMPLEMENTATION
+struct AnimationTimer
+{
+	size_t id;
+	Component* component;
+	clock_type::duration interval;
+	clock_type::time_point next_tick;
+	function<bool()> on_tick;
+};
+
+static vector<AnimationTimer> animation_timers;
+static size_t animation_next_id = 1;
+static clock_type::duration animation_batch_window = chrono::milliseconds(5);
+
+size_t Animator::start(Component* component, float interval_seconds, function<bool()> on_tick)
+{
+	auto interval = max(chrono::duration_cast<clock_type::duration>(chrono::duration<float>(interval_seconds)), clock_type::duration(1));
+	animation_timers.push_back(AnimationTimer{ animation_next_id, component, interval, clock_type::now() + interval, move(on_tick) });
+	if (component != nullptr) component->animation_count++;
+	return animation_next_id++;
+}
+
+void Animator::stop(size_t timer)
+{
+	for (size_t i = 0; i < animation_timers.size(); i++)
+	{
+		if (animation_timers[i].id != timer) continue;
+		if (animation_timers[i].component != nullptr) animation_timers[i].component->animation_count--;
+		animation_timers.erase(animation_timers.begin() + i);
+		return;
+	}
+}
+
+void Animator::stopAll(Component* component)
+{
+	if (component == nullptr || component->animation_count == 0) return;
+	animation_timers.erase(remove_if(animation_timers.begin(), animation_timers.end(),
+		[component](const AnimationTimer& t) { return t.component == component; }), animation_timers.end());
+	component->animation_count = 0;
+}
+
+bool Animator::update()
+{
+	auto now = clock_type::now();
+	auto due = now + animation_batch_window;
+	auto find_timer = [](size_t id) -> AnimationTimer*
+	{
+		for (AnimationTimer& t : animation_timers) if (t.id == id) return &t;
+		return nullptr;
+	};
+
+	// ticks may start or stop timers, so the ones which are due are found first, and then
+	// looked up again by id before each one runs
+	static vector<size_t> due_timers;
+	due_timers.clear();
+	for (const AnimationTimer& t : animation_timers)
+		if (t.next_tick <= due) due_timers.push_back(t.id);
+
+	bool changed = false;
+	for (size_t id : due_timers)
+	{
+		AnimationTimer* timer = find_timer(id);
+		if (timer == nullptr) continue;
+		timer->next_tick += timer->interval;
+		// if we've fallen behind, don't try to catch up with a burst of ticks
+		if (timer->next_tick < now) timer->next_tick = now + timer->interval;
+
+		Component* component = timer->component;
+		function<bool()> on_tick = timer->on_tick;
+		if (!on_tick || !on_tick()) continue;
+		changed = true;
+		// the timer is gone if its component was destroyed during the tick
+		if (component != nullptr && find_timer(id) != nullptr) component->markDirty(false);
+	}
+	return changed;
+}
+
+float Animator::getTimeUntilNext()
+{
+	if (animation_timers.empty()) return -1.0f;
+	auto next = animation_timers[0].next_tick;
+	for (const AnimationTimer& t : animation_timers) next = min(next, t.next_tick);
+	return max(0.0f, chrono::duration<float>(next - clock_type::now()).count());
+}
+
+void Animator::setBatchWindow(float seconds)
+{
+	animation_batch_window = chrono::duration_cast<clock_type::duration>(chrono::duration<float>(max(0.0f, seconds)));
+}
+
+void Component::stopAnimations() { Animator::stopAll(this); }
+#endif
+
+/**
+ * @brief class which encapsulates the utility functions that many of `Component`s reuse but
+ * which probably shouldn't be publicly accessible outside the header file. basically ignore
+ * this.
+ **/
+class Utility
+{
+	friend class Component;
+
+protected:
+	/**
+	 * @brief draws a box outline using IBM box drawing characters from standard extended ASCII.
+	 * 
+	 * it's up to the caller to ensure `buffer` is allocated to the size specified by `buffer_size`
+	 * 
+	 * @param box_origin offset of the start of the box from the top-left corner of the buffer.
+	 * may be negative, though areas of the box outside the buffer won't be drawn
+	 * @param box_size size of the box. must be positive in both axes. can result in a box which
+	 * ends outside the bounds of the buffer, but areas outside won't be drawn
+	 * @param buffer pointer to a character array ordered left-to-right, top-to-bottom
+	 * @param buffer_size size of the allocated buffer, must match with the size of the `buffer`
+	 **/
+	static void drawBox(Coordinate box_origin, Coordinate box_size, Tixel* buffer, Coordinate buffer_size)
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (buffer == nullptr) return;
+		drawBox(box_origin, box_size, BufferView(buffer, buffer_size));
+	}
+#endif
+	;
+
+	/**
+	 * @brief draws a box outline into a `BufferView`, see the above version of `drawBox`.
+	 * 
+	 * @param box_origin offset of the start of the box from the top-left corner of the view
+	 * @param box_size size of the box. must be positive in both axes
+	 * @param buffer view to draw into
+	 **/
+	static void drawBox(Coordinate box_origin, Coordinate box_size, BufferView buffer)
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (!buffer.isValid()) return;
+		if (box_size.x <= 0 || box_size.y <= 0) return;
+		Coordinate buffer_size = buffer.size;
+
+		if (box_origin.y >= 0 && box_origin.y < buffer_size.y)
+		{
+			for (int x = box_origin.x; x < box_origin.x + box_size.x; x++)
+			{
+				if (x < 0) continue;
+				if (x >= buffer_size.x) break;
+
+				buffer.at(x, box_origin.y) = (x == box_origin.x ? UNICODE_BOX_TOPLEFT : (x == box_origin.x + box_size.x - 1 ? UNICODE_BOX_TOPRIGHT : UNICODE_BOX_HORIZONTAL));
+			}
+		}
+
+		for (int y = box_origin.y + 1; y < box_origin.y + box_size.y - 1; y++)
+		{
+			if (y < 0) continue;
+			if (y >= buffer_size.y) break;
+
+			if (box_origin.x >= 0 && box_origin.x < buffer_size.x)
+				buffer.at(box_origin.x, y) = UNICODE_BOX_VERTICAL;
+
+			if (box_origin.x + box_size.x - 1 >= 0 && box_origin.x + box_size.x - 1 < buffer_size.x)
+				buffer.at(box_origin.x + box_size.x - 1, y) = UNICODE_BOX_VERTICAL;
+		}
+
+		if (box_origin.y + box_size.y - 1 >= 0 && box_origin.y + box_size.y - 1 < buffer_size.y)
+		{
+			for (int x = box_origin.x; x < box_origin.x + box_size.x; x++)
+			{
+				if (x < 0) continue;
+				if (x >= buffer_size.x) break;
+
+				buffer.at(x, box_origin.y + box_size.y - 1) = (x == box_origin.x ? UNICODE_BOX_BOTTOMLEFT : (x == box_origin.x + box_size.x - 1 ? UNICODE_BOX_BOTTOMRIGHT : UNICODE_BOX_HORIZONTAL));
+			}
+		}
+	}
+#endif
+	;
+
+	/**
+	 * @brief split a string at a delimiter character.
+	 * 
+	 * @param text string to split
+	 * @param delim character to split at. this will be removed from the resulting array of strings
+	 * 
+	 * @returns array of strings
+	 */
+	static vector<string> splitString(string_view text, char delim)
+	{
+		vector<string> result;
+		string current;
+
+		for (char c : text)
+		{
+			if (c == delim)
+			{
+				result.push_back(current);
+				current = "";
+			}
+			else
+				current += c;
+		}
+		result.push_back(current);
+
+		return result;
+	}
+
+	/**
+	 * @brief joins some strings together into scratch memory, which lasts until the start of
+	 * the next frame. use this to build text for drawing without allocating every frame.
+	 * 
+	 * @param parts strings to join, in order
+	 * 
+	 * @returns the joined string, which must not be kept past the end of the frame
+	 **/
+	static string_view scratchJoin(initializer_list<string_view> parts)
+#ifdef STUI_IMPLEMENTATION
+	{
+		size_t length = 0;
+		for (string_view part : parts) length += part.length();
+		char* memory = scratch_arena.allocate(length);
+		size_t offset = 0;
+		for (string_view part : parts)
+		{
+			memcpy(memory + offset, part.data(), part.length());
+			offset += part.length();
+		}
+		return string_view(memory, length);
+	}
+#endif
+	;
+
+	/**
+	 * @brief formats a string with `printf`-style arguments into scratch memory, which lasts
+	 * until the start of the next frame. see `scratchJoin`.
+	 * 
+	 * @param format `printf` format string
+	 * 
+	 * @returns the formatted string, which must not be kept past the end of the frame
+	 **/
+	static string_view scratchFormat(const char* format, ...)
+#ifdef STUI_IMPLEMENTATION
+	{
+		va_list args;
+		va_start(args, format);
+		va_list args_copy;
+		va_copy(args_copy, args);
+		int length = vsnprintf(nullptr, 0, format, args_copy);
+		va_end(args_copy);
+		if (length < 0) { va_end(args); return string_view(); }
+		char* memory = scratch_arena.allocate(static_cast<size_t>(length) + 1);
+		vsnprintf(memory, static_cast<size_t>(length) + 1, format, args);
+		va_end(args);
+		return string_view(memory, static_cast<size_t>(length));
+	}
+#endif
+	;
+
+	/**
+	 * @brief version of `stripNullsAndMore` which writes the result into scratch memory, which
+	 * lasts until the start of the next frame. see `scratchJoin`.
+	 * 
+	 * @param str string to remove invalid characters from
+	 * @param others array of additional characters that should be excluded
+	 * 
+	 * @returns the repaired string, which must not be kept past the end of the frame
+	 **/
+	static string_view scratchStrip(string_view str, const char* others)
+#ifdef STUI_IMPLEMENTATION
+	{
+		size_t length = 0;
+		bool unchanged = true;
+		for (char c : str)
+		{
+			bool kept = isKeptCharacter(c, others);
+			if (kept) length += (c == '\t') ? 4 : 1;
+			if (!kept || c == '\t') unchanged = false;
+		}
+		// nothing to take out, so the original can be used as it is
+		if (unchanged) return str;
+
+		char* memory = scratch_arena.allocate(length);
+		size_t offset = 0;
+		for (char c : str)
+		{
+			if (!isKeptCharacter(c, others)) continue;
+			if (c == '\t') { memcpy(memory + offset, "    ", 4); offset += 4; }
+			else memory[offset++] = c;
+		}
+		return string_view(memory, length);
+	}
+#endif
+	;
+
+	/**
+	 * @brief converts a single string into an array of lines of a given maximum length.
+	 * 
+	 * respects line breaks, uses word-wrapping where possible, or forcibly breaks words 
+	 * if necessary.
+	 * 
+	 * @param text string on which to perform wrapping
+	 * @param max_width maximum number of characters to place in any row
+	 * 
+	 * @returns list of individual lines of text
+	 **/
+	static vector<string> wrapText(string_view text, size_t max_width)
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (text.length() < 1)
+			return vector<string>({""});
+		vector<string> result;
+		size_t start = 0;
+		while (start != string::npos)
+		{
+			start++;
+			size_t end = text.find('\n', start);
+			vector<string> tmp = wrapTextInner(text.substr(start, end - start), max_width);
+			for (string s : tmp) result.push_back(s);
+			start = end;
+		}
+		//	i hate this
+		if (result.size() > 0)
+			result[0] = text[0] + result[0];
+		return result;
+	}
+#endif
+	;
+
+	static vector<string> wrapTextInner(string_view text, size_t max_width)
+#ifdef STUI_IMPLEMENTATION
+	{
+		vector<string> lines;
+		size_t last_index = 0;
+		while (last_index != text.length())
+		{
+			size_t max_end = min(last_index + max_width - 1, text.length() - 1);
+			size_t next_end = max_end;
+			bool trim_whitespace = false;
+			while (text[next_end] != ' ')
+			{
+				if (next_end == text.length() - 1)
+				{
+					trim_whitespace = false;
+					break;
+				}
+
+				if (next_end == last_index)
+				{
+					next_end = max_end;
+					trim_whitespace = false;
+					break;
+				}
+				next_end--;
+			}
+			lines.push_back(string(text.substr(last_index, ((next_end - last_index) + 1) - trim_whitespace)));
+			last_index = next_end + 1;
+		}
+		return lines;
+	}
+#endif
+	;
+
+	/**
+	 * @brief draws a line of text into a buffer.
+	 * 
+	 * supports single-line drawing (out-of-bounds characters are skipped), with each UTF-8
+	 * character taking up one cell. it's up to the caller to ensure `buffer` is allocated to 
+	 * the size specified by `buffer_size`. 
+	 * newlines, nulls or other special characters should not be passed into this function, 
+	 * as it will fuck up the output stage at the end of rendering.
+	 * 
+	 * @param text text to draw to the buffer
+	 * @param text_origin position in the output buffer of the top-left-most corner of the
+	 * text
+	 * @param max_size maximum size of the drawn text, measured from the `text_origin`. must 
+	 * be positive in both dimensions. text that runs outside this area is not drawn
+	 * @param buffer pointer to a `Tixel` array ordered left-to-right, top-to-bottom
+	 * @param buffer_size size of the allocated buffer, must match with the size of the `buffer`
+	 **/
+	static void drawText(string_view text, Coordinate text_origin, Coordinate max_size, Tixel* buffer, Coordinate buffer_size)
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (buffer == nullptr) return;
+		drawText(text, text_origin, max_size, BufferView(buffer, buffer_size));
+	}
+#endif
+	;
+
+	/**
+	 * @brief draws a line of text into a `BufferView`, see the above version of `drawText`.
+	 * 
+	 * @param text text to draw to the view
+	 * @param text_origin position in the view of the top-left-most corner of the text
+	 * @param max_size maximum size of the drawn text, measured from the `text_origin`
+	 * @param buffer view to draw into
+	 **/
+	static void drawText(string_view text, Coordinate text_origin, Coordinate max_size, BufferView buffer)
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (!buffer.isValid()) return;
+		if (text_origin.y < 0 || text_origin.y >= buffer.size.y) return;
+
+		// the rest of a multi-byte UTF-8 character goes into the same cell as its first byte
+		Tixel* row = buffer.row(text_origin.y);
+		Tixel* last = nullptr;
+		int column = -1;
+		for (size_t i = 0; i < text.length(); i++)
+		{
+			if (isContinuationByte(text[i])) { if (last != nullptr) last->appendByte(text[i]); continue; }
+			column++;
+			last = nullptr;
+			if (text_origin.x + column < 0) continue;
+			if (text_origin.x + column >= buffer.size.x || column >= max_size.x) break;
+			if (text[i] == '\n') break;
+
+			last = &row[text_origin.x + column];
+			*last = text[i];
+		}
+	}
+#endif
+	;
+
+	/**
+	 * @brief draws a block of text into a buffer.
+	 * 
+	 * supports either multi-line wrapped drawing, where lines are wrapped to fit into the
+	 * box specified by `max_size`. it's up to the caller to ensure `buffer` is allocated 
+	 * to the size specified by `buffer_size`. newlines, nulls or other special characters 
+	 * should not be passed into this function, as it will fuck up the output stage at the
+	 * end of rendering.
+	 * 
+	 * @param text text to draw to the buffer
+	 * @param text_origin position in the output buffer of the top-left-most corner of the
+	 * text
+	 * @param max_size maximum size of the drawn text, measured from the `text_origin`. must 
+	 * be positive in both dimensions. text that runs outside this area will be wrapped to 
+	 * fit inside this horizontally
+	 * @param buffer pointer to a `Tixel` array ordered left-to-right, top-to-bottom
+	 * @param buffer_size size of the allocated buffer, must match with the size of the `buffer`
+	 **/
+	static vector<size_t> drawTextWrapped(string_view text, Coordinate text_origin, Coordinate max_size, Tixel* buffer, Coordinate buffer_size)
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (buffer == nullptr) return vector<size_t>();
+		if (buffer_size.x <= 0 || buffer_size.y <= 0) return vector<size_t>();
+
+		vector<string> lines = wrapText(text, min(max_size.x, buffer_size.x - text_origin.x));
+		
+		int row = -1;
+		for (const string& line : lines)
+		{
+			row++;
+			if (row >= max_size.y || row + text_origin.y >= buffer_size.y) break;
+			if (row + text_origin.y < 0) continue;
+
+			for (size_t col = 0; col < line.length(); col++)
+			{
+				buffer[(text_origin.x + col) + ((text_origin.y + row) * buffer_size.x)] = line[col];
+			}
+		}
+
+		vector<size_t> line_lengths;
+		for (const string& l : lines) line_lengths.push_back(l.length());
+
+		return line_lengths;
+	}
+#endif
+	;
+
+	/**
+	 * @brief simplifies allocation of 2D text buffers.
+	 * 
+	 * automatically clears the buffer with spaces and adds an extra null-terminator on the end. this
+	 * function allocates memory with `new`, and callers are responsible for `delete[]`ing the buffers
+	 * after it is no longer being used.
+	 * 
+	 * @param buffer_size two-dimensional size of the buffer required. must be positive and non-zero in
+	 * both axes
+	 * 
+	 * @returns pointer to newly-allocated block of memory, or `nullptr` if the buffer size would be
+	 * less than 1
+	 **/
+	static Tixel* makeBuffer(Coordinate buffer_size)
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (buffer_size.x <= 0 || buffer_size.y <= 0) return nullptr;
+
+		size_t size = buffer_size.x * buffer_size.y;
+		Tixel* buf = new Tixel[size + 1];
+		fillTixels(buf, size, Tixel{ ' ', getDefaultColour() });
+		buf[size] = Tixel{ '\0', getDefaultColour() };
+
+		return buf;
+	}
+#endif
+	;
+
+	/**
+	 * @brief copy an area from one buffer to another.
+	 * 
+	 * useful for transferring an area into a larger, differently-shaped buffer for combining elements.
+	 * it's up to the caller to ensure `src` is allocated to the size specified by `src_size`, and to
+	 * ensure 'dst' is allocated to the size specified by `dst_size`. also, this function does not
+	 * clamp the bounds of the box, so trying to copy a box which overflows outside `src` or `dst`, or
+	 * both at once, is likely to corrupt the heap or cause an exception.
+	 * 
+	 * @param src source buffer to copy characters from. must be appropriately sized and allocated, see
+	 * above
+	 * @param src_size size of the source buffer, must match with the allocated size of `src`
+	 * @param src_offset position of the top-left corner of the box to copy in the source buffer. must
+	 * be positive in both dimensions
+	 * @param area_size size of the area to be copied between buffers. must fit inside both buffers
+	 * @param dst destination buffer to copy characters into. must be appropriately sized and allocated,
+	 * see above
+	 * @param dst_size size of the destination buffer, must match with the allocated size of `dst`
+	 * @param dst_offset position of the top-left corner of the box to copy to in the destination buffer.
+	 * must be positive in both dimensions
+	 **/
+	static void copyBox(const Tixel* src, Coordinate src_size, Coordinate src_offset, Coordinate area_size, Tixel* dst, Coordinate dst_size, Coordinate dst_offset)
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (src == nullptr || dst == nullptr) return;
+		if (area_size.x <= 0 || area_size.y <= 0) return;
+		if (src_offset.x < 0 || src_offset.y < 0) return;
+		if (dst_offset.x < 0 || dst_offset.y < 0) return;
+		if (src_offset.x + area_size.x > src_size.x || src_offset.y + area_size.y > src_size.y) return;
+		if (dst_offset.x + area_size.x > dst_size.x || dst_offset.y + area_size.y > dst_size.y) return;
+
+		for (int y = 0; y < area_size.y; y++)
+		{
+			memcpy(dst + dst_offset.x + ((y + dst_offset.y) * dst_size.x), src + src_offset.x + ((y + src_offset.y) * src_size.x), area_size.x * sizeof(Tixel));
+		}
+	}
+#endif
+	;
+
+	/**
+	 * @brief get the current default colour configuration for the interface.
+	 * 
+	 * @returns the current colour configuration
+	 **/
+	static inline Tixel::ColourCommand getDefaultColour()
+	{
+		return (Tixel::ColourCommand)(Tixel::ColourCommand::BG_BLACK | Tixel::ColourCommand::FG_WHITE);
+	}
+
+	/**
+	 * @brief get the current highlighted colour configuration for the interface.
+	 * 
+	 * @returns the current highlighted colour configuration
+	 **/
+	static inline Tixel::ColourCommand getHighlightedColour()
+	{
+		return (Tixel::ColourCommand)(Tixel::ColourCommand::FG_BLACK | Tixel::ColourCommand::BG_WHITE);
+	}
+
+	/**
+	 * @brief get the current unfocused colour configuration for the interface.
+	 * 
+	 * @returns the current unfocused colour configuration
+	 **/
+	static inline Tixel::ColourCommand getUnfocusedColour()
+	{
+		return (Tixel::ColourCommand)(Tixel::ColourCommand::FG_BLACK | Tixel::ColourCommand::BG_GRAY);
+	}
+
+	/**
+	 * @brief fill a specified box area with a particular colour command.
+	 * 
+	 * @param colour colour command to fill the area with
+	 * @param origin starting offset of the area
+	 * @param size size of the area. must be positive in both axes
+	 * @param buffer output buffer into which the filled box should be drawn
+	 * @param buffer_size size of the output buffer
+	 **/
+	static void fillColour(Tixel::ColourCommand colour, Coordinate origin, Coordinate size, Tixel* buffer, Coordinate buffer_size)
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (buffer == nullptr) return;
+		fillColour(colour, origin, size, BufferView(buffer, buffer_size));
+	}
+#endif
+	;
+
+	/**
+	 * @brief fill a specified box area of a `BufferView` with a particular colour command.
+	 * 
+	 * @param colour colour command to fill the area with
+	 * @param origin starting offset of the area
+	 * @param size size of the area. must be positive in both axes
+	 * @param buffer view into which the filled box should be drawn
+	 **/
+	static void fillColour(Tixel::ColourCommand colour, Coordinate origin, Coordinate size, BufferView buffer)
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (size.x <= 0 || size.y <= 0) return;
+		if (!buffer.isValid()) return;
+
+		BufferView area = buffer.subView(origin, size);
+		for (int y = 0; y < area.size.y; y++)
+		{
+			Tixel* row = area.row(y);
+			for (int x = 0; x < area.size.x; x++)
+				row[x].colour = colour;
+		}
+	}
+#endif
+	;
+
+	/**
+	 * @brief get a blank `Tixel` using the default colour, as used to clear buffers.
+	 * 
+	 * @returns a space with the default colour
+	 **/
+	static inline Tixel getBlankTixel()
+	{
+		return Tixel{ ' ', getDefaultColour() };
+	}
+
+	/**
+	 * @brief shares out space along one axis between a list of items.
+	 * 
+	 * every item gets its minimum size first, then the remaining space is handed out in
+	 * proportion to each item's weight, without taking any item past its maximum size. space
+	 * which an item can't take is passed on to the others. items with a weight of zero stay
+	 * at their minimum size. with equal weights, this gives the same result as growing each
+	 * item by one cell in turn until they're all full or the space runs out.
+	 * 
+	 * @param space total amount of space available
+	 * @param min_sizes minimum size of each item
+	 * @param max_sizes maximum size of each item, or -1 for no maximum
+	 * @param weights share of the leftover space each item should receive, relative to the others
+	 * @param sizes receives the calculated size of each item
+	 * 
+	 * @returns false if the minimum sizes alone don't fit in the space available
+	 **/
+	static bool distributeSpace(int space, const vector<int>& min_sizes, const vector<int>& max_sizes, const vector<int>& weights, vector<int>& sizes)
+#ifdef STUI_IMPLEMENTATION
+	{
+		sizes = min_sizes;
+		long long budget = space;
+		for (int s : min_sizes) budget -= s;
+		if (budget < 0) return false;
+
+		auto capacity = [&](size_t i) -> long long { return (max_sizes[i] == -1) ? -1 : max_sizes[i] - min_sizes[i]; };
+
+		// kept between calls so that laying out doesn't allocate once they're big enough
+		static thread_local vector<size_t> growable;
+		static thread_local vector<pair<long long, size_t>> remainders;
+		growable.clear();
+		remainders.clear();
+		long long total_weight = 0;
+		for (size_t i = 0; i < min_sizes.size(); i++)
+		{
+			if (weights[i] <= 0 || (max_sizes[i] != -1 && max_sizes[i] <= min_sizes[i])) continue;
+			growable.push_back(i);
+			total_weight += weights[i];
+		}
+
+		// order items by how soon they fill up relative to their weight, so items which fill up
+		// early can be given everything they can take, and their leftovers shared among the rest
+		// (ties keep their original order, which `sort` won't do by itself)
+		sort(growable.begin(), growable.end(), [&](size_t a, size_t b)
+		{
+			long long capacity_a = capacity(a);
+			long long capacity_b = capacity(b);
+			if (capacity_a == -1 && capacity_b == -1) return a < b;
+			if (capacity_a == -1) return false;
+			if (capacity_b == -1) return true;
+			long long lhs = capacity_a * weights[b];
+			long long rhs = capacity_b * weights[a];
+			return (lhs != rhs) ? (lhs < rhs) : (a < b);
+		});
+
+		size_t first_unfilled = 0;
+		for (; first_unfilled < growable.size() && budget > 0; first_unfilled++)
+		{
+			size_t i = growable[first_unfilled];
+			long long c = capacity(i);
+			if (c == -1 || c * total_weight > budget * weights[i]) break;
+			sizes[i] += static_cast<int>(c);
+			budget -= c;
+			total_weight -= weights[i];
+		}
+		if (first_unfilled == growable.size() || budget == 0) return true;
+
+		// none of the remaining items will fill up, so each gets its exact share, with the cells
+		// lost to rounding going to the largest remainders (and earlier items on a tie)
+		long long handed_out = 0;
+		for (size_t j = first_unfilled; j < growable.size(); j++)
+		{
+			size_t i = growable[j];
+			long long share = budget * weights[i];
+			sizes[i] += static_cast<int>(share / total_weight);
+			handed_out += share / total_weight;
+			remainders.push_back(pair<long long, size_t>(share % total_weight, i));
+		}
+		sort(remainders.begin(), remainders.end(), [](const pair<long long, size_t>& a, const pair<long long, size_t>& b)
+		{
+			return (a.first != b.first) ? (a.first > b.first) : (a.second < b.second);
+		});
+		for (long long j = 0; j < budget - handed_out; j++)
+			sizes[remainders[static_cast<size_t>(j)].second]++;
+
+		return true;
+	}
+#endif
+	;
+};
+
+#ifdef STUI_IMPLEMENTATION
+static bool caching_enabled = false;
+static size_t render_frame_index = 1;
+static size_t surface_generation = 1;
+static atomic<bool> surface_touched{ false };		// something has been drawn into the frame surface this frame
+
+/**
+ * @brief an area of the frame surface whose contents have moved vertically since it was last drawn.
+ **/
+struct ScrollHint
+{
+	Tixel* surface;		// surface the area is on
+	int top;			// first row of the area
+	int height;			// number of rows in the area
+	int rows;			// how far the contents moved up, or down if negative
+};
+
+static bool hardware_scrolling = true;			// see `Renderer::enableHardwareScrolling`
+#if defined(_WIN32)
+#ifdef STUI_TRUECOLOUR
+static bool native_console_output = false;		// see `Renderer::enableNativeConsoleOutput`
+#else
+static bool native_console_output = true;
+#endif
+static vector<CHAR_INFO> console_cells;			// the frame as it was last written into the console's screen buffer
+#endif
+static vector<ScrollHint> scroll_hints;			// areas which scrolled during the current frame
+static mutex scroll_hints_lock;					// only needed while parallel rendering is on
+
+static bool profiling_enabled = false;
+static Profiler::FrameProfile profile_last_frame{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, false };
+static Profiler::FrameHistogram profile_histogram{ };
+static vector<Profiler::ComponentTiming> profile_timings;		// timings for the frame being drawn
+static vector<Profiler::ComponentTiming> profile_last_timings;	// timings for the last frame which was finished
+static float profile_child_seconds = 0.0f;						// time taken by the children of whatever is being measured
+static size_t profile_components_laid_out = 0;
+static size_t profile_components_drawn = 0;
+static vector<pair<size_t, function<void(const Profiler::FrameProfile&)>>> profile_callbacks;
+static size_t profile_next_callback = 1;
+
+static bool parallel_rendering = false;				// see `Renderer::enableParallelRendering`
+static float parallel_cost_threshold = 0.0005f;		// children which took at least this many seconds to draw last time get handed to another thread
+static atomic<size_t> parallel_allocations{ 0 };	// allocations made by the pool's threads during the current frame
+static thread_local size_t render_thread_index = 0;	// which of the pool's queues this thread uses. 0 for threads outside the pool
+static thread_local size_t render_thread_frame = 0;	// frame this thread's scratch arena was last reset for
+
+/**
+ * @brief the threads which draw children for `Component::renderChildren`.
+ * 
+ * every thread has its own queue of jobs. threads add jobs to the back of their own queue and
+ * take them from there too, and when it's empty they steal from the front of someone else's.
+ * a thread waiting for the jobs it handed out also runs jobs in the meantime, so containers which
+ * are themselves being drawn by the pool can hand out their children too without getting stuck.
+ **/
+static struct RenderThreadPool
+{
+	struct Job
+	{
+		Component* parent;
+		size_t parent_pass;
+		Component* child;
+		BufferView target;
+		atomic<size_t>* remaining;	// decremented once the job has been done
+	};
+
+	struct Queue
+	{
+		mutex lock;
+		deque<Job> jobs;
+	};
+
+	vector<thread> threads;
+	vector<unique_ptr<Queue>> queues;	// the first is shared by all threads outside the pool
+	atomic<size_t> queued{ 0 };			// jobs waiting in any queue
+	mutex sleep_lock;
+	condition_variable wakeup;
+	bool stopping = false;
+
+	void start(size_t count)
+	{
+		stop();
+		stopping = false;
+		queues.clear();
+		for (size_t i = 0; i <= count; i++) queues.emplace_back(new Queue());
+		for (size_t i = 1; i <= count; i++)
+		{
+			threads.emplace_back([this, i]()
+			{
+				render_thread_index = i;
+				while (true)
+				{
+					if (tryRun()) continue;
+					unique_lock<mutex> lock(sleep_lock);
+					wakeup.wait(lock, [this]() { return stopping || queued.load() > 0; });
+					if (stopping) return;
+				}
+			});
+		}
+	}
+
+	void stop()
+	{
+		{
+			lock_guard<mutex> lock(sleep_lock);
+			stopping = true;
+		}
+		wakeup.notify_all();
+		for (thread& t : threads) t.join();
+		threads.clear();
+	}
+
+	void push(const Job& job)
+	{
+		Queue& queue = *queues[min(render_thread_index, queues.size() - 1)];
+		{
+			lock_guard<mutex> lock(queue.lock);
+			queue.jobs.push_back(job);
+		}
+		queued++;
+		// taking the lock means a thread which is just about to sleep can't miss this
+		{ lock_guard<mutex> lock(sleep_lock); }
+		wakeup.notify_one();
+	}
+
+	bool tryRun()
+	{
+		Job job;
+		bool found = false;
+		size_t own = min(render_thread_index, queues.size() - 1);
+		for (size_t k = 0; k < queues.size() && !found; k++)
+		{
+			Queue& queue = *queues[(own + k) % queues.size()];
+			lock_guard<mutex> lock(queue.lock);
+			if (queue.jobs.empty()) continue;
+			if (k == 0) { job = queue.jobs.back(); queue.jobs.pop_back(); }
+			else { job = queue.jobs.front(); queue.jobs.pop_front(); }
+			found = true;
+		}
+		if (!found) return false;
+
+		queued--;
+		run(job);
+		return true;
+	}
+
+	void waitFor(atomic<size_t>& remaining)
+	{
+		while (remaining.load(memory_order_acquire) > 0)
+			if (!tryRun()) this_thread::yield();
+	}
+
+	void run(Job& job)
+	{
+		// the scratch arena belongs to the thread, so the pool's threads have to reset their own
+		if (render_thread_index != 0 && render_thread_frame != render_frame_index)
+		{
+			scratch_arena.reset();
+			render_thread_frame = render_frame_index;
+		}
+#ifdef STUI_COUNT_ALLOCATIONS
+		size_t allocations_before = allocation_count;
+#endif
+		Component::drawCached(job.parent, job.parent_pass, job.child, job.target);
+#ifdef STUI_COUNT_ALLOCATIONS
+		if (render_thread_index != 0) parallel_allocations += allocation_count - allocations_before;
+#endif
+		job.remaining->fetch_sub(1, memory_order_release);
+	}
+
+	~RenderThreadPool() { stop(); }
+} render_pool;
+
+void Profiler::enable(bool enabled)
+{
+	if (enabled && !profiling_enabled) profile_timings.clear();
+	profiling_enabled = enabled;
+}
+
+bool Profiler::isEnabled() { return profiling_enabled; }
+
+const Profiler::FrameProfile& Profiler::getLastFrame() { return profile_last_frame; }
+
+const vector<Profiler::ComponentTiming>& Profiler::getComponentTimings() { return profile_last_timings; }
+
+const Profiler::FrameHistogram& Profiler::getHistogram() { return profile_histogram; }
+
+void Profiler::resetHistogram() { profile_histogram = FrameHistogram{ }; }
+
+size_t Profiler::addFrameCallback(function<void(const FrameProfile&)> callback)
+{
+	profile_callbacks.push_back(pair<size_t, function<void(const FrameProfile&)>>(profile_next_callback, move(callback)));
+	return profile_next_callback++;
+}
+
+void Profiler::removeFrameCallback(size_t identifier)
+{
+	for (size_t i = 0; i < profile_callbacks.size(); i++)
+		if (profile_callbacks[i].first == identifier) { profile_callbacks.erase(profile_callbacks.begin() + i); return; }
+}
+
+Profiler::ComponentTiming& Profiler::getTiming(Component* component)
+{
+	if (component->profile_frame != render_frame_index || component->profile_slot >= profile_timings.size()
+		|| profile_timings[component->profile_slot].component != component)
+	{
+		component->profile_frame = render_frame_index;
+		component->profile_slot = profile_timings.size();
+		profile_timings.push_back(ComponentTiming{ component, 0.0f, 0.0f, 0 });
+	}
+	return profile_timings[component->profile_slot];
+}
+
+void Profiler::finishFrame(FrameProfile frame)
+{
+	frame.components_laid_out = profile_components_laid_out;
+	frame.components_drawn = profile_components_drawn;
+	profile_components_laid_out = 0;
+	profile_components_drawn = 0;
+
+	int bucket = 0;
+	while (bucket < FrameHistogram::BUCKETS - 1 && frame.total_seconds >= FrameHistogram::getUpperLimit(bucket)) bucket++;
+	profile_histogram.counts[bucket]++;
+
+	// swapping keeps both lists' memory around, so steady frames don't allocate
+	swap(profile_timings, profile_last_timings);
+	profile_timings.clear();
+	profile_last_frame = frame;
+
+	for (size_t i = 0; i < profile_callbacks.size(); i++) profile_callbacks[i].second(profile_last_frame);
+}
+
+void Component::render(BufferView target)
+{
+	if (!target.isValid()) return;
+
+	if (target.isContiguous())
+	{
+		// plain `render` implementations expect a freshly cleared buffer
+		target.fill(Utility::getBlankTixel());
+		render(target.row(0), target.size);
+		return;
+	}
+
+	// rows aren't next to each other, so draw into a scratch buffer and copy it in. the scratch
+	// buffer is kept between calls, so this doesn't allocate once it's big enough
+	static thread_local vector<Tixel> scratch;
+	size_t length = static_cast<size_t>(target.size.x * target.size.y);
+	if (scratch.size() < length + 1) scratch.resize(length + 1);
+	Tixel blank = Utility::getBlankTixel();
+	for (size_t i = 0; i < length; i++)
+		memcpy(scratch.data() + i, &blank, sizeof(Tixel));
+	scratch[length] = Tixel{ '\0', Utility::getDefaultColour() };
+
+	render(scratch.data(), target.size);
+
+	for (int y = 0; y < target.size.y; y++)
+		memcpy(target.row(y), scratch.data() + (y * target.size.x), target.size.x * sizeof(Tixel));
+}
+
+void Component::markDirty(bool affects_layout)
+{
+	dirty = true;
+	// sizes and layout of everything above this depend on it, so throw those away too
+	for (Component* c = this; c != nullptr; c = c->parent)
+	{
+		if (c != this) c->child_dirty = true;
+		if (!affects_layout) continue;
+		c->sizes_valid = false;
+		c->layout_valid = false;
+	}
+}
+
+// cached layout results can be reused for the rest of the current frame, or with caching enabled,
+// until something is marked dirty (since only then can we rely on being told about changes)
+static inline bool isLayoutMemoCurrent(bool valid, size_t frame, size_t generation)
+{
+	return frame == render_frame_index || (caching_enabled && valid && generation == surface_generation);
+}
+
+Coordinate Component::getLayoutMinSize()
+{
+	if (!isLayoutMemoCurrent(sizes_valid, sizes_frame, sizes_generation))
+	{
+		cached_min_size = getMinSize();
+		cached_max_size = getMaxSize();
+		sizes_valid = true;
+		sizes_frame = render_frame_index;
+		sizes_generation = surface_generation;
+	}
+	return cached_min_size;
+}
+
+Coordinate Component::getLayoutMaxSize()
+{
+	getLayoutMinSize();
+	return cached_max_size;
+}
+
+void Component::placeChild(Component* child, Coordinate offset, Coordinate size)
+{
+	if (child == nullptr) return;
+	placements.push_back(Placement{ child, offset, size });
+	child->parent = this;
+	child->layout_offset = offset;
+	child->ensureLayout(size);
+}
+
+void Component::ensureLayout(Coordinate size)
+{
+	if (layout_size.x == size.x && layout_size.y == size.y && isLayoutMemoCurrent(layout_valid, layout_frame, layout_generation))
+		return;
+
+	layout_size = size;
+	layout_valid = true;
+	layout_frame = render_frame_index;
+	layout_generation = surface_generation;
+	placements.clear();
+	if (!profiling_enabled) { layout(size); return; }
+
+	// time spent laying out children is subtracted, so each component is only charged for its own work
+	float outer_child_seconds = profile_child_seconds;
+	profile_child_seconds = 0.0f;
+	auto start = clock_type::now();
+	layout(size);
+	float elapsed = chrono::duration<float>(clock_type::now() - start).count();
+	Profiler::getTiming(this).layout_seconds += elapsed - profile_child_seconds;
+	profile_components_laid_out++;
+	profile_child_seconds = outer_child_seconds + elapsed;
+}
+
+Component* Component::findComponentAt(Coordinate position)
+{
+	if (position.x < 0 || position.y < 0 || position.x >= layout_size.x || position.y >= layout_size.y)
+		return nullptr;
+
+	for (const Placement& p : placements)
+	{
+		Coordinate relative{ position.x - p.offset.x, position.y - p.offset.y };
+		if (relative.x >= 0 && relative.y >= 0 && relative.x < p.size.x && relative.y < p.size.y)
+		{
+			Component* found = p.child->findComponentAt(relative);
+			return (found == nullptr) ? p.child : found;
+		}
+	}
+
+	return this;
+}
+
+void Component::attachChild(Component* child)
+{
+	markDirty();
+	// the new child might also be somewhere else in the tree, which is only noticed by drawing
+	// everything above it on one thread, so forget how long those took
+	for (Component* c = this; c != nullptr; c = c->parent) c->draw_seconds = 0.0f;
+	if (child == nullptr) return;
+	for (size_t i = 0; i < listeners.size(); i++) listeners[i]->childAttached(this, child);
+}
+
+void Component::detachChild(Component* child)
+{
+	markDirty();
+	if (child == nullptr) return;
+	for (size_t i = 0; i < listeners.size(); i++) listeners[i]->childDetached(this, child);
+}
+
+void Component::renderChildren(BufferView target)
+{
+	const vector<Placement>& children = getPlacements();
+	if (!parallel_rendering || profiling_enabled || children.size() < 2 || render_pool.threads.empty())
+	{
+		for (const Placement& p : children) renderChild(p.child, target.subView(p.offset, p.size));
+		return;
+	}
+
+	// anything which appears more than once in the tree could be drawn by two threads at once, so
+	// it stays here, along with anything too cheap to be worth handing over. only subtrees which
+	// `findSharedComponents` has checked this frame are trusted, since a child may have been added
+	// without anything being told
+	auto worth_handing_over = [](Component* child)
+	{
+		return child != nullptr && child->draw_seconds >= parallel_cost_threshold && !child->shared && !child->contains_shared
+			&& child->exclusive_frame == render_frame_index && child->tree_exclusive;
+	};
+
+	// the last expensive child is drawn on this thread, rather than sitting idle while it waits
+	size_t kept = children.size();
+	for (size_t i = children.size(); i > 0; i--)
+		if (worth_handing_over(children[i - 1].child)) { kept = i - 1; break; }
+
+	// which children were handed over is remembered, since their timings change once they've been drawn
+	atomic<size_t> remaining{ 0 };
+	uint64_t handed_over = 0;
+	for (size_t i = 0; i < children.size() && i < 64; i++)
+	{
+		if (i == kept || !worth_handing_over(children[i].child)) continue;
+		handed_over |= static_cast<uint64_t>(1) << i;
+		remaining.fetch_add(1, memory_order_relaxed);
+		render_pool.push(RenderThreadPool::Job{ this, render_pass, children[i].child, target.subView(children[i].offset, children[i].size), &remaining });
+	}
+	for (size_t i = 0; i < children.size(); i++)
+		if (i >= 64 || !(handed_over & (static_cast<uint64_t>(1) << i)))
+			renderChild(children[i].child, target.subView(children[i].offset, children[i].size));
+	render_pool.waitFor(remaining);
+}
+
+void Component::recordScroll(BufferView target)
+{
+	if (!scroll_reported) return;
+	scroll_reported = false;
+	long long moved = scroll_position - scrolled_position;
+	bool same_place = scrolled_target.surface == target.surface && scrolled_target.stride == target.stride
+		&& scrolled_target.origin.x == target.origin.x && scrolled_target.origin.y == target.origin.y
+		&& scrolled_target.size.x == target.size.x && scrolled_target.size.y == target.size.y;
+	scrolled_position = scroll_position;
+	scrolled_target = target;
+	if (!same_place || moved == 0 || moved >= target.size.y || -moved >= target.size.y) return;
+
+	ScrollHint hint{ target.surface, target.origin.y, target.size.y, static_cast<int>(moved) };
+	if (!parallel_rendering) { scroll_hints.push_back(hint); return; }
+	lock_guard<mutex> lock(scroll_hints_lock);
+	scroll_hints.push_back(hint);
+}
+
+void Component::findSharedComponents(Component* root)
+{
+	// everything is counted before anything is checked, since a component's second parent may
+	// be reached after the first one's subtree has been looked at
+	countParents(root);
+	isExclusive(root);
+}
+
+void Component::countParents(Component* component)
+{
+	if (component->tree_frame == render_frame_index)
+	{
+		if (component->tree_parents < 2) component->tree_parents++;
+		return;
+	}
+	component->tree_frame = render_frame_index;
+	component->tree_parents = 1;
+	size_t count = component->getChildCount();
+	for (size_t i = 0; i < count; i++)
+	{
+		Component* child = component->getChild(i);
+		if (child != nullptr) countParents(child);
+	}
+}
+
+bool Component::isExclusive(Component* component)
+{
+	if (component->exclusive_frame == render_frame_index) return component->tree_exclusive;
+	component->exclusive_frame = render_frame_index;
+	component->tree_exclusive = false;
+	bool exclusive = component->tree_parents == 1;
+	size_t count = component->getChildCount();
+	for (size_t i = 0; i < count; i++)
+	{
+		Component* child = component->getChild(i);
+		if (child != nullptr && !isExclusive(child)) exclusive = false;
+	}
+	component->tree_exclusive = exclusive;
+	return exclusive;
+}
+
+void Component::markContainsShared()
+{
+	for (Component* c = this; c != nullptr && !c->contains_shared; c = c->parent)
+		c->contains_shared = true;
+}
+
+bool Component::startDraw(Component* parent, size_t parent_pass, Component* child, BufferView target)
+{
+	if (child == nullptr || !target.isValid()) return false;
+
+	// a component which appears more than once can't tell which place it was last drawn in, and
+	// its changes can only be propagated to one parent, so it (and all of its ancestors) must
+	// always be visited
+	if (child->drawn_frame == render_frame_index && !child->shared)
+	{
+		child->shared = true;
+		if (child->drawn_by != nullptr) child->drawn_by->markContainsShared();
+		if (parent != nullptr) parent->markContainsShared();
+	}
+
+	// the child's previous output is only still on the surface if the parent's was, and if the
+	// child was drawn in the same place during the parent's previous pass
+	bool trusted = caching_enabled
+		&& (parent == nullptr || parent->region_trusted)
+		&& !child->shared
+		&& child->drawn_by == parent
+		&& child->drawn_pass + 1 == parent_pass
+		&& child->drawn_generation == surface_generation
+		&& child->drawn_target.surface == target.surface
+		&& child->drawn_target.stride == target.stride
+		&& child->drawn_target.origin.x == target.origin.x && child->drawn_target.origin.y == target.origin.y
+		&& child->drawn_target.size.x == target.size.x && child->drawn_target.size.y == target.size.y;
+
+	child->parent = parent;
+	child->drawn_by = parent;
+	child->drawn_pass = parent_pass;
+	child->drawn_frame = render_frame_index;
+	child->drawn_generation = surface_generation;
+	child->drawn_target = target;
+
+	if (trusted && !child->dirty && !child->child_dirty && !child->contains_shared) return false;
+
+	// children of this child can keep their output only if this child's region was left alone
+	child->region_trusted = trusted;
+	child->render_pass++;
+	child->dirty = false;
+	child->child_dirty = false;
+	surface_touched.store(true, memory_order_relaxed);
+	return true;
+}
+
+bool Component::isMeasuringDraws()
+{
+	return profiling_enabled || parallel_rendering;
+}
+
+bool Component::clearForPlainRender(BufferView target)
+{
+	if (!target.isContiguous()) return false;
+	target.fill(Utility::getBlankTixel());
+	return true;
+}
+
+void Component::drawCached(Component* parent, size_t parent_pass, Component* child, BufferView target)
+{
+	if (!startDraw(parent, parent_pass, child, target)) return;
+	if (!profiling_enabled)
+	{
+		if (!parallel_rendering) { child->render(target); child->recordScroll(target); return; }
+
+		// remember how expensive this was, to decide whether it's worth drawing on another thread next time
+		auto start = clock_type::now();
+		child->render(target);
+		child->draw_seconds = chrono::duration<float>(clock_type::now() - start).count();
+		child->recordScroll(target);
+		return;
+	}
+
+	// as with layout, time spent drawing children (or laying anything out) isn't charged to this one
+	float outer_child_seconds = profile_child_seconds;
+	profile_child_seconds = 0.0f;
+	auto start = clock_type::now();
+	child->render(target);
+	float elapsed = chrono::duration<float>(clock_type::now() - start).count();
+	child->recordScroll(target);
+	Profiler::ComponentTiming& timing = Profiler::getTiming(child);
+	timing.render_seconds += elapsed - profile_child_seconds;
+	timing.renders++;
+	profile_components_drawn++;
+	profile_child_seconds = outer_child_seconds + elapsed;
+}
+#endif
+
+/**
+ * @brief single-line text box.
+ * 
+ * text `alignment` can be specified as < 0 for left-aligned, = 0 for center-aligned, or
+ * > 0 for right-aligned
+ **/
+class Label : public Component, public Utility
+{
+public:
+	string text;
+	int alignment;
+	
+	Label(string _text, int _alignment) : text(_text), alignment(_alignment) { }
+
+	GETTYPENAME_STUB("Label");
+
+	RENDER_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (size.y < 1) return;
+
+		Coordinate offset{ 0,0 };
+		if (alignment < 0)
+			offset.x = 0;
+		else if (alignment == 0)
+			offset.x = static_cast<int>((size.x - text.length()) / 2);
+		else if (alignment > 0)
+			offset.x = static_cast<int>(size.x - text.length());
+
+		drawText(scratchStrip(text, "\n\t"), offset, Coordinate{ static_cast<int>(text.length()), 1 }, output_buffer, size);
+	}
+#endif
+	;
+
+	GETMAXSIZE_STUB { return Coordinate{ -1, 1 }; }
+	GETMINSIZE_STUB { return Coordinate{ static_cast<int>(text.length()), 1 }; }
+};
+
+/**
+ * @brief simple clickable button.
+ **/
+class Button : public Component, public Utility
+{
+public:
+	string text;
+	void (*callback)();
+	bool enabled;
+
+	Button(string _text, void (*_callback)(), bool _enabled) : text(_text), callback(_callback), enabled(_enabled) { }
+
+	GETTYPENAME_STUB("Button");
+
+	RENDER_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (size.y < 1) return;
+
+		int offset = (size.x - static_cast<int>(text.length()) - 4) / 2;
+		drawText(scratchJoin({ "> ", text, " <" }), Coordinate{ offset,0 }, Coordinate{ static_cast<int>(text.length()) + 4,1 }, output_buffer, size);
+		if (focused)
+			fillColour(enabled ? getHighlightedColour() : getUnfocusedColour(), Coordinate{ offset,0 }, Coordinate{ static_cast<int>(text.length()) + 4,1 }, output_buffer, size);
+	}
+#endif
+	;
+
+	GETMAXSIZE_STUB { return Coordinate{ -1,1 }; }
+	GETMINSIZE_STUB { return Coordinate{ static_cast<int>(text.length()) + 4,1 }; }
+
+	HANDLEINPUT_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if ((input_character == '\n' || input_character == ' ') && callback != nullptr && focused && enabled) { callback(); return true; }
+		return false;
+	}
+#endif
+	;
+
+	ISFOCUSABLE_STUB { return enabled; }
+};
+
+/**
+ * @brief list of options from which the user can select one by navigating up/down and
+ * pressing enter/space.
+ **/
+class RadioButton : public Component, public Utility
+{
+	int highlighted_index = 0;
+
+public:
+	vector<string> options;
+	int selected_index;
+	bool enabled;
+
+	RadioButton(vector<string> _options, int _selected_index, bool _enabled) : options(_options), selected_index(_selected_index), enabled(_enabled) { }
+
+	GETTYPENAME_STUB("RadioButton");
+
+	RENDER_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (size.y < 1) return;
+
+		for (int line = 0; line < static_cast<int>(options.size()); line++)
+		{
+			if (line >= size.y) break;
+			drawText(scratchJoin({ "[ ] ", options[line] }), Coordinate{ 0,line }, Coordinate{ size.x,1 }, output_buffer, size);
+			output_buffer[(line * size.x) + 1] = selected_index == line ? '*' : ' ';
+			if (line == highlighted_index && enabled)
+				fillColour(focused ? getHighlightedColour() : getUnfocusedColour(), Coordinate{ 0,line }, Coordinate{ size.x,1}, output_buffer, size);
+		}
+	}
+#endif
+	;
+
+	GETMAXSIZE_STUB { return Coordinate{ -1,-1 }; }
+	GETMINSIZE_STUB { return Coordinate{ 5, static_cast<int>(options.size()) }; }
+
+	ISFOCUSABLE_STUB { return true; }
+
+	HANDLEINPUT_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (!focused || !enabled) return false;
+
+		if (input_character == Input::ArrowKeys::UP && highlighted_index > 0) highlighted_index--;
+		if (input_character == Input::ArrowKeys::DOWN && highlighted_index + 1 < static_cast<int>(options.size())) highlighted_index++;
+		if (input_character == Input::ArrowKeys::LEFT) highlighted_index = 0;
+		if (input_character == Input::ArrowKeys::RIGHT) highlighted_index = max(0, static_cast<int>(options.size()) - 1);
+		if (input_character == ' ' || input_character == '\n') selected_index = highlighted_index;
+		return input_character == Input::ArrowKeys::UP || input_character == Input::ArrowKeys::DOWN
+			|| input_character == Input::ArrowKeys::LEFT || input_character == Input::ArrowKeys::RIGHT
+			|| input_character == ' ' || input_character == '\n';
+	}
+#endif
+	;
+};
+
+/**
+ * @brief list of options from which the user can select any, all, or none by navigating
+ * up/down and pressing enter/space.
+ **/
+class ToggleButton : public Component, public Utility
+{
+	int highlighted_index = 0;
+
+public:
+	vector<pair<string, bool>> options;
+	bool enabled;
+
+	ToggleButton(vector<pair<string, bool>> _options, bool _enabled) : options(_options), enabled(_enabled) { }
+
+	GETTYPENAME_STUB("ToggleButton");
+
+	RENDER_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (size.y < 1) return;
+
+		for (int line = 0; line < static_cast<int>(options.size()); line++)
+		{
+			if (line >= size.y) break;
+			drawText(scratchJoin({ "[ ] ", options[line].first }), Coordinate{ 0,line }, Coordinate{ size.x,1 }, output_buffer, size);
+			output_buffer[(line * size.x) + 1] = options[line].second ? '*' : ' ';
+			if (line == highlighted_index && enabled)
+				fillColour(focused ? getHighlightedColour() : getUnfocusedColour(), Coordinate{ 0,line }, Coordinate{ size.x,1}, output_buffer, size);
+		}
+	}
+#endif
+	;
+
+	GETMAXSIZE_STUB { return Coordinate{ -1,-1 }; }
+	GETMINSIZE_STUB { return Coordinate{ 5, static_cast<int>(options.size()) }; }
+
+	ISFOCUSABLE_STUB { return true; }
+
+	HANDLEINPUT_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (!focused || !enabled) return false;
+
+		if (input_character == Input::ArrowKeys::UP && highlighted_index > 0) highlighted_index--;
+		if (input_character == Input::ArrowKeys::DOWN && highlighted_index + 1 < static_cast<int>(options.size())) highlighted_index++;
+		if (input_character == Input::ArrowKeys::LEFT) highlighted_index = 0;
+		if (input_character == Input::ArrowKeys::RIGHT) highlighted_index = max(0, static_cast<int>(options.size()) - 1);
+		if (input_character == ' ' || input_character == '\n') options[highlighted_index].second = !options[highlighted_index].second;
+		return input_character == Input::ArrowKeys::UP || input_character == Input::ArrowKeys::DOWN
+			|| input_character == Input::ArrowKeys::LEFT || input_character == Input::ArrowKeys::RIGHT
+			|| input_character == ' ' || input_character == '\n';
+	}
+#endif
+	;
+};
+
+/**
+ * @brief simple text entry box.
+ **/
+class TextInputBox : public Component, public Utility
+{
+	size_t cursor_index = 0;
+	int horizontal_scroll = 0;
+public:
+	string text;
+	void (*callback)();
+	bool enabled;
+
+	TextInputBox(string _text, void (*_callback)(), bool _enabled) : text(_text), callback(_callback), enabled(_enabled) { }
+
+	GETTYPENAME_STUB("TextInputBox");
+
+	RENDER_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (size.y < 1) return;
+
+		cursor_index = min(cursor_index, text.length());
+		// the cursor is a byte index, but each UTF-8 character only takes up one cell
+		int cursor_column = 0;
+		for (size_t i = 0; i < cursor_index; i++) if (!isContinuationByte(text[i])) cursor_column++;
+		horizontal_scroll = max(0, (cursor_column - size.x) + 3);
+
+		drawText(scratchJoin({ "> ", text }), Coordinate{ -horizontal_scroll,0 }, Coordinate{ static_cast<int>(text.length()) + 2,1 }, output_buffer, size);
+		if (enabled) output_buffer[(cursor_column - horizontal_scroll) + 2].colour = focused ? getHighlightedColour() : getUnfocusedColour();
+	}
+#endif
+	;
+
+	FIXEDSIZE_STUB(6, 1, -1, 1);
+
+	HANDLEINPUT_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (!focused || !enabled) return false;
+		cursor_index = min(cursor_index, text.length());
+		if (input_character == '\n') { if (callback != nullptr) callback(); }
+		else if (input_character == Input::ArrowKeys::LEFT) cursor_index = previousCharacter(cursor_index);
+		else if (input_character == Input::ArrowKeys::RIGHT) cursor_index = nextCharacter(cursor_index);
+		else if (input_character == Input::ArrowKeys::UP) cursor_index = 0;
+		else if (input_character == Input::ArrowKeys::DOWN) cursor_index = text.length();
+		else if (input_character == '\b' || input_character == 127)
+		{
+			// a whole UTF-8 character is removed at once
+			size_t first = (input_character == '\b') ? previousCharacter(cursor_index) : cursor_index;
+			size_t last = (input_character == '\b') ? cursor_index : nextCharacter(cursor_index);
+			text.erase(first, last - first);
+			cursor_index = first;
+		}
+		else if (input_character == '\t') return false;
+		else
+		{
+			text.push_back(' ');
+			for (size_t first = text.length() - 1; first > cursor_index; first--)
+				text[first] = text[first - 1];
+			text[cursor_index] = input_character;
+			cursor_index++;
+		}
+
+		return true;
+	}
+#endif
+	;
+
+	HANDLETEXTINPUT_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (!focused || !enabled) return false;
+
+		// this is a single line, so line breaks and tabs become spaces (apart from any at the end),
+		// and other control characters are left out
+		while (!text.empty() && (text.back() == '\n' || text.back() == '\r')) text.remove_suffix(1);
+		string insertion;
+		insertion.reserve(text.length());
+		for (char c : text)
+		{
+			if (c == '\n' || c == '\r' || c == '\t') insertion += ' ';
+			else if (isKeptCharacter(c, "\b")) insertion += c;
+		}
+
+		cursor_index = min(cursor_index, this->text.length());
+		this->text.insert(cursor_index, insertion);
+		cursor_index += insertion.length();
+		return true;
+	}
+#endif
+	;
+
+	ISFOCUSABLE_STUB { return enabled; }
+
+private:
+	// byte index of the start of the UTF-8 character before `index`
+	inline size_t previousCharacter(size_t index) const
+	{
+		if (index == 0) return 0;
+		index--;
+		while (index > 0 && isContinuationByte(text[index])) index--;
+		return index;
+	}
+
+	// byte index of the start of the UTF-8 character after the one at `index`
+	inline size_t nextCharacter(size_t index) const
+	{
+		if (index >= text.length()) return text.length();
+		index++;
+		while (index < text.length() && isContinuationByte(text[index])) index++;
+		return index;
+	}
+};
+
+/**
+ * @brief multi-line wrapping text area. scrollable
+ * 
+ * the wrapped lines are kept in an index of where each one starts in `text`, which is only
+ * rebuilt when the width changes or the text is replaced. text added with `append` only
+ * re-wraps the last line. changing `text` directly (even just adding to the end of it)
+ * re-wraps everything, but is only noticed if its length changes, so any other edit must go
+ * through `setText`.
+ **/
+class TextArea : public Component, public Utility
+{
+	int last_rendered_height = 0;
+	int last_lines_of_text = 0;
+
+	struct WrappedLine
+	{
+		size_t start;
+		size_t length;
+	};
+
+	vector<WrappedLine> lines;		// index of wrapped lines into `text`
+	size_t indexed_length = 0;		// how much of `text` has been wrapped
+	size_t appended_length = 0;		// how much has been added with `append` since then
+	int indexed_width = -1;			// width the index was built for, or -1 if it needs rebuilding
+	string indexed_tail;			// the last few characters which were wrapped, to make sure they haven't changed
+public:
+	string text;
+	int scroll;
+
+	TextArea(string _text, int _scroll) : text(_text), scroll(_scroll) { }
+
+	GETTYPENAME_STUB("TextArea");
+
+	/**
+	 * @brief adds text to the end, without needing to re-wrap everything before it.
+	 **/
+	void append(const string& more)
+	{
+		text += more;
+		appended_length += more.length();
+	}
+
+	/**
+	 * @brief replaces the entire text, forcing it to be re-wrapped.
+	 **/
+	void setText(string new_text)
+	{
+		text = new_text;
+		indexed_width = -1;
+	}
+
+	/**
+	 * @brief returns the number of lines the text wrapped into when it was last drawn.
+	 **/
+	inline int getLineCount() const { return last_lines_of_text; }
+
+	RENDER_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (size.y < 2 || size.x < 2) return;
+
+		updateIndex(size.x - 1);
+		last_rendered_height = size.y;
+		last_lines_of_text = static_cast<int>(lines.size());
+		int max_scroll = max(0, last_lines_of_text - last_rendered_height);
+		scroll = max(0, min(scroll, max_scroll));
+		reportScroll(scroll);
+
+		// only the visible lines need to be looked at
+		for (int row = 0; row < size.y && scroll + row < last_lines_of_text; row++)
+		{
+			const WrappedLine& line = lines[static_cast<size_t>(scroll + row)];
+			Tixel* output_row = output_buffer + (row * size.x);
+			int col = 0;
+			for (size_t i = line.start; i < line.start + line.length; i++)
+			{
+				char c = text[i];
+				if (isContinuationByte(c)) { if (col > 0) output_row[col - 1].appendByte(c); continue; }
+				if (col >= size.x - 1) break;
+				if (c == '\t')
+				{
+					for (int j = 0; j < 4 && col < size.x - 1; j++) output_row[col++] = ' ';
+				}
+				else if (getCharacterWidth(c) > 0) output_row[col++] = c;
+			}
+		}
+		
+		int bar_position = max_scroll > 0 ? static_cast<int>(((float)scroll / (float)max_scroll) * (float)(last_rendered_height - 1)) : 0;
+		output_buffer[(max(0, bar_position) * size.x) + size.x - 1] = Tixel{ '|', focused ? getHighlightedColour() : getUnfocusedColour() };
+	}
+#endif
+	;
+
+	FIXEDSIZE_STUB(3, 3, -1, -1);
+
+	ISFOCUSABLE_STUB { return true; }
+
+	HANDLEINPUT_STUB
+	{
+		if (!focused) return false;
+
+		if (input_character == Input::ArrowKeys::UP)
+		{
+			if (scroll > 0) scroll--;
+		}
+		else if (input_character == Input::ArrowKeys::DOWN)
+		{
+			if (scroll < last_lines_of_text - last_rendered_height) scroll++;
+		}
+		else return false;
+
+		return true;
+	}
+
+private:
+	/**
+	 * @brief brings the line index up to date with `text` for the given width, re-wrapping
+	 * as little as possible.
+	 **/
+	void updateIndex(int width)
+#ifdef STUI_IMPLEMENTATION
+	{
+		// anything which didn't come through `append` could have changed text which is already wrapped
+		bool appended_only = indexed_width == width
+			&& text.length() == indexed_length + appended_length
+			&& text.compare(indexed_length - indexed_tail.length(), indexed_tail.length(), indexed_tail) == 0;
+		appended_length = 0;
+
+		if (!appended_only)
+		{
+			lines.clear();
+			indexed_length = 0;
+			indexed_width = width;
+			wrapFrom(0, width);
+		}
+		else if (text.length() != indexed_length)
+		{
+			// the last line may have been cut short by the end of the text, so start again from there
+			size_t resume_from = indexed_length;
+			if (!lines.empty() && text[indexed_length - 1] != '\n')
+			{
+				resume_from = lines.back().start;
+				lines.pop_back();
+			}
+			wrapFrom(resume_from, width);
+		}
+		else return;
+
+		indexed_length = text.length();
+		indexed_tail = text.substr(indexed_length - min(indexed_length, static_cast<size_t>(16)));
+	}
+#endif
+	;
+
+	/**
+	 * @brief wraps `text` from `start` to the end, adding lines to the index. lines are
+	 * broken after the last space which fits, or wherever they run out of room if there isn't
+	 * one. widths are measured with `getCharacterWidth`.
+	 **/
+	void wrapFrom(size_t start, int width)
+#ifdef STUI_IMPLEMENTATION
+	{
+		size_t line_start = start;
+		while (line_start < text.length())
+		{
+			size_t i = line_start;
+			size_t last_break = string::npos;
+			int columns = 0;
+			while (i < text.length() && text[i] != '\n')
+			{
+				char c = text[i];
+				int char_width = getCharacterWidth(c);
+				if (columns + char_width > width) break;
+				columns += char_width;
+				if (c == ' ' || c == '\t') last_break = i;
+				i++;
+			}
+
+			if (i == text.length() || text[i] == '\n')
+			{
+				// the rest of the line fits
+				lines.push_back(WrappedLine{ line_start, i - line_start });
+				line_start = i + 1;
+				continue;
+			}
+
+			if (last_break != string::npos) i = last_break + 1;
+			else if (i == line_start) i++;
+			lines.push_back(WrappedLine{ line_start, i - line_start });
+			line_start = i;
+		}
+	}
+#endif
+	;
+};
+
+/**
+ * @brief multi-line text box which can be edited, meant for documents too large to copy around
+ * on every key press, such as configuration files and logs.
+ * 
+ * the text is kept as a piece table: the text it was given is never changed, anything typed is
+ * added to the end of a second buffer, and the document is a list of pieces of those two buffers.
+ * the pieces are kept in a balanced tree which also counts the line breaks in each part of it, so
+ * inserting, deleting, moving the cursor and finding the lines on screen all take time which only
+ * grows with the logarithm of the size of the document. undoing or redoing an edit takes its
+ * pieces out of the tree or puts them back, so is just as cheap however much text it covers,
+ * and edits are never forgotten until `setText` is called. consecutive characters typed (or
+ * deleted) in one place are undone together.
+ * 
+ * lines aren't wrapped; instead the view scrolls sideways to follow the cursor. tabs take up
+ * four characters and other control characters take up none, as in `TextArea`.
+ * 
+ * the arrow keys move the cursor, and backspace and delete remove characters. ctrl+z undoes and
+ * ctrl+y redoes; since the `Renderer` only passes keys with control held to keymaps, these are
+ * bound in `editing_keys`, which the editor starts off using as its `keymap`. to add shortcuts of
+ * your own, bind them there too. the cursor is a byte offset into the text.
+ **/
+class TextEditor : public Component, public Utility
+{
+public:
+	size_t scroll = 0;			// index of the line at the top of the view
+	size_t column_scroll = 0;	// number of columns the view is scrolled sideways by
+	Keymap editing_keys;		// undo and redo, checked while the editor is focused
+
+	TextEditor(string _text)
+	{
+		setText(move(_text));
+		editing_keys.bind(Input::Key{ 'Z', Input::ControlKeys::CTRL }, [this]() { undo(); });
+		editing_keys.bind(Input::Key{ 'Y', Input::ControlKeys::CTRL }, [this]() { redo(); });
+		keymap = &editing_keys;
+	}
+
+	TextEditor(const TextEditor& other) = delete;
+	TextEditor& operator=(const TextEditor& other) = delete;
+
+	GETTYPENAME_STUB("TextEditor");
+
+	/**
+	 * @brief replaces the entire text, moving the cursor to the start and forgetting the
+	 * undo history.
+	 * 
+	 * @param text new text
+	 **/
+	void setText(string text)
+#ifdef STUI_IMPLEMENTATION
+	{
+		original = move(text);
+		added.clear();
+		original_breaks.clear();
+		added_breaks.clear();
+		for (size_t i = 0; i < original.length(); i++)
+			if (original[i] == '\n') original_breaks.push_back(i);
+		pieces.clear();
+		undo_stack.clear();
+		redo_stack.clear();
+		root = original.empty() ? nullptr : makePiece(false, 0, original.length());
+		cursor = 0;
+		preferred_column = string::npos;
+		follow_cursor = true;
+		last_edit_mergeable = false;
+		markDirty(false);
+	}
+#endif
+	;
+
+	/**
+	 * @brief get the entire text. this has to copy all of it, so avoid doing it every frame.
+	 * 
+	 * @returns the text
+	 **/
+	inline string getText() const { return getText(0, getLength()); }
+
+	/**
+	 * @brief get part of the text.
+	 * 
+	 * @param offset offset of the first byte to get
+	 * @param length number of bytes to get, which is cut short at the end of the text
+	 * 
+	 * @returns that part of the text
+	 **/
+	string getText(size_t offset, size_t length) const
+#ifdef STUI_IMPLEMENTATION
+	{
+		string result;
+		offset = min(offset, getLength());
+		length = min(length, getLength() - offset);
+		result.reserve(length);
+		readPieces(root, offset, length, result);
+		return result;
+	}
+#endif
+	;
+
+	inline size_t getLength() const { return totalLength(root); }
+	inline size_t getLineCount() const { return totalBreaks(root) + 1; }
+	inline size_t getCursor() const { return cursor; }
+
+	/**
+	 * @brief moves the cursor, scrolling the view to show it.
+	 * 
+	 * @param offset byte offset to move the cursor to, which is kept within the text
+	 **/
+	void setCursor(size_t offset)
+#ifdef STUI_IMPLEMENTATION
+	{
+		cursor = min(offset, getLength());
+		preferred_column = string::npos;
+		follow_cursor = true;
+		last_edit_mergeable = false;
+		markDirty(false);
+	}
+#endif
+	;
+
+	/**
+	 * @brief get the offset of the first byte of a line.
+	 * 
+	 * @param line index of the line, counted from 0
+	 * 
+	 * @returns offset of the line, or the length of the text if there aren't that many lines
+	 **/
+	size_t getLineStart(size_t line) const
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (line == 0) return 0;
+		// the line starts just after the `line`th line break
+		size_t breaks_left = line;
+		size_t offset = 0;
+		const Piece* p = root;
+		while (p != nullptr)
+		{
+			size_t left_breaks = totalBreaks(p->left);
+			if (breaks_left <= left_breaks) { p = p->left; continue; }
+			breaks_left -= left_breaks;
+			offset += totalLength(p->left);
+			if (breaks_left <= p->breaks)
+			{
+				const vector<size_t>& breaks = p->added ? added_breaks : original_breaks;
+				size_t first = static_cast<size_t>(lower_bound(breaks.begin(), breaks.end(), p->start) - breaks.begin());
+				return offset + (breaks[first + breaks_left - 1] - p->start) + 1;
+			}
+			breaks_left -= p->breaks;
+			offset += p->length;
+			p = p->right;
+		}
+		return getLength();
+	}
+#endif
+	;
+
+	/**
+	 * @brief get which line a byte is part of.
+	 * 
+	 * @param offset byte offset into the text
+	 * 
+	 * @returns index of the line, counted from 0
+	 **/
+	size_t getLineOf(size_t offset) const
+#ifdef STUI_IMPLEMENTATION
+	{
+		size_t line = 0;
+		const Piece* p = root;
+		while (p != nullptr)
+		{
+			size_t left_length = totalLength(p->left);
+			if (offset < left_length) { p = p->left; continue; }
+			line += totalBreaks(p->left);
+			offset -= left_length;
+			if (offset < p->length) return line + countBreaks(p->added, p->start, offset);
+			line += p->breaks;
+			offset -= p->length;
+			p = p->right;
+		}
+		return line;
+	}
+#endif
+	;
+
+	/**
+	 * @brief inserts text, as a single edit which can be undone.
+	 * 
+	 * @param offset byte offset to insert at, which is kept within the text
+	 * @param text text to insert
+	 **/
+	inline void insert(size_t offset, string_view text) { insertText(offset, text, false); }
+
+	/**
+	 * @brief removes part of the text, as a single edit which can be undone.
+	 * 
+	 * @param offset offset of the first byte to remove
+	 * @param length number of bytes to remove, which is cut short at the end of the text
+	 **/
+	inline void erase(size_t offset, size_t length) { eraseText(offset, length, false); }
+
+	/**
+	 * @brief undoes the most recent edit which hasn't been undone yet.
+	 * 
+	 * @returns false if there was nothing to undo
+	 **/
+	inline bool undo() { return swapEdit(undo_stack, redo_stack, true); }
+
+	/**
+	 * @brief redoes the most recently undone edit.
+	 * 
+	 * @returns false if there was nothing to redo
+	 **/
+	inline bool redo() { return swapEdit(redo_stack, undo_stack, false); }
+
+	inline bool canUndo() const { return !undo_stack.empty(); }
+	inline bool canRedo() const { return !redo_stack.empty(); }
+
+	RENDER_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (size.y < 2 || size.x < 2) return;
+		int text_width = size.x - 1;
+		size_t line_count = getLineCount();
+		size_t cursor_line = getLineOf(cursor);
+		size_t cursor_line_start = getLineStart(cursor_line);
+
+		// the cursor's column depends on the tabs before it on its line
+		line_text.clear();
+		readPieces(root, cursor_line_start, cursor - cursor_line_start, line_text);
+		size_t cursor_column = displayWidth(line_text);
+		if (follow_cursor)
+		{
+			if (cursor_line < scroll) scroll = cursor_line;
+			else if (cursor_line >= scroll + static_cast<size_t>(size.y)) scroll = cursor_line - static_cast<size_t>(size.y) + 1;
+			if (cursor_column < column_scroll) column_scroll = cursor_column;
+			else if (cursor_column >= column_scroll + static_cast<size_t>(text_width)) column_scroll = cursor_column - static_cast<size_t>(text_width) + 1;
+			follow_cursor = false;
+		}
+		size_t max_scroll = (line_count > static_cast<size_t>(size.y)) ? line_count - static_cast<size_t>(size.y) : 0;
+		scroll = min(scroll, max_scroll);
+		reportScroll(static_cast<long long>(scroll));
+
+		// only the visible part of each visible line is read
+		size_t line_start = getLineStart(scroll);
+		for (int row = 0; row < size.y && scroll + static_cast<size_t>(row) < line_count; row++)
+		{
+			size_t next_start = getLineStart(scroll + static_cast<size_t>(row) + 1);
+			size_t line_end = (scroll + static_cast<size_t>(row) + 1 < line_count) ? next_start - 1 : next_start;
+			line_text.clear();
+			readPieces(root, line_start, min(line_end - line_start, column_scroll + static_cast<size_t>(text_width)), line_text);
+
+			Tixel* output_row = output_buffer + (row * size.x);
+			size_t column = 0;
+			Tixel* last = nullptr;
+			for (char c : line_text)
+			{
+				// the rest of a multi-byte UTF-8 character goes into the same cell as its first byte
+				if (isContinuationByte(c)) { if (last != nullptr) last->appendByte(c); continue; }
+				if (column >= column_scroll + static_cast<size_t>(text_width)) break;
+				last = nullptr;
+				size_t char_width = static_cast<size_t>(getCharacterWidth(c));
+				for (size_t j = 0; j < char_width; j++, column++)
+				{
+					if (column < column_scroll) continue;
+					if (column - column_scroll >= static_cast<size_t>(text_width)) break;
+					last = &output_row[column - column_scroll];
+					*last = (c == '\t') ? ' ' : c;
+				}
+			}
+			line_start = next_start;
+		}
+
+		if (focused && cursor_line >= scroll && cursor_line < scroll + static_cast<size_t>(size.y) && cursor_column >= column_scroll)
+			fillColour(getHighlightedColour(), Coordinate{ static_cast<int>(cursor_column - column_scroll), static_cast<int>(cursor_line - scroll) }, Coordinate{ 1,1 }, output_buffer, size);
+
+		int bar_position = (max_scroll > 0) ? static_cast<int>((static_cast<float>(scroll) / static_cast<float>(max_scroll)) * static_cast<float>(size.y - 1)) : 0;
+		output_buffer[(max(0, bar_position) * size.x) + size.x - 1] = Tixel{ '|', focused ? getHighlightedColour() : getUnfocusedColour() };
+	}
+#endif
+	;
+
+	FIXEDSIZE_STUB(3, 3, -1, -1);
+
+	ISFOCUSABLE_STUB { return true; }
+
+	HANDLEINPUT_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (!focused) return false;
+		bool ctrl = (modifiers & Input::ControlKeys::CTRL) != 0;
+		if (input_character == Input::ArrowKeys::LEFT) { if (cursor > 0) setCursor(characterStart(cursor - 1)); }
+		else if (input_character == Input::ArrowKeys::RIGHT) { if (cursor < getLength()) setCursor(characterEnd(cursor)); }
+		else if (input_character == Input::ArrowKeys::UP || input_character == Input::ArrowKeys::DOWN)
+		{
+			size_t line = getLineOf(cursor);
+			if ((input_character == Input::ArrowKeys::UP) ? line == 0 : line + 1 >= getLineCount()) return true;
+			line = (input_character == Input::ArrowKeys::UP) ? line - 1 : line + 1;
+			size_t start = getLineStart(line);
+			size_t end = (line + 1 < getLineCount()) ? getLineStart(line + 1) - 1 : getLength();
+			size_t column = (preferred_column == string::npos) ? cursorColumn() : preferred_column;
+			setCursor(offsetAtColumn(start, end, column));
+			// moving up and down keeps to the same column, even past shorter lines
+			preferred_column = column;
+		}
+		else if (input_character == '\b') { if (cursor > 0) { size_t first = characterStart(cursor - 1); eraseText(first, cursor - first, true); } }
+		else if (input_character == 127) { if (cursor < getLength()) eraseText(cursor, characterEnd(cursor) - cursor, true); }
+		else if (input_character == '\t' || ctrl) return false;
+		else if (input_character == '\n' || input_character >= ' ')
+		{
+			char c = static_cast<char>(input_character);
+			insertText(cursor, string_view(&c, 1), true);
+		}
+		else return false;
+
+		return true;
+	}
+#endif
+	;
+
+	HANDLETEXTINPUT_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (!focused) return false;
+		string insertion;
+		insertion.reserve(text.length());
+		for (size_t i = 0; i < text.length(); i++)
+		{
+			// line endings become plain line breaks
+			if (text[i] == '\r') { if (i + 1 >= text.length() || text[i + 1] != '\n') insertion += '\n'; }
+			else if (text[i] == '\n' || isKeptCharacter(text[i], "\b")) insertion += text[i];
+		}
+		if (insertion.empty()) return false;
+		insertText(cursor, insertion, false);
+		return true;
+	}
+#endif
+	;
+
+private:
+	/**
+	 * @brief a run of text from one of the two buffers, and a node in the tree of pieces. the
+	 * tree is ordered by position in the document, and is a treap: each node's `priority` is
+	 * random, and never lower than its children's, which keeps it balanced.
+	 **/
+	struct Piece
+	{
+		Piece* left;
+		Piece* right;
+		uint32_t priority;
+		bool added;				// whether this is part of `added` rather than `original`
+		size_t start;			// offset of the text in its buffer
+		size_t length;
+		size_t breaks;			// number of line breaks in this piece
+		size_t total_length;	// length of the text in this piece and its children
+		size_t total_breaks;	// number of line breaks in this piece and its children
+	};
+
+	/**
+	 * @brief an edit which can be undone or redone. its text is either in the document, or
+	 * has been taken out and is held in `removed`. undoing or redoing swaps the two over.
+	 **/
+	struct Edit
+	{
+		size_t offset;
+		size_t length;
+		Piece* removed;
+		size_t cursor_before;	// where to put the cursor after undoing
+		size_t cursor_after;	// where to put the cursor after redoing
+	};
+
+	string original;				// text given to `setText`, which is never changed
+	string added;					// everything inserted since, in the order it was inserted
+	vector<size_t> original_breaks;	// offsets of every line break in `original`
+	vector<size_t> added_breaks;	// offsets of every line break in `added`
+	deque<Piece> pieces;			// storage for the tree, which only grows until `setText` is called
+	Piece* root = nullptr;
+	uint32_t random_state = 0x9E3779B9;
+
+	vector<Edit> undo_stack;
+	vector<Edit> redo_stack;
+	bool last_edit_mergeable = false;	// text typed next to the last edit should be undone along with it
+
+	size_t cursor = 0;
+	size_t preferred_column = string::npos;	// display column kept when moving between lines (npos until the cursor is moved up or down)
+	bool follow_cursor = true;			// scroll to show the cursor when next drawn
+	string line_text;					// scratch space for reading lines, kept to avoid allocating
+
+	static inline size_t totalLength(const Piece* p) { return (p == nullptr) ? 0 : p->total_length; }
+	static inline size_t totalBreaks(const Piece* p) { return (p == nullptr) ? 0 : p->total_breaks; }
+
+	static inline void updateTotals(Piece* p)
+	{
+		p->total_length = totalLength(p->left) + p->length + totalLength(p->right);
+		p->total_breaks = totalBreaks(p->left) + p->breaks + totalBreaks(p->right);
+	}
+
+	static size_t displayWidth(string_view text)
+#ifdef STUI_IMPLEMENTATION
+	{
+		size_t width = 0;
+		for (char c : text) width += static_cast<size_t>(getCharacterWidth(c));
+		return width;
+	}
+#endif
+	;
+
+	// offset of the first byte of the UTF-8 character which the byte at `offset` is part of
+	size_t characterStart(size_t offset)
+#ifdef STUI_IMPLEMENTATION
+	{
+		// a character has at most three bytes after its first one, so they're read all at once
+		size_t first = (offset > 3) ? offset - 3 : 0;
+		line_text.clear();
+		readPieces(root, first, offset + 1 - first, line_text);
+		while (offset > first && offset - first < line_text.length() && isContinuationByte(line_text[offset - first])) offset--;
+		return offset;
+	}
+#endif
+	;
+
+	// offset just past the end of the UTF-8 character which starts at `offset`
+	size_t characterEnd(size_t offset)
+#ifdef STUI_IMPLEMENTATION
+	{
+		size_t length = getLength();
+		if (offset >= length) return length;
+		line_text.clear();
+		readPieces(root, offset, min(static_cast<size_t>(4), length - offset), line_text);
+		size_t i = 1;
+		while (i < line_text.length() && isContinuationByte(line_text[i])) i++;
+		return offset + i;
+	}
+#endif
+	;
+
+	// display column of the cursor on its line, as it's drawn by `render`
+	size_t cursorColumn()
+#ifdef STUI_IMPLEMENTATION
+	{
+		size_t line_start = getLineStart(getLineOf(cursor));
+		line_text.clear();
+		readPieces(root, line_start, cursor - line_start, line_text);
+		return displayWidth(line_text);
+	}
+#endif
+	;
+
+	// offset of the character drawn at display column `column` of the line from `start` to `end`, or `end` if the line is shorter
+	size_t offsetAtColumn(size_t start, size_t end, size_t column)
+#ifdef STUI_IMPLEMENTATION
+	{
+		line_text.clear();
+		readPieces(root, start, end - start, line_text);
+		size_t i = 0;
+		size_t width = 0;
+		while (i < line_text.length())
+		{
+			size_t char_width = static_cast<size_t>(getCharacterWidth(line_text[i]));
+			if (width + char_width > column) break;
+			width += char_width;
+			for (i++; i < line_text.length() && isContinuationByte(line_text[i]); i++);
+		}
+		return start + i;
+	}
+#endif
+	;
+
+	/**
+	 * @brief counts the line breaks in part of one of the buffers, without looking at the text.
+	 **/
+	size_t countBreaks(bool in_added, size_t start, size_t length) const
+#ifdef STUI_IMPLEMENTATION
+	{
+		const vector<size_t>& breaks = in_added ? added_breaks : original_breaks;
+		return static_cast<size_t>(lower_bound(breaks.begin(), breaks.end(), start + length) - lower_bound(breaks.begin(), breaks.end(), start));
+	}
+#endif
+	;
+
+	Piece* makePiece(bool in_added, size_t start, size_t length)
+#ifdef STUI_IMPLEMENTATION
+	{
+		// xorshift, since the priorities only need to look random
+		random_state ^= random_state << 13;
+		random_state ^= random_state >> 17;
+		random_state ^= random_state << 5;
+		pieces.push_back(Piece{ nullptr, nullptr, random_state, in_added, start, length, countBreaks(in_added, start, length), 0, 0 });
+		updateTotals(&pieces.back());
+		return &pieces.back();
+	}
+#endif
+	;
+
+	Piece* mergePieces(Piece* first, Piece* second)
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (first == nullptr) return second;
+		if (second == nullptr) return first;
+		if (first->priority >= second->priority)
+		{
+			first->right = mergePieces(first->right, second);
+			updateTotals(first);
+			return first;
+		}
+		second->left = mergePieces(first, second->left);
+		updateTotals(second);
+		return second;
+	}
+#endif
+	;
+
+	/**
+	 * @brief splits a tree into the text before `offset` and the text after it, cutting a
+	 * piece in two if the offset lands inside it.
+	 **/
+	void splitPieces(Piece* p, size_t offset, Piece*& before, Piece*& after)
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (p == nullptr) { before = after = nullptr; return; }
+		size_t left_length = totalLength(p->left);
+		if (offset <= left_length)
+		{
+			splitPieces(p->left, offset, before, p->left);
+			updateTotals(p);
+			after = p;
+			return;
+		}
+		offset -= left_length;
+		if (offset < p->length)
+		{
+			Piece* rest = makePiece(p->added, p->start + offset, p->length - offset);
+			p->length = offset;
+			p->breaks -= rest->breaks;
+			after = mergePieces(rest, p->right);
+			p->right = nullptr;
+			updateTotals(p);
+			before = p;
+			return;
+		}
+		splitPieces(p->right, offset - p->length, p->right, after);
+		updateTotals(p);
+		before = p;
+	}
+#endif
+	;
+
+	void readPieces(const Piece* p, size_t offset, size_t length, string& output) const
+#ifdef STUI_IMPLEMENTATION
+	{
+		// only the parts of the tree which overlap the range are visited
+		while (p != nullptr && length > 0)
+		{
+			size_t left_length = totalLength(p->left);
+			if (offset < left_length)
+			{
+				size_t from_left = min(length, left_length - offset);
+				readPieces(p->left, offset, from_left, output);
+				offset += from_left;
+				length -= from_left;
+				if (length == 0) return;
+			}
+			offset -= left_length;
+			if (offset < p->length)
+			{
+				size_t from_here = min(length, p->length - offset);
+				output.append((p->added ? added : original), p->start + offset, from_here);
+				offset += from_here;
+				length -= from_here;
+			}
+			offset -= p->length;
+			p = p->right;
+		}
+	}
+#endif
+	;
+
+	void pushEdit(Edit edit, bool mergeable)
+#ifdef STUI_IMPLEMENTATION
+	{
+		redo_stack.clear();
+		undo_stack.push_back(edit);
+		last_edit_mergeable = mergeable;
+	}
+#endif
+	;
+
+	void insertText(size_t offset, string_view text, bool typed)
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (text.empty()) return;
+		offset = min(offset, getLength());
+		size_t start = added.length();
+		added.append(text.data(), text.length());
+		for (size_t i = 0; i < text.length(); i++)
+			if (text[i] == '\n') added_breaks.push_back(start + i);
+		size_t breaks = added_breaks.size() - countBreaks(true, 0, start);
+
+		Piece* before;
+		Piece* after;
+		splitPieces(root, offset, before, after);
+		Piece* last = before;
+		while (last != nullptr && last->right != nullptr) last = last->right;
+		if (last != nullptr && last->added && last->start + last->length == start)
+		{
+			// typing carries on from the last insertion, so its piece is just made longer
+			for (Piece* p = before; p != nullptr; p = p->right)
+			{
+				p->total_length += text.length();
+				p->total_breaks += breaks;
+			}
+			last->length += text.length();
+			last->breaks += breaks;
+		}
+		else before = mergePieces(before, makePiece(true, start, text.length()));
+		root = mergePieces(before, after);
+
+		Edit* previous = undo_stack.empty() ? nullptr : &undo_stack.back();
+		if (typed && last_edit_mergeable && previous->removed == nullptr && previous->offset + previous->length == offset)
+		{
+			previous->length += text.length();
+			previous->cursor_after = offset + text.length();
+			redo_stack.clear();
+		}
+		else pushEdit(Edit{ offset, text.length(), nullptr, cursor, offset + text.length() }, typed);
+
+		cursor = offset + text.length();
+		preferred_column = string::npos;
+		follow_cursor = true;
+		markDirty(false);
+	}
+#endif
+	;
+
+	void eraseText(size_t offset, size_t length, bool typed)
+#ifdef STUI_IMPLEMENTATION
+	{
+		offset = min(offset, getLength());
+		length = min(length, getLength() - offset);
+		if (length == 0) return;
+
+		Piece* before;
+		Piece* rest;
+		Piece* removed;
+		Piece* after;
+		splitPieces(root, offset, before, rest);
+		splitPieces(rest, length, removed, after);
+		root = mergePieces(before, after);
+
+		Edit* previous = undo_stack.empty() ? nullptr : &undo_stack.back();
+		bool mergeable = typed && last_edit_mergeable && previous->removed != nullptr;
+		if (mergeable && offset + length == previous->offset && previous->cursor_before == previous->offset + previous->length)
+		{
+			// backspacing over more text
+			previous->removed = mergePieces(removed, previous->removed);
+			previous->offset = offset;
+			previous->length += length;
+			previous->cursor_after = offset;
+			redo_stack.clear();
+		}
+		else if (mergeable && offset == previous->offset && previous->cursor_before == previous->offset)
+		{
+			// deleting forwards
+			previous->removed = mergePieces(previous->removed, removed);
+			previous->length += length;
+			redo_stack.clear();
+		}
+		else pushEdit(Edit{ offset, length, removed, cursor, offset }, typed);
+
+		cursor = offset;
+		preferred_column = string::npos;
+		follow_cursor = true;
+		markDirty(false);
+	}
+#endif
+	;
+
+	/**
+	 * @brief undoes or redoes an edit, by taking its text out of the document or putting it back.
+	 **/
+	bool swapEdit(vector<Edit>& from, vector<Edit>& to, bool undoing)
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (from.empty()) return false;
+		Edit edit = from.back();
+		from.pop_back();
+
+		Piece* before;
+		Piece* after;
+		if (edit.removed != nullptr)
+		{
+			splitPieces(root, edit.offset, before, after);
+			root = mergePieces(mergePieces(before, edit.removed), after);
+			edit.removed = nullptr;
+		}
+		else
+		{
+			Piece* rest;
+			splitPieces(root, edit.offset, before, rest);
+			splitPieces(rest, edit.length, edit.removed, after);
+			root = mergePieces(before, after);
+		}
+		to.push_back(edit);
+
+		cursor = min(undoing ? edit.cursor_before : edit.cursor_after, getLength());
+		preferred_column = string::npos;
+		follow_cursor = true;
+		last_edit_mergeable = false;
+		markDirty(false);
+		return true;
+	}
+#endif
+	;
+};
+
+/**
+ * @brief scrollable view of lines appended to the end of a log, such as the output of a
+ * long-running process.
+ * 
+ * lines are kept in a ring buffer, which doubles in size as needed up to `max_lines`, so
+ * adding a line takes constant time on average. once `max_lines` (or `max_bytes`, if it's
+ * non-zero) is reached, the oldest lines are thrown away to make room and memory use stays
+ * flat. text passed to `append` is split on newlines, and text after the last newline
+ * is continued by the next call. lines which don't fit the width are cut off rather than
+ * wrapped. while the view is scrolled to the bottom it follows new lines as they arrive;
+ * scrolling up stops this until the user scrolls back down. to feed it from another thread,
+ * post the calls to `append` through `Page::post`.
+ **/
+class LogView : public Component, public Utility
+{
+	vector<string> ring;			// line storage, the oldest line is at `head`
+	size_t head = 0;
+	size_t line_count = 0;
+	size_t byte_count = 0;
+	bool line_open = false;			// whether the last line is still waiting for its newline
+	int last_rendered_height = 0;
+	size_t first_line_index = 0;	// number of lines thrown away so far, so that lines keep their number as old ones go
+public:
+	size_t max_lines;
+	size_t max_bytes;
+	size_t scroll = 0;				// index of the line at the top of the view
+	bool follow_tail = true;		// keep the newest line in view as lines are added
+
+	LogView(size_t _max_lines = 10000, size_t _max_bytes = 0) : max_lines(max(_max_lines, static_cast<size_t>(1))), max_bytes(_max_bytes) { }
+
+	GETTYPENAME_STUB("LogView");
+
+	/**
+	 * @brief adds some text to the end of the log, starting a new line after each newline.
+	 **/
+	void append(const string& text)
+#ifdef STUI_IMPLEMENTATION
+	{
+		size_t start = 0;
+		while (start < text.length())
+		{
+			size_t end = text.find('\n', start);
+			size_t length = (end == string::npos ? text.length() : end) - start;
+			if (line_open)
+			{
+				string& last = lineAt(line_count - 1);
+				last.append(text, start, length);
+				byte_count += length;
+			}
+			else pushLine(text.substr(start, length));
+			line_open = (end == string::npos);
+			if (end == string::npos) break;
+			start = end + 1;
+		}
+		trimToFit();
+	}
+#endif
+	;
+
+	/**
+	 * @brief adds a complete line to the end of the log, finishing off any line which was
+	 * still open.
+	 **/
+	void appendLine(const string& line)
+#ifdef STUI_IMPLEMENTATION
+	{
+		line_open = false;
+		append(line + '\n');
+	}
+#endif
+	;
+
+	/**
+	 * @brief removes every line from the log.
+	 **/
+	void clear()
+#ifdef STUI_IMPLEMENTATION
+	{
+		ring.clear();
+		head = 0;
+		line_count = 0;
+		byte_count = 0;
+		line_open = false;
+		scroll = 0;
+		follow_tail = true;
+		first_line_index = 0;
+	}
+#endif
+	;
+
+	inline size_t getLineCount() const { return line_count; }
+	inline size_t getByteCount() const { return byte_count; }
+
+	/**
+	 * @brief returns one of the lines in the log, where 0 is the oldest line still stored.
+	 **/
+	inline const string& getLine(size_t index) const { return ring[(head + index) % ring.size()]; }
+
+	RENDER_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (size.y < 2 || size.x < 2) return;
+
+		last_rendered_height = size.y;
+		size_t max_scroll = getMaxScroll();
+		if (follow_tail || scroll > max_scroll) scroll = max_scroll;
+		reportScroll(static_cast<long long>(scroll) + static_cast<long long>(first_line_index));
+
+		for (int row = 0; row < size.y && scroll + row < line_count; row++)
+			drawText(scratchStrip(getLine(scroll + row), "\n"), Coordinate{ 0, row }, Coordinate{ size.x - 1, 1 }, output_buffer, size);
+
+		int bar_position = max_scroll > 0 ? static_cast<int>(((float)scroll / (float)max_scroll) * (float)(last_rendered_height - 1)) : 0;
+		output_buffer[(bar_position * size.x) + size.x - 1] = Tixel{ '|', focused ? getHighlightedColour() : getUnfocusedColour() };
+	}
+#endif
+	;
+
+	FIXEDSIZE_STUB(3, 3, -1, -1);
+
+	ISFOCUSABLE_STUB { return true; }
+
+	HANDLEINPUT_STUB
+	{
+		if (!focused) return false;
+
+		if (input_character == Input::ArrowKeys::UP)
+		{
+			if (scroll > 0) scroll--;
+		}
+		else if (input_character == Input::ArrowKeys::DOWN)
+		{
+			if (scroll < getMaxScroll()) scroll++;
+		}
+		else return false;
+
+		follow_tail = scroll >= getMaxScroll();
+		return true;
+	}
+
+private:
+	inline size_t getMaxScroll() const { return line_count > static_cast<size_t>(last_rendered_height) ? line_count - last_rendered_height : 0; }
+
+	inline string& lineAt(size_t index) { return ring[(head + index) % ring.size()]; }
+
+	/**
+	 * @brief adds a new line to the end of the ring, growing it if it's full and still under
+	 * `max_lines`, or otherwise overwriting the oldest line.
+	 **/
+	void pushLine(string line)
+#ifdef STUI_IMPLEMENTATION
+	{
+		byte_count += line.length();
+		if (line_count == ring.size() && ring.size() < max_lines)
+		{
+			// still room to grow, so the ring is doubled (up to `max_lines`) rather than grown by
+			// one line, which keeps the cost of moving the lines across to once per doubling
+			vector<string> grown(min(max_lines, max(ring.size() * 2, static_cast<size_t>(16))));
+			for (size_t i = 0; i < line_count; i++) grown[i] = move(lineAt(i));
+			ring.swap(grown);
+			head = 0;
+		}
+		if (line_count == ring.size()) dropOldest();
+		lineAt(line_count) = move(line);
+		line_count++;
+	}
+#endif
+	;
+
+	/**
+	 * @brief throws away the oldest line, keeping the view on the same lines if the user has
+	 * scrolled away from the bottom.
+	 **/
+	void dropOldest()
+#ifdef STUI_IMPLEMENTATION
+	{
+		string& oldest = lineAt(0);
+		byte_count -= oldest.length();
+		string().swap(oldest);
+		head = (head + 1) % ring.size();
+		line_count--;
+		first_line_index++;
+		if (scroll > 0) scroll--;
+	}
+#endif
+	;
+
+	/**
+	 * @brief drops the oldest lines until the log is within `max_lines` and `max_bytes`.
+	 **/
+	void trimToFit()
+#ifdef STUI_IMPLEMENTATION
+	{
+		while (line_count > 1 && (line_count > max_lines || (max_bytes > 0 && byte_count > max_bytes)))
+			dropOldest();
+	}
+#endif
+	;
+};
+
+/**
+ * @brief linear progress bar.
+ * 
+ * progress is expressed as a `fraction` between 0 and 1.
+ **/
+class ProgressBar : public Component
+{
+	size_t animation = 0;	// `Animator` timer which keeps `fraction` up to date, if there is one
+public:
+	float fraction;
+	
+	ProgressBar(float _fraction) : fraction(_fraction) { }
+
+	GETTYPENAME_STUB("ProgressBar");
+
+	/**
+	 * @brief keeps `fraction` up to date by itself, by checking a function every so often
+	 * (see `Animator`). the bar is only redrawn when the fraction actually changes.
+	 * 
+	 * @param get_fraction function which returns the current progress, or null to stop checking
+	 * @param interval_seconds time between checks
+	 **/
+	void animate(function<float()> get_fraction, float interval_seconds = 0.1f)
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (animation != 0) Animator::stop(animation);
+		animation = 0;
+		if (!get_fraction) return;
+		animation = Animator::start(this, interval_seconds, [this, get_fraction]()
+			{
+				float next = get_fraction();
+				if (next == fraction) return false;
+				fraction = next;
+				return true;
+			});
+	}
+#endif
+	;
+
+	RENDER_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (size.y < 1) return;
+
+		int completed = (int)round((float)size.x * fraction);
+			
+		for (int i = 0; i < size.x; i++)
+			output_buffer[i] = i < completed ? UNICODE_BLOCK : UNICODE_LIGHT_SHADE;
+	}
+#endif
+	;
+
+	FIXEDSIZE_STUB(1, 1, -1, 1);
+};
+
+/**
+ * @brief user-interactible slider widget.
+ **/
+class Slider : public Component, public Utility
+{
+public:
+	float value;
+
+	Slider(float _value) : value(_value) { }
+
+	GETTYPENAME_STUB("Slider");
+
+	RENDER_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (size.x < 3 || size.y < 1) return;
+
+		output_buffer[0] = '[';
+		output_buffer[size.x - 1] = ']';
+		for (int x = 1; x < size.x - 1; x++)
+			output_buffer[x] = '-';
+		output_buffer[(int)round(value * (size.x - 2.0f)) + 1].colour = focused ? getHighlightedColour() : getUnfocusedColour();
+	}
+#endif
+	;
+
+	FIXEDSIZE_STUB(5, 1, -1, 1);
+
+	ISFOCUSABLE_STUB { return true; }
+
+	HANDLEINPUT_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (!focused) return false;
+		float difference = 0.0;
+		if (input_character == Input::ArrowKeys::LEFT) difference = -0.01f;
+		if (input_character == Input::ArrowKeys::RIGHT) difference = 0.01f;
+		if (modifiers & Input::ControlKeys::SHIFT) difference *= 5.0f;
+		value = max(0.0f, min(value + difference, 1.0f));
+		return true;
+	}
+#endif
+	;
+};
+
+/**
+ * @brief simple activity spinner.
+ * 
+ * described by its `state` (effectively the current animation frame index), and its `type`
+ * (style setting between 0 and 3 inclusive).
+ **/
+class Spinner : public Component
+{
+	static constexpr int types = 4;
+	static constexpr uint32_t sequences[types][4]
+	{
+		{ '|', '/', '-', '\\' },
+		{ UNICODE_QUADRANT_LOWERLEFT, UNICODE_QUADRANT_TOPLEFT, UNICODE_QUADRANT_TOPRIGHT, UNICODE_QUADRANT_LOWERRIGHT },
+		{ UNICODE_BOXLIGHT_UP, UNICODE_BOXLIGHT_UPRIGHT, UNICODE_BOXLIGHT_UPRIGHTDOWN, UNICODE_BOXLIGHT_UPRIGHTDOWNLEFT },
+		{ UNICODE_BLOCK_1_8, UNICODE_BLOCK_3_8, UNICODE_BLOCK_6_8, UNICODE_BLOCK }
+	};
+	size_t animation = 0;	// `Animator` timer which moves the spinner on, if it's animating
+public:
+	size_t state;
+	int type;
+
+	Spinner(size_t _state, int _type) : state(_state), type(_type) { }
+
+	GETTYPENAME_STUB("Spinner");
+
+	/**
+	 * @brief makes the spinner move on by itself, without the rest of the interface needing
+	 * to be redrawn at a fixed rate (see `Animator`).
+	 * 
+	 * @param interval_seconds time between steps, or zero or less to stop it
+	 **/
+	void animate(float interval_seconds = 0.1f)
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (animation != 0) Animator::stop(animation);
+		animation = 0;
+		if (interval_seconds > 0.0f)
+			animation = Animator::start(this, interval_seconds, [this]() { state++; return true; });
+	}
+#endif
+	;
+
+	RENDER_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		output_buffer[0] = sequences[type % types][state % 4];
+	}
+#endif
+	;
+
+	FIXEDSIZE_STUB(1, 1, 1, 1);
+};
+
+/**
+ * @brief describes how a `VerticalBox` or `HorizontalBox` should size one of its children
+ * along the direction the box is laid out in.
+ * 
+ * - `FLEX` grows the child from its minimum size towards its maximum size, taking `value` shares
+ * of the leftover space (so a child with a weight of 2 grows twice as fast as one with a weight of 1,
+ * and a weight of 0 keeps the child at its minimum size)
+ * - `FIXED` makes the child exactly `value` cells long
+ * - `PERCENTAGE` makes the child `value` percent of the length of the box
+ * 
+ * children are never made smaller than their minimum size.
+ **/
+struct BoxSizing
+{
+	enum Mode : uint8_t
+	{
+		FLEX,
+		FIXED,
+		PERCENTAGE
+	};
+
+	Mode mode;
+	int value;
+
+	constexpr BoxSizing(Mode _mode = FLEX, int _value = 1) : mode(_mode), value(_value) { }
+
+	/**
+	 * @brief applies this sizing to a child's minimum and maximum length.
+	 * 
+	 * @param length length of the box, or -1 if not yet known
+	 * @param min_length minimum length of the child, modified in place
+	 * @param max_length maximum length of the child (-1 for no maximum), modified in place
+	 * 
+	 * @returns the weight the child should grow with
+	 **/
+	constexpr int apply(int length, int& min_length, int& max_length) const
+	{
+		switch (mode)
+		{
+		case FIXED: max_length = min_length = max(min_length, value); return 0;
+		case PERCENTAGE:
+			if (length < 0) { max_length = -1; return 0; }
+			max_length = min_length = max(min_length, static_cast<int>((static_cast<long long>(length) * value) / 100));
+			return 0;
+		default: return max(value, 0);
+		}
+	}
+};
+
+/**
+ * @brief lists used by `VerticalBox` and `HorizontalBox` while laying out their children. they're
+ * kept between layout passes so that laying out doesn't need to allocate.
+ **/
+struct BoxLayoutScratch
+{
+	vector<int> min_sizes;
+	vector<int> max_sizes;
+	vector<int> weights;
+	vector<int> sizes;
+};
+
+/**
+ * @brief vertical layout box containing a list of child widgets.
+ * 
+ * the layout algorithm will attempt to meet the minimum sizes of all children first, then
+ * share out the remaining space between them according to their `sizing` (by default, evenly)
+ * until they either meet their max height or there's no more space to expand into. ensures
+ * minimum widths for all elements.
+ * 
+ * `sizing` may be shorter than `children`, in which case the rest of the children use the
+ * default `BoxSizing`. call `markDirty` after changing it.
+ **/
+class VerticalBox : public Component, public Utility
+{
+public:
+	vector<Component*> children;
+	vector<BoxSizing> sizing;
+	
+	VerticalBox(vector<Component*> _children, vector<BoxSizing> _sizing = { }) : children(_children), sizing(_sizing) { }
+	
+	GETTYPENAME_STUB("VerticalBox");
+
+	RENDER_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		render(BufferView(output_buffer, size));
+	}
+#endif
+	;
+
+	LAYOUT_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		vector<int>& min_heights = layout_scratch.min_sizes;
+		vector<int>& max_heights = layout_scratch.max_sizes;
+		vector<int>& weights = layout_scratch.weights;
+		vector<int>& calculated_heights = layout_scratch.sizes;
+		min_heights.resize(children.size());
+		max_heights.resize(children.size());
+		weights.resize(children.size());
+		for (size_t i = 0; i < children.size(); i++)
+		{
+			min_heights[i] = children[i]->getLayoutMinSize().y;
+			max_heights[i] = children[i]->getLayoutMaxSize().y;
+			weights[i] = getSizing(i).apply(size.y, min_heights[i], max_heights[i]);
+		}
+
+		overflowed = !distributeSpace(size.y, min_heights, max_heights, weights, calculated_heights);
+		if (overflowed) return;
+
+		int y_offset = 0;
+		for (size_t i = 0; i < children.size(); i++)
+		{
+			int max_width = children[i]->getLayoutMaxSize().x;
+			Coordinate component_size{ max_width == -1 ? size.x : min(size.x, max_width), calculated_heights[i] };
+			placeChild(children[i], Coordinate{ 0,y_offset }, component_size);
+			y_offset += component_size.y;
+		}
+	}
+#endif
+	;
+
+	RENDERVIEW_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (!target.isValid()) return;
+		Coordinate size = target.size;
+		ensureLayout(size);
+
+		if (overflowed)
+		{
+			target.fill(getBlankTixel());
+			string_view error_text = "[...]";
+			if (size.y > 0)
+				drawText(error_text, Coordinate{ static_cast<int>(size.x - error_text.size()) / 2, static_cast<int>(size.y) / 2 }, Coordinate{ size.x, 1 }, target);
+			return;
+		}
+
+		renderChildren(target);
+		int y_offset = 0;
+		for (const Placement& p : getPlacements())
+		{
+			// children don't necessarily cover the whole area, so clear whatever is left over
+			target.subView(Coordinate{ p.size.x,p.offset.y }, Coordinate{ size.x - p.size.x,p.size.y }).fill(getBlankTixel());
+			y_offset = p.offset.y + p.size.y;
+		}
+		target.subView(Coordinate{ 0,y_offset }, Coordinate{ size.x,size.y - y_offset }).fill(getBlankTixel());
+	}
+#endif
+	;
+
+	GETMAXSIZE_STUB
+	{
+		Coordinate max_size{ 0,0 };
+		for (size_t i = 0; i < children.size(); i++)
+		{
+			Coordinate c_max = children[i]->getLayoutMaxSize();
+			int c_min_y = children[i]->getLayoutMinSize().y;
+			getSizing(i).apply(-1, c_min_y, c_max.y);
+			if (max_size.x != -1 && (c_max.x > max_size.x || c_max.x == -1))
+				max_size.x = c_max.x;
+
+			if (c_max.y == -1) max_size.y = -1;
+			else if (max_size.y != -1)
+				max_size.y += c_max.y;
+		}
+
+		return max_size;
+	}
+
+	GETMINSIZE_STUB
+	{
+		Coordinate min_size{ 0,0 };
+		for (size_t i = 0; i < children.size(); i++)
+		{
+			Coordinate c_min = children[i]->getLayoutMinSize();
+			int c_max_y = children[i]->getLayoutMaxSize().y;
+			getSizing(i).apply(-1, c_min.y, c_max_y);
+			if (c_min.x > min_size.x)
+				min_size.x = c_min.x;
+
+			min_size.y += c_min.y;
+		}
+
+		return min_size;
+	}
+
+	GETALLCHILDREN_STUB { return children; }
+	GETCHILDCOUNT_STUB { return children.size(); }
+	GETCHILD_STUB { return (index < children.size()) ? children[index] : nullptr; }
+
+	/**
+	 * @brief replaces all of the children. unlike changing `children` directly, this tells
+	 * any `Page` the box belongs to about the change, so only the children which actually
+	 * changed are registered or unregistered.
+	 * 
+	 * @param _children new list of children
+	 **/
+	inline void setChildren(vector<Component*> _children)
+	{
+		vector<Component*> old_children = move(children);
+		children = move(_children);
+		for (Component* c : children) attachChild(c);
+		for (Component* c : old_children) detachChild(c);
+	}
+
+	/**
+	 * @brief adds a child to the end of the box (see `setChildren`).
+	 * 
+	 * @param child new child
+	 **/
+	inline void addChild(Component* child) { children.push_back(child); attachChild(child); }
+
+	/**
+	 * @brief removes the first occurrence of a child from the box (see `setChildren`).
+	 * 
+	 * @param child child to remove
+	 * 
+	 * @returns true if the child was found
+	 **/
+	inline bool removeChild(Component* child)
+	{
+		auto it = find(children.begin(), children.end(), child);
+		if (it == children.end()) return false;
+		children.erase(it);
+		detachChild(child);
+		return true;
+	}
+
+private:
+	bool overflowed = false;	// the children didn't fit during the last layout pass
+	BoxLayoutScratch layout_scratch;
+
+	inline BoxSizing getSizing(size_t index) const { return (index < sizing.size()) ? sizing[index] : BoxSizing(); }
+};
+
+/**
+ * @brief horizontal layout box containing a list of child widgets.
+ * 
+ * the layout algorithm will attempt ot meet the minimum sizes of all children first, then
+ * share out the remaining space between them according to their `sizing` (by default, evenly)
+ * until they either meet their max width or there's no more space to expand into. ensures
+ * minimum heights for all elements.
+ * 
+ * `sizing` may be shorter than `children`, in which case the rest of the children use the
+ * default `BoxSizing`. call `markDirty` after changing it.
+ **/
+class HorizontalBox : public Component, public Utility
+{
+public:
+	vector<Component*> children;
+	vector<BoxSizing> sizing;
+	
+	HorizontalBox(vector<Component*> _children, vector<BoxSizing> _sizing = { }) : children(_children), sizing(_sizing) { }
+
+	GETTYPENAME_STUB("HorizontalBox");
+
+	RENDER_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		render(BufferView(output_buffer, size));
+	}
+#endif
+	;
+
+	LAYOUT_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		vector<int>& min_widths = layout_scratch.min_sizes;
+		vector<int>& max_widths = layout_scratch.max_sizes;
+		vector<int>& weights = layout_scratch.weights;
+		vector<int>& calculated_widths = layout_scratch.sizes;
+		min_widths.resize(children.size());
+		max_widths.resize(children.size());
+		weights.resize(children.size());
+		for (size_t i = 0; i < children.size(); i++)
+		{
+			min_widths[i] = children[i]->getLayoutMinSize().x;
+			max_widths[i] = children[i]->getLayoutMaxSize().x;
+			weights[i] = getSizing(i).apply(size.x, min_widths[i], max_widths[i]);
+		}
+
+		if (!distributeSpace(size.x, min_widths, max_widths, weights, calculated_widths)) return;
+
+		int x_offset = 0;
+		for (size_t i = 0; i < children.size(); i++)
+		{
+			int max_height = children[i]->getLayoutMaxSize().y;
+			Coordinate component_size{ calculated_widths[i], max_height == -1 ? size.y : min(size.y, max_height) };
+			placeChild(children[i], Coordinate{ x_offset,0 }, component_size);
+			x_offset += component_size.x;
+		}
+	}
+#endif
+	;
+
+	RENDERVIEW_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (!target.isValid()) return;
+		Coordinate size = target.size;
+		ensureLayout(size);
+
+		// if the children didn't fit, nothing will have been placed and this just clears the area
+		renderChildren(target);
+		int x_offset = 0;
+		for (const Placement& p : getPlacements())
+		{
+			// children don't necessarily cover the whole area, so clear whatever is left over
+			target.subView(Coordinate{ p.offset.x,p.size.y }, Coordinate{ p.size.x,size.y - p.size.y }).fill(getBlankTixel());
+			x_offset = p.offset.x + p.size.x;
+		}
+		target.subView(Coordinate{ x_offset,0 }, Coordinate{ size.x - x_offset,size.y }).fill(getBlankTixel());
+	}
+#endif
+	;
+
+	GETMAXSIZE_STUB
+	{
+		Coordinate max_size{ 0,0 };
+		for (size_t i = 0; i < children.size(); i++)
+		{
+			Coordinate c_max = children[i]->getLayoutMaxSize();
+			int c_min_x = children[i]->getLayoutMinSize().x;
+			getSizing(i).apply(-1, c_min_x, c_max.x);
+			if (c_max.x == -1) max_size.x = -1;
+			else if (max_size.x != -1)
+				max_size.x += c_max.x;
+
+			if (max_size.y != -1 && (c_max.y > max_size.y || c_max.y == -1))
+				max_size.y = c_max.y;
+		}
+
+		return max_size;
+	}
+
+	GETMINSIZE_STUB
+	{
+		Coordinate min_size{ 0,0 };
+		for (size_t i = 0; i < children.size(); i++)
+		{
+			Coordinate c_min = children[i]->getLayoutMinSize();
+			int c_max_x = children[i]->getLayoutMaxSize().x;
+			getSizing(i).apply(-1, c_min.x, c_max_x);
+			min_size.x += c_min.x;
+
+			if (c_min.y > min_size.y)
+				min_size.y = c_min.y;
+		}
+
+		return min_size;
+	}
+
+	GETALLCHILDREN_STUB { return children; }
+	GETCHILDCOUNT_STUB { return children.size(); }
+	GETCHILD_STUB { return (index < children.size()) ? children[index] : nullptr; }
+
+	/**
+	 * @brief replaces all of the children. unlike changing `children` directly, this tells
+	 * any `Page` the box belongs to about the change, so only the children which actually
+	 * changed are registered or unregistered.
+	 * 
+	 * @param _children new list of children
+	 **/
+	inline void setChildren(vector<Component*> _children)
+	{
+		vector<Component*> old_children = move(children);
+		children = move(_children);
+		for (Component* c : children) attachChild(c);
+		for (Component* c : old_children) detachChild(c);
+	}
+
+	/**
+	 * @brief adds a child to the end of the box (see `setChildren`).
+	 * 
+	 * @param child new child
+	 **/
+	inline void addChild(Component* child) { children.push_back(child); attachChild(child); }
+
+	/**
+	 * @brief removes the first occurrence of a child from the box (see `setChildren`).
+	 * 
+	 * @param child child to remove
+	 * 
+	 * @returns true if the child was found
+	 **/
+	inline bool removeChild(Component* child)
+	{
+		auto it = find(children.begin(), children.end(), child);
+		if (it == children.end()) return false;
+		children.erase(it);
+		detachChild(child);
+		return true;
+	}
+
+private:
+	BoxLayoutScratch layout_scratch;
+
+	inline BoxSizing getSizing(size_t index) const { return (index < sizing.size()) ? sizing[index] : BoxSizing(); }
+};
+
+/**
+ * @brief blank spacing element which fills a set amount of space vertically.
+ **/
+class VerticalSpacer : public Component
+{
+public:
+	int height;
+	
+	VerticalSpacer(int _height) : height(_height) { }
+
+	GETTYPENAME_STUB("VerticalSpacer");
+
+	GETMAXSIZE_STUB { return Coordinate{ 1, height }; }
+	GETMINSIZE_STUB { return Coordinate{ 1, max(height, 0) }; }
+};
+
+/**
+ * @brief blank spacing element which fills a set amount of space horizontally.
+ **/
+class HorizontalSpacer : public Component
+{
+public:
+	int width;
+	
+	HorizontalSpacer(int _width) : width(_width) { }
+
+	GETTYPENAME_STUB("HorizontalSpacer");
+
+	GETMAXSIZE_STUB { return Coordinate{ width, 1 }; }
+	GETMINSIZE_STUB { return Coordinate{ max(width, 0), 1 }; }
+};
+
+/**
+ * @brief draws a border around another component using IBM box characters.
+ **/
+class BorderedBox : public Component, public Utility
+{
+public:
+	Component* child;
+	string name;
+
+	BorderedBox(Component* _child, string _name) : child(_child), name(_name) { }
+
+	GETTYPENAME_STUB("BorderedBox");
+
+	RENDER_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		render(BufferView(output_buffer, size));
+	}
+#endif
+	;
+
+	RENDERVIEW_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (!target.isValid()) return;
+		Coordinate size = target.size;
+		if (size.x < 3 || size.y < 3) { target.fill(getBlankTixel()); return; }
+		drawBox(Coordinate{ 0,0 }, size, target);
+		if (name.size() > 0)
+			drawText(name, Coordinate{ 3,0 }, Coordinate{ size.x - 6,1 }, target);
+
+		ensureLayout(size);
+		if (getPlacements().empty()) { target.subView(Coordinate{ 1,1 }, Coordinate{ size.x - 2, size.y - 2 }).fill(getBlankTixel()); return; }
+		const Placement& p = getPlacements()[0];
+		renderChild(p.child, target.subView(p.offset, p.size));
+	}
+#endif
+	;
+
+	LAYOUT_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (size.x < 3 || size.y < 3) return;
+		placeChild(child, Coordinate{ 1,1 }, Coordinate{ size.x - 2, size.y - 2 });
+	}
+#endif
+	;
+
+	GETMAXSIZE_STUB
+	{
+		if (child == nullptr) return Coordinate{ 2,2 };
+		Coordinate max_size = child->getLayoutMaxSize();
+		if (max_size.x != -1) max_size.x += 2;
+		if (max_size.y != -1) max_size.y += 2;
+		return max_size;
+	}
+	GETMINSIZE_STUB { return (child == nullptr) ? Coordinate{ 2,2 } : Coordinate{ child->getLayoutMinSize().x + 2, child->getLayoutMinSize().y + 2 }; }
+
+	GETALLCHILDREN_STUB { return (child == nullptr) ? vector<Component*>{ } : vector<Component*>{ child }; }
+	GETCHILDCOUNT_STUB { return (child == nullptr) ? 0 : 1; }
+	GETCHILD_STUB { return (index == 0) ? child : nullptr; }
+
+	/**
+	 * @brief replaces the child. unlike changing `child` directly, this tells any `Page`
+	 * the box belongs to about the change.
+	 * 
+	 * @param _child new child. may be null
+	 **/
+	inline void setChild(Component* _child)
+	{
+		if (_child == child) return;
+		Component* old_child = child;
+		child = _child;
+		attachChild(child);
+		detachChild(old_child);
+	}
+};
+
+/**
+ * @brief element which displays a list of strings.
+ * 
+ * allows scrolling.
+ * 
+ * the items can either be stored in `elements`, or for very long lists, provided on demand
+ * by a pair of callbacks: `item_count` returns the number of items, and `get_item` returns
+ * the text of a single item. only the rows which are actually visible are ever fetched, so
+ * drawing and scrolling cost the same however long the list is. `draw_item` can optionally
+ * be set to draw each visible row yourself.
+ **/
+class ListView : public Component, public Utility
+{
+	int last_render_height = 0;
+
+public:
+	vector<string> elements;
+	int scroll;
+	int selected_index;
+
+	function<size_t()> item_count;					// if set, used instead of `elements`
+	function<string(size_t)> get_item;				// fetches the text of an item, if `item_count` is set
+	function<void(size_t, BufferView)> draw_item;	// if set, draws an item into its row instead of the default
+
+	ListView(vector<string> _elements, int _scroll, int _selected_index) : elements(_elements), scroll(_scroll), selected_index(_selected_index) { }
+	ListView(function<size_t()> _item_count, function<string(size_t)> _get_item, int _scroll, int _selected_index) : scroll(_scroll), selected_index(_selected_index), item_count(_item_count), get_item(_get_item) { }
+
+	GETTYPENAME_STUB("ListView");
+
+	/**
+	 * @brief get the number of items in the list, from either `elements` or `item_count`.
+	 * 
+	 * @returns number of items
+	 **/
+	inline int getItemCount() const { return static_cast<int>(item_count ? item_count() : elements.size()); }
+
+	RENDER_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (size.x < 2 || size.y < 2) return;
+		last_render_height = size.y;
+		int count = getItemCount();
+		selected_index = max(min(selected_index, count - 1), 0);
+		reportScroll(scroll);
+		BufferView view(output_buffer, size);
+		for (int row = max(0, -scroll); row < size.y; row++)
+		{
+			int index = scroll + row;
+			if (index >= count) break;
+
+			if ((row == 0 && index != 0) || (row == size.y - 1 && index != count - 1))
+				view.at(0, row) = UNICODE_ELLIPSIS_VERTICAL;
+			else if (draw_item)
+				draw_item(static_cast<size_t>(index), view.subView(Coordinate{ 0, row }, Coordinate{ size.x, 1 }));
+			else
+			{
+				if (item_count) drawText(scratchStrip(get_item(static_cast<size_t>(index)), "\n\t"), Coordinate{ 0, row }, Coordinate{ size.x, 1 }, view);
+				else drawText(scratchStrip(elements[static_cast<size_t>(index)], "\n\t"), Coordinate{ 0, row }, Coordinate{ size.x, 1 }, view);
+				string_view index_str = scratchFormat(" (%d)", index);
+				drawText(index_str, Coordinate{ size.x - static_cast<int>(index_str.length()), row }, Coordinate{ size.x, 1 }, view);
+			}
+		}
+		
+		fillColour(focused ? getHighlightedColour() : getUnfocusedColour(), Coordinate{ 0, selected_index - scroll }, Coordinate{ size.x,1 }, view);
+	}
+#endif
+	;
+
+	FIXEDSIZE_STUB(10, 3, -1, -1);
+
+	ISFOCUSABLE_STUB { return true; }
+
+	HANDLEINPUT_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		int count = getItemCount();
+		if (input_character == Input::ArrowKeys::DOWN && selected_index < count - 1)
+		{
+			selected_index++;
+			if (selected_index - scroll >= last_render_height - 1 && (count - scroll > last_render_height))
+				scroll++;
+		}
+		else if (input_character == Input::ArrowKeys::UP && selected_index > 0)
+		{
+			selected_index--;
+			if (selected_index - scroll < 1 && scroll > 0)
+				scroll--;
+		}
+		else return false;
+
+		return true;
+	}
+#endif
+	;
+};
+
+/**
+ * @brief element which displays a table with named columns, which can be sorted and filtered.
+ * 
+ * the cells are fetched on demand by `get_cell`, given a row (counted from 0 up to `row_count`)
+ * and a column, so the table can be as long as you like. the rows are drawn by `rows`, a
+ * `ListView` which only fetches what's visible, and only the columns which fit on the screen
+ * (starting from `column_scroll`) are fetched too.
+ * 
+ * typing while the table is focused filters it down to the rows with a cell containing the
+ * text typed (ignoring case), and enter sorts it by the leftmost column on display, then sorts
+ * it the other way, then goes back to the original order. arrow keys scroll the table. the same
+ * can be done with `setFilter` and `sortBy`.
+ * 
+ * the order of the rows on display is built on another thread, and swapped in all at once when
+ * it's ready (by an `Animator` timer, so `Animator::update` must be called), so filtering a huge
+ * table doesn't hold up the interface. while a new order is being built, the old one stays on
+ * display. typing more of the filter only has to search the rows which matched before. this
+ * means `get_cell` (and `row_count`) may be called from another thread while the table is being
+ * drawn, so must be safe to call at the same time as each other. if the data changes, call
+ * `refresh`.
+ **/
+class TableView : public Component, public Utility
+{
+public:
+	struct Column
+	{
+		string name;
+		int width;		// number of cells the column takes up
+		int alignment;	// < 0 for left-aligned, = 0 for center-aligned, or > 0 for right-aligned
+
+		Column(string _name, int _width, int _alignment = -1) : name(_name), width(_width), alignment(_alignment) { }
+	};
+
+	vector<Column> columns;
+	function<size_t()> row_count;					// number of rows in the data
+	function<string(size_t, size_t)> get_cell;		// fetches the text of a cell, given its row in the data and its column
+	int column_scroll = 0;							// index of the leftmost column on display
+	ListView rows;									// draws the rows. its `scroll` and `selected_index` count rows on display
+
+	TableView(vector<Column> _columns, function<size_t()> _row_count, function<string(size_t, size_t)> _get_cell, int _scroll, int _selected_index)
+		: columns(_columns), row_count(_row_count), get_cell(_get_cell), rows([this]() { return getDisplayedRowCount(); }, nullptr, _scroll, _selected_index)
+	{
+		rows.draw_item = [this](size_t index, BufferView row) { drawRow(index, row); };
+	}
+
+	~TableView()
+	{
+		{
+			lock_guard<mutex> lock(index_lock);
+			index_stopping = true;
+		}
+		index_generation++;
+		index_wakeup.notify_one();
+		if (index_worker.joinable()) index_worker.join();
+	}
+
+	GETTYPENAME_STUB("TableView");
+
+	/**
+	 * @brief shows only the rows with a cell containing some text, ignoring case.
+	 * 
+	 * @param text text to search for. if empty, every row is shown
+	 * @param column column to search in, or -1 to search every column
+	 **/
+	void setFilter(string text, int column = -1)
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (text == filter && column == filter_column) return;
+		filter = text;
+		filter_column = column;
+		requestIndex(true);
+	}
+#endif
+	;
+
+	/**
+	 * @brief sorts the rows by one column. numbers are sorted by value, and come before text,
+	 * which is sorted alphabetically. rows with equal cells keep their original order.
+	 * 
+	 * @param column column to sort by, or -1 to show the rows in their original order
+	 * @param descending whether to sort from largest to smallest instead
+	 **/
+	void sortBy(int column, bool descending = false)
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (column < 0) descending = false;
+		if (column == sort_column && descending == sort_descending) return;
+		sort_column = column;
+		sort_descending = descending;
+		requestIndex(true);
+	}
+#endif
+	;
+
+	/**
+	 * @brief rebuilds the order of the rows on display, after the data has changed. the
+	 * selection and scroll position are kept.
+	 **/
+	inline void refresh() { data_version++; requestIndex(false); }
+
+	inline const string& getFilter() const { return filter; }
+	inline int getSortColumn() const { return sort_column; }
+	inline bool isSortDescending() const { return sort_descending; }
+
+	/**
+	 * @brief checks whether a new order for the rows is still being built, in which case the
+	 * old one is still on display.
+	 * 
+	 * @returns true if the order on display is out of date
+	 **/
+	inline bool isBuilding() const { return building; }
+
+	/**
+	 * @brief get the number of rows on display, which is the number of rows which passed
+	 * the filter.
+	 * 
+	 * @returns number of rows
+	 **/
+	inline size_t getDisplayedRowCount() const { return order ? order->size() : (row_count ? row_count() : 0); }
+
+	/**
+	 * @brief get which row of the data a row on display is showing.
+	 * 
+	 * @param index index of the row on display
+	 * 
+	 * @returns index of the row in the data
+	 **/
+	inline size_t getDataRow(size_t index) const { return order ? (*order)[index] : index; }
+
+	/**
+	 * @brief get which row of the data is selected.
+	 * 
+	 * @returns index of the row in the data, or -1 if no row is selected
+	 **/
+	inline long long getSelectedRow() const
+	{
+		if (rows.selected_index < 0 || static_cast<size_t>(rows.selected_index) >= getDisplayedRowCount()) return -1;
+		return static_cast<long long>(getDataRow(static_cast<size_t>(rows.selected_index)));
+	}
+
+	RENDERVIEW_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (!target.isValid()) return;
+		Coordinate size = target.size;
+		column_scroll = max(0, min(column_scroll, static_cast<int>(columns.size()) - 1));
+		bool footer = building || !filter.empty();
+
+		BufferView header = target.subView(Coordinate{ 0,0 }, Coordinate{ size.x,1 });
+		header.fill(getBlankTixel());
+		int x = 0;
+		for (size_t c = static_cast<size_t>(column_scroll); c < columns.size() && x < size.x; c++)
+		{
+			const Column& column = columns[c];
+			string_view marker = (static_cast<int>(c) != sort_column) ? "" : (sort_descending ? " v" : " ^");
+			Coordinate cell_size{ min(column.width, size.x - x), 1 };
+			drawCell(scratchJoin({ column.name, marker }), column.alignment, header.subView(Coordinate{ x,0 }, cell_size));
+			x += column.width;
+			if (x < size.x) header.at(x, 0) = UNICODE_BOXLIGHT_VERTICAL;
+			x++;
+		}
+		fillColour(getUnfocusedColour(), Coordinate{ 0,0 }, Coordinate{ size.x,1 }, header);
+
+		int body_height = size.y - 1 - (footer ? 1 : 0);
+		BufferView body = target.subView(Coordinate{ 0,1 }, Coordinate{ size.x,body_height });
+		rows.focused = focused;
+		if (body_height >= 2) renderChild(&rows, body);
+		else body.fill(getBlankTixel());
+
+		if (!footer) return;
+		BufferView footer_row = target.subView(Coordinate{ 0,size.y - 1 }, Coordinate{ size.x,1 });
+		footer_row.fill(getBlankTixel());
+		string_view count = building ? string_view(" ... ") : scratchFormat(" %zu rows ", getDisplayedRowCount());
+		drawText(scratchJoin({ "/", filter }), Coordinate{ 0,0 }, Coordinate{ size.x - static_cast<int>(count.length()),1 }, footer_row);
+		drawText(count, Coordinate{ size.x - static_cast<int>(count.length()),0 }, Coordinate{ static_cast<int>(count.length()),1 }, footer_row);
+	}
+#endif
+	;
+
+	RENDER_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		render(BufferView(output_buffer, size));
+	}
+#endif
+	;
+
+	FIXEDSIZE_STUB(10, 4, -1, -1);
+
+	ISFOCUSABLE_STUB { return true; }
+
+	HANDLEINPUT_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (!focused) return false;
+		if (input_character == Input::ArrowKeys::UP || input_character == Input::ArrowKeys::DOWN)
+		{
+			rows.focused = true;
+			if (!rows.handleInput(input_character, modifiers)) return false;
+			rows.markDirty(false);
+		}
+		else if (input_character == Input::ArrowKeys::LEFT && column_scroll > 0) { column_scroll--; rows.markDirty(false); }
+		else if (input_character == Input::ArrowKeys::RIGHT && column_scroll + 1 < static_cast<int>(columns.size())) { column_scroll++; rows.markDirty(false); }
+		else if (input_character == '\n')
+		{
+			// cycles between ascending, descending and unsorted
+			if (sort_column != column_scroll) sortBy(column_scroll);
+			else if (!sort_descending) sortBy(column_scroll, true);
+			else sortBy(-1);
+		}
+		else if (input_character == '\b' || input_character == 127)
+		{
+			if (filter.empty()) return false;
+			setFilter(filter.substr(0, filter.length() - 1), filter_column);
+		}
+		else if (input_character >= ' ' && input_character < 127)
+			setFilter(filter + static_cast<char>(input_character), filter_column);
+		else return false;
+
+		return true;
+	}
+#endif
+	;
+
+	HANDLETEXTINPUT_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (!focused) return false;
+		string addition;
+		for (char c : text)
+			if (isKeptCharacter(c, "\b\t\n\r")) addition += c;
+		if (addition.empty()) return false;
+		setFilter(filter + addition, filter_column);
+		return true;
+	}
+#endif
+	;
+
+private:
+	/**
+	 * @brief everything needed to build an order for the rows, copied so that the
+	 * building thread doesn't touch the table itself.
+	 **/
+	struct IndexRequest
+	{
+		size_t generation = 0;
+		size_t data_version = 0;		// orders built for a different version can't be reused
+		size_t row_count = 0;
+		size_t column_count = 0;
+		string filter;					// already in lower case
+		int filter_column = -1;
+		int sort_column = -1;
+		bool sort_descending = false;
+		function<string(size_t, size_t)> get_cell;
+	};
+
+	/**
+	 * @brief a cell being sorted, with its value if it's a number.
+	 **/
+	struct SortKey
+	{
+		string text;
+		double number;
+		bool is_number;
+	};
+
+	string filter;
+	int filter_column = -1;
+	int sort_column = -1;
+	bool sort_descending = false;
+	size_t data_version = 0;					// increased by `refresh`, since the cells may have changed
+	bool building = false;						// a new order has been asked for and hasn't arrived yet
+	bool reset_position = false;				// the selection should go back to the top when the new order arrives
+	shared_ptr<const vector<size_t>> order;		// rows of the data on display, in order, or null for all of them in their original order
+	size_t index_timer = 0;						// `Animator` timer waiting for the new order
+
+	thread index_worker;						// builds orders for the rows, started the first time one is needed
+	mutex index_lock;							// guards everything below
+	condition_variable index_wakeup;
+	atomic<size_t> index_generation{ 0 };		// increased every time a new order is asked for
+	IndexRequest index_request;					// the most recently asked for order
+	shared_ptr<const vector<size_t>> built_order;	// most recently finished order
+	size_t built_generation = 0;				// generation of `built_order`
+	bool index_stopping = false;
+
+	/**
+	 * @brief draws the text of a cell, cutting it short if it doesn't fit.
+	 **/
+	static void drawCell(string_view text, int alignment, BufferView cell)
+#ifdef STUI_IMPLEMENTATION
+	{
+		int width = cell.size.x;
+		if (width <= 0) return;
+		text = scratchStrip(text, "\n\t");
+		if (static_cast<int>(text.length()) > width)
+		{
+			drawText(text, Coordinate{ 0,0 }, Coordinate{ width - 1,1 }, cell);
+			cell.at(width - 1, 0) = UNICODE_ELLIPSIS_HORIZONTAL;
+			return;
+		}
+		int offset = 0;
+		if (alignment == 0) offset = (width - static_cast<int>(text.length())) / 2;
+		else if (alignment > 0) offset = width - static_cast<int>(text.length());
+		drawText(text, Coordinate{ offset,0 }, Coordinate{ width - offset,1 }, cell);
+	}
+#endif
+	;
+
+	void drawRow(size_t index, BufferView row)
+#ifdef STUI_IMPLEMENTATION
+	{
+		size_t data_row = getDataRow(index);
+		if (!get_cell || !row_count || data_row >= row_count()) return;
+		int x = 0;
+		for (size_t c = static_cast<size_t>(column_scroll); c < columns.size() && x < row.size.x; c++)
+		{
+			Coordinate cell_size{ min(columns[c].width, row.size.x - x), 1 };
+			drawCell(get_cell(data_row, c), columns[c].alignment, row.subView(Coordinate{ x,0 }, cell_size));
+			x += columns[c].width;
+			if (x < row.size.x) row.at(x, 0) = UNICODE_BOXLIGHT_VERTICAL;
+			x++;
+		}
+	}
+#endif
+	;
+
+	/**
+	 * @brief asks for a new order for the rows, matching the current filter and sort.
+	 * 
+	 * @param reset whether to move the selection back to the top once it arrives
+	 **/
+	void requestIndex(bool reset)
+#ifdef STUI_IMPLEMENTATION
+	{
+		size_t generation = ++index_generation;
+		markDirty();
+		rows.markDirty();
+		if (filter.empty() && sort_column < 0)
+		{
+			// nothing to build, since every row is shown in its original order
+			if (index_timer != 0) Animator::stop(index_timer);
+			index_timer = 0;
+			order.reset();
+			building = false;
+			if (reset) { rows.scroll = 0; rows.selected_index = 0; }
+			return;
+		}
+
+		IndexRequest request;
+		request.generation = generation;
+		request.data_version = data_version;
+		request.row_count = row_count ? row_count() : 0;
+		request.column_count = columns.size();
+		request.filter = filter;
+		for (char& c : request.filter) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+		request.filter_column = filter_column;
+		request.sort_column = sort_column;
+		request.sort_descending = sort_descending;
+		request.get_cell = get_cell;
+		{
+			lock_guard<mutex> lock(index_lock);
+			index_request = move(request);
+		}
+		if (!index_worker.joinable()) index_worker = thread([this]() { buildIndices(); });
+		index_wakeup.notify_one();
+
+		building = true;
+		reset_position = reset_position || reset;
+		if (index_timer == 0) index_timer = Animator::start(this, 0.02f, [this]() { return takeIndex(); });
+	}
+#endif
+	;
+
+	/**
+	 * @brief swaps in the new order for the rows, if it's ready. called by the `Animator`.
+	 * 
+	 * @returns true if the order changed
+	 **/
+	bool takeIndex()
+#ifdef STUI_IMPLEMENTATION
+	{
+		{
+			lock_guard<mutex> lock(index_lock);
+			if (built_order == nullptr || built_generation != index_generation.load()) return false;
+			order = move(built_order);
+			built_order.reset();
+		}
+		building = false;
+		if (reset_position) { rows.scroll = 0; rows.selected_index = 0; }
+		reset_position = false;
+		Animator::stop(index_timer);
+		index_timer = 0;
+		// the timer has gone, so the `Animator` won't mark this dirty itself
+		rows.markDirty();
+		markDirty();
+		return true;
+	}
+#endif
+	;
+
+	/**
+	 * @brief runs on `index_worker`, building each order which is asked for.
+	 **/
+	void buildIndices()
+#ifdef STUI_IMPLEMENTATION
+	{
+		// the last order built, and what it was built for, so that narrowing the filter or
+		// changing the sort can start from it instead of from every row
+		IndexRequest last;
+		shared_ptr<const vector<size_t>> last_order;
+		size_t handled = 0;
+		while (true)
+		{
+			IndexRequest request;
+			{
+				unique_lock<mutex> lock(index_lock);
+				index_wakeup.wait(lock, [this, handled]() { return index_stopping || index_request.generation != handled; });
+				if (index_stopping) return;
+				request = index_request;
+			}
+			handled = request.generation;
+
+			shared_ptr<vector<size_t>> result = buildIndex(request, last, last_order.get());
+			if (result == nullptr) continue;
+			last = request;
+			last_order = result;
+
+			lock_guard<mutex> lock(index_lock);
+			built_order = move(result);
+			built_generation = request.generation;
+		}
+	}
+#endif
+	;
+
+	/**
+	 * @brief builds one order for the rows.
+	 * 
+	 * @returns the rows to show, in order, or null if a newer order was asked for in the meantime
+	 **/
+	shared_ptr<vector<size_t>> buildIndex(const IndexRequest& request, const IndexRequest& last, const vector<size_t>* last_order)
+#ifdef STUI_IMPLEMENTATION
+	{
+		auto superseded = [this, &request](size_t i) { return (i & 4095) == 0 && index_generation.load(memory_order_relaxed) != request.generation; };
+		auto matches = [&request](size_t row)
+			{
+				if (request.filter.empty()) return true;
+				auto contains = [&request](const string& cell)
+					{
+						return search(cell.begin(), cell.end(), request.filter.begin(), request.filter.end(),
+							[](char a, char b) { return tolower(static_cast<unsigned char>(a)) == b; }) != cell.end();
+					};
+				if (request.filter_column >= 0)
+					return static_cast<size_t>(request.filter_column) < request.column_count && contains(request.get_cell(row, static_cast<size_t>(request.filter_column)));
+				for (size_t c = 0; c < request.column_count; c++)
+					if (contains(request.get_cell(row, c))) return true;
+				return false;
+			};
+
+		bool same_rows = last_order != nullptr && last.data_version == request.data_version && last.row_count == request.row_count && last.column_count == request.column_count && last.filter_column == request.filter_column;
+		bool same_sort = last.sort_column == request.sort_column && last.sort_descending == request.sort_descending;
+		// rows which don't match part of the filter can't match all of it, and filtering a sorted list leaves it sorted
+		bool narrower = same_rows && request.filter.find(last.filter) != string::npos;
+
+		auto result = make_shared<vector<size_t>>();
+		if (narrower && same_sort)
+		{
+			for (size_t i = 0; i < last_order->size(); i++)
+			{
+				if (superseded(i)) return nullptr;
+				if (matches((*last_order)[i])) result->push_back((*last_order)[i]);
+			}
+			return result;
+		}
+
+		if (same_rows && request.filter == last.filter)
+			*result = *last_order;
+		else
+		{
+			for (size_t row = 0; row < request.row_count; row++)
+			{
+				if (superseded(row)) return nullptr;
+				if (matches(row)) result->push_back(row);
+			}
+		}
+
+		if (request.sort_column < 0 || static_cast<size_t>(request.sort_column) >= request.column_count)
+		{
+			sort(result->begin(), result->end());
+			return result;
+		}
+
+		// each cell is only fetched once, rather than every time it's compared
+		vector<SortKey> keys(result->size());
+		for (size_t i = 0; i < result->size(); i++)
+		{
+			if (superseded(i)) return nullptr;
+			SortKey& key = keys[i];
+			key.text = request.get_cell((*result)[i], static_cast<size_t>(request.sort_column));
+			char* end = nullptr;
+			key.number = strtod(key.text.c_str(), &end);
+			key.is_number = !key.text.empty() && end == key.text.c_str() + key.text.length();
+		}
+		vector<size_t> positions(result->size());
+		for (size_t i = 0; i < positions.size(); i++) positions[i] = i;
+		bool descending = request.sort_descending;
+		stable_sort(positions.begin(), positions.end(), [&keys, descending](size_t a, size_t b)
+			{
+				const SortKey& first = descending ? keys[b] : keys[a];
+				const SortKey& second = descending ? keys[a] : keys[b];
+				if (first.is_number != second.is_number) return first.is_number;
+				if (first.is_number) return first.number < second.number;
+				return first.text < second.text;
+			});
+		if (index_generation.load(memory_order_relaxed) != request.generation) return nullptr;
+
+		auto sorted = make_shared<vector<size_t>>(result->size());
+		for (size_t i = 0; i < positions.size(); i++) (*sorted)[i] = (*result)[positions[i]];
+		return sorted;
+	}
+#endif
+	;
+};
+
+/**
+ * @brief complex display element capable of visualising tree structures as a heirarchy
+ * with nested, expandable nodes.
+ * 
+ * nodes can be given a descriptive name, and an identifier (which could be used to
+ * index into your own array of proprietary nodes). expansion of nodes can be toggled;
+ * if a node is expanded then its children will be shown, otherwise they will not.
+ * 
+ * the tree keeps a flat list of the rows currently on display, along with a lookup from
+ * node ID to row, so moving the selection and drawing only cost as much as the rows
+ * actually on the screen. expanding and collapsing nodes through the `TreeView` keeps
+ * this up to date, but if you change the tree yourself (adding or removing nodes, changing
+ * IDs or `expanded` flags, or replacing `root`) you must call `refresh` afterwards.
+ * 
+ * node IDs should be unique. `selected_index` holds the ID of the selected node.
+ * 
+ * for very large trees, nodes don't need to have their children filled in up front. a node
+ * with `children_loaded` set to false reports `child_count` children, and the first time it's
+ * expanded, `load_children` is called to fill in its `children`. if `unload_children` is also
+ * set, the children of nodes which have been collapsed (and off the screen) for longer than
+ * `eviction_delay` seconds are handed back to it to be freed, and loaded again if needed.
+ * `selectNode` can only find nodes which have been loaded.
+ **/
+class TreeView : public Component, public Utility
+{
+	int last_render_height = 0;
 
 public:
-	vector<string> options;
-	int selected_index;
-	bool enabled;
+	struct Node
+	{
+		string name = "empty tree node";
+		vector<Node*> children;
+		uint32_t id = 0;
+		bool expanded = true;
+		bool children_loaded = true;	// if false, `children` is filled in by `load_children` when first needed
+		size_t child_count = 0;			// number of children to report until they've been loaded
+	};
 
-	RadioButton(vector<string> _options, int _selected_index, bool _enabled) : options(_options), selected_index(_selected_index), enabled(_enabled) { }
+	Node* root;
+	size_t scroll;
+	size_t selected_index = 0;
 
-	GETTYPENAME_STUB("RadioButton");
+	function<void(Node*)> load_children;	// fills in the children of a node which hasn't loaded them yet
+	function<void(Node*)> unload_children;	// frees the children of a node, which is then marked as not loaded
+	float eviction_delay = 30.0f;			// seconds a collapsed node must stay off the screen before its children are unloaded
+
+	TreeView(Node* _root, size_t _scroll, size_t _selected_index) : root(_root), scroll(_scroll), selected_index(_selected_index) { }
+
+	GETTYPENAME_STUB("TreeView");
+
+	RENDER_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (size.x < 2 || size.y < 2) return;
+		last_render_height = size.y;
+		if (root == nullptr)
+		{
+			fillColour(focused ? getHighlightedColour() : getUnfocusedColour(), Coordinate{ 0,0, }, Coordinate{ size.x,1 }, output_buffer, size);
+			return;
+		}
+		ensureIndex();
+		reportScroll(static_cast<long long>(scroll));
+		auto now = clock_type::now();
+
+		for (int top = 0; top < size.y; top++)
+		{
+			size_t row = scroll + static_cast<size_t>(top);
+			if (row >= rows.size()) break;
+			const Node* node = rows[row].node;
+			int depth = rows[row].depth;
+			auto loaded = lazily_loaded.find(const_cast<Node*>(node));
+			if (loaded != lazily_loaded.end()) loaded->second = now;
+
+			if (top == size.y - 1 && row != rows.size() - 1)
+			{
+				output_buffer[top * size.x] = UNICODE_ELLIPSIS_VERTICAL;
+			}
+			else
+			{
+				drawText(scratchJoin({ node->expanded ? "  " : "> ", scratchStrip(node->name, "\n\t") }), Coordinate{ depth, top }, Coordinate{ size.x - 2 - depth, 1 }, output_buffer, size);
+				for (int i = 0; i < depth && i < size.x; i++) output_buffer[i + (top * size.x)] = '|';
+				if (node->expanded && depth < size.x) output_buffer[depth + (top * size.x)] = UNICODE_NOT;
+				string_view id_desc = scratchFormat(" [%zu]", node->children_loaded ? node->children.size() : node->child_count);
+				drawText(id_desc, Coordinate{ size.x - (int)id_desc.length(), top }, Coordinate{ (int)id_desc.length(), 1 }, output_buffer, size);
+			}
+			if (selected_index == node->id)
+				fillColour(focused ? getHighlightedColour() : getUnfocusedColour(), Coordinate{ 0,top, }, Coordinate{ size.x,1 }, output_buffer, size);
+		}
+
+		evictChildren(now);
+	}
+#endif
+	;
+
+	FIXEDSIZE_STUB(10, 3, -1, -1);
+
+	ISFOCUSABLE_STUB { return true; }
+
+	HANDLEINPUT_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (!focused) return false;
+		if (root == nullptr) return false;
+		ensureIndex();
+
+		size_t row = findRow(static_cast<uint32_t>(selected_index));
+		if (row == rows.size())
+		{
+			selected_index = root->id;
+			return true;
+		}
+
+		if (input_character == Input::ArrowKeys::DOWN)
+			moveSelection(1);
+		else if (input_character == Input::ArrowKeys::UP)
+			moveSelection(-1);
+		else if (input_character == Input::ArrowKeys::RIGHT)
+			setRowExpanded(row, true);
+		else if (input_character == Input::ArrowKeys::LEFT)
+			setRowExpanded(row, false);
+		else return false;
+
+		return true;
+	}
+#endif
+	;
+
+	/**
+	 * @brief moves the selection up or down by a number of rows (for instance, a whole
+	 * page at a time), scrolling to keep it on the screen.
+	 * 
+	 * @param row_delta number of rows to move by. negative numbers move upwards
+	 **/
+	void moveSelection(int row_delta)
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (root == nullptr) return;
+		ensureIndex();
+		size_t current = findRow(static_cast<uint32_t>(selected_index));
+		long long row = (current == rows.size()) ? 0 : static_cast<long long>(current);
+		row = max(0LL, min(static_cast<long long>(rows.size()) - 1, row + row_delta));
+		selected_index = rows[static_cast<size_t>(row)].node->id;
+		selected_row = static_cast<size_t>(row);
+		scrollToRow(selected_row);
+	}
+#endif
+	;
+
+	/**
+	 * @brief selects the node with a particular ID, expanding any collapsed nodes above it
+	 * so that it's visible, and scrolling to it.
+	 * 
+	 * @param id ID of the node to select
+	 * 
+	 * @returns false if there is no node with that ID
+	 **/
+	bool selectNode(uint32_t id)
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (root == nullptr) return false;
+		ensureIndex();
+		auto found_parent = parent_of_id.find(id);
+		if (found_parent == parent_of_id.end()) return false;
+
+		// expand from the top down, so each step only has to patch in one node's children
+		vector<Node*> collapsed_ancestors;
+		for (Node* ancestor = found_parent->second; ancestor != nullptr; ancestor = parent_of_id[ancestor->id])
+			if (!ancestor->expanded) collapsed_ancestors.push_back(ancestor);
+		for (auto it = collapsed_ancestors.rbegin(); it != collapsed_ancestors.rend(); it++)
+		{
+			size_t row = findRow((*it)->id);
+			if (row != rows.size()) setRowExpanded(row, true);
+		}
+
+		selected_index = id;
+		size_t row = findRow(id);
+		if (row != rows.size())
+		{
+			selected_row = row;
+			scrollToRow(row);
+		}
+		return true;
+	}
+#endif
+	;
+
+	/**
+	 * @brief rebuilds the list of visible rows from scratch. call this after making
+	 * changes to the tree yourself.
+	 **/
+	void refresh()
+#ifdef STUI_IMPLEMENTATION
+	{
+		rows.clear();
+		row_of_id.clear();
+		parent_of_id.clear();
+		indexed_root = root;
+		if (root == nullptr) return;
+
+		// walk the whole tree once to find each node's parent, and forget any loaded nodes which have gone
+		unordered_map<Node*, clock_type::time_point> still_loaded;
+		vector<pair<Node*, Node*>> to_visit = { pair<Node*, Node*>(root, nullptr) };
+		while (!to_visit.empty())
+		{
+			Node* node = to_visit.back().first;
+			parent_of_id[node->id] = to_visit.back().second;
+			to_visit.pop_back();
+			auto loaded = lazily_loaded.find(node);
+			if (loaded != lazily_loaded.end()) still_loaded.insert(*loaded);
+			for (auto it = node->children.rbegin(); it != node->children.rend(); it++)
+				to_visit.push_back(pair<Node*, Node*>(*it, node));
+		}
+		lazily_loaded.swap(still_loaded);
+		appendVisibleRows(root, 0, rows);
+		indexed_rows = 0;
+		selected_row = 0;
+	}
+#endif
+	;
+
+private:
+	struct Row
+	{
+		Node* node;
+		int depth;
+	};
+
+	vector<Row> rows;								// nodes currently on display, in the order they're drawn
+	unordered_map<uint32_t, size_t> row_of_id;		// position of each visible node in `rows`
+	size_t indexed_rows = 0;						// entries in `row_of_id` are only up to date for rows before this
+	size_t selected_row = 0;						// where the selected node was last seen, checked before using the lookup
+	unordered_map<uint32_t, Node*> parent_of_id;	// parent of every node in the tree (null for the root)
+	Node* indexed_root = nullptr;					// root the index was last built from
+	unordered_map<Node*, clock_type::time_point> lazily_loaded;	// nodes whose children were loaded on demand, and when they were last seen
+	clock_type::time_point last_eviction_check;
+
+	inline void ensureIndex()
+	{
+		if (indexed_root != root || rows.empty()) refresh();
+	}
+
+	/**
+	 * @brief appends a node and all of its visible descendants to a list of rows, in the
+	 * order they should be drawn, loading children where necessary.
+	 **/
+	void appendVisibleRows(Node* node, int depth, vector<Row>& output)
+#ifdef STUI_IMPLEMENTATION
+	{
+		vector<Row> to_visit = { Row{ node, depth } };
+		while (!to_visit.empty())
+		{
+			Row row = to_visit.back();
+			to_visit.pop_back();
+			output.push_back(row);
+			if (!row.node->expanded) continue;
+			loadChildren(row.node);
+			for (auto it = row.node->children.rbegin(); it != row.node->children.rend(); it++)
+				to_visit.push_back(Row{ *it, row.depth + 1 });
+		}
+	}
+#endif
+	;
+
+	/**
+	 * @brief fetches the children of a node from `load_children`, if they haven't been already.
+	 **/
+	void loadChildren(Node* node)
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (node->children_loaded) return;
+		if (!load_children) return;
+		load_children(node);
+		node->children_loaded = true;
+		node->child_count = node->children.size();
+		for (Node* child : node->children) parent_of_id[child->id] = node;
+		lazily_loaded[node] = clock_type::now();
+	}
+#endif
+	;
+
+	/**
+	 * @brief hands the children of lazily-loaded nodes which have been collapsed and off the
+	 * screen for too long back to `unload_children`. does nothing if `unload_children` isn't set.
+	 **/
+	void evictChildren(clock_type::time_point now)
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (!unload_children || eviction_delay < 0.0f) return;
+		// no point checking more often than this
+		if (chrono::duration<float>(now - last_eviction_check).count() < min(1.0f, eviction_delay)) return;
+		last_eviction_check = now;
+
+		vector<Node*> to_evict;
+		unordered_map<Node*, bool> holds_selection;
+		for (auto it = parent_of_id.find(static_cast<uint32_t>(selected_index)); it != parent_of_id.end() && it->second != nullptr; it = parent_of_id.find(it->second->id))
+			holds_selection[it->second] = true;
+		for (auto& entry : lazily_loaded)
+			if (!entry.first->expanded && !holds_selection.count(entry.first) && chrono::duration<float>(now - entry.second).count() >= eviction_delay)
+				to_evict.push_back(entry.first);
+
+		for (Node* node : to_evict)
+		{
+			// forget about everything inside the subtree before handing it back
+			if (lazily_loaded.count(node) == 0) continue;
+			vector<Node*> to_forget(node->children.begin(), node->children.end());
+			while (!to_forget.empty())
+			{
+				Node* descendant = to_forget.back();
+				to_forget.pop_back();
+				parent_of_id.erase(descendant->id);
+				row_of_id.erase(descendant->id);
+				lazily_loaded.erase(descendant);
+				to_forget.insert(to_forget.end(), descendant->children.begin(), descendant->children.end());
+			}
+			lazily_loaded.erase(node);
+
+			node->child_count = node->children.size();
+			unload_children(node);
+			node->children.clear();
+			node->children_loaded = false;
+		}
+	}
+#endif
+	;
+
+	/**
+	 * @brief find which row a node is displayed on.
+	 * 
+	 * expanding or collapsing a node shifts every row after it, so rather than fixing up the
+	 * lookup straight away, it's only brought up to date when a row past the change is needed.
+	 * the selected node is usually at or before the change, and is checked first.
+	 * 
+	 * @returns the row, or the number of rows if the node isn't visible
+	 **/
+	size_t findRow(uint32_t id)
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (selected_row < rows.size() && rows[selected_row].node->id == id) return selected_row;
+
+		auto found = row_of_id.find(id);
+		if (found != row_of_id.end() && found->second < indexed_rows && rows[found->second].node->id == id)
+			return found->second;
+		if (indexed_rows >= rows.size()) return rows.size();
+
+		for (size_t i = indexed_rows; i < rows.size(); i++)
+			row_of_id[rows[i].node->id] = i;
+		indexed_rows = rows.size();
+		found = row_of_id.find(id);
+		return (found == row_of_id.end()) ? rows.size() : found->second;
+	}
+#endif
+	;
+
+	/**
+	 * @brief expands or collapses the node on a particular row, patching its descendants
+	 * into or out of the list of rows.
+	 **/
+	void setRowExpanded(size_t row, bool expanded)
+#ifdef STUI_IMPLEMENTATION
+	{
+		Node* node = rows[row].node;
+		if (node->expanded == expanded) return;
+
+		if (expanded)
+		{
+			node->expanded = true;
+			loadChildren(node);
+			vector<Row> inserted;
+			for (Node* child : node->children)
+				appendVisibleRows(child, rows[row].depth + 1, inserted);
+			rows.insert(rows.begin() + static_cast<ptrdiff_t>(row + 1), inserted.begin(), inserted.end());
+		}
+		else
+		{
+			size_t end = row + 1;
+			while (end < rows.size() && rows[end].depth > rows[row].depth)
+			{
+				row_of_id.erase(rows[end].node->id);
+				end++;
+			}
+			rows.erase(rows.begin() + static_cast<ptrdiff_t>(row + 1), rows.begin() + static_cast<ptrdiff_t>(end));
+			node->expanded = false;
+		}
+		indexed_rows = min(indexed_rows, row + 1);
+	}
+#endif
+	;
+
+	/**
+	 * @brief adjusts `scroll` so that a row is on the screen, and not hidden behind the
+	 * ellipsis shown at the bottom when there are more rows below.
+	 **/
+	inline void scrollToRow(size_t row)
+	{
+		size_t height = static_cast<size_t>(max(last_render_height, 1));
+		size_t usable = (row == rows.size() - 1 || height < 2) ? height : height - 1;
+		if (row < scroll) scroll = row;
+		else if (row >= scroll + usable) scroll = row - usable + 1;
+	}
+};
+
+/**
+ * @brief complex display element capable of displaying simple low-resolution grayscale
+ * images.
+ * 
+ * images will be displayed at twice the width they are stored at to compensate for the
+ * aspect ratio of terminal characters. each pixel should be described by a single byte.
+ * the size of the image buffer must be allocated to match the image size parameter.
+ **/
+class ImageView : public Component
+{
+public:
+	uint8_t* grayscale_image;
+	Coordinate image_size;
+	
+	ImageView(uint8_t* _grayscale_image, Coordinate _image_size) : grayscale_image(_grayscale_image), image_size(_image_size) { }
+	
+	GETTYPENAME_STUB("ImageView");
 
 	RENDER_STUB
 #ifdef STUI_IMPLEMENTATION
 	{
-		if (size.y < 1) return;
+		if (grayscale_image == nullptr) return;
 
-		for (int line = 0; line < static_cast<int>(options.size()); line++)
+		// anything past the edge of the image is left blank
+		int width = min(size.x, image_size.x * 2);
+		int height = min(size.y, image_size.y);
+		for (int y = 0; y < height; y++)
 		{
-			if (line >= size.y) break;
-			drawText("[ ] " + options[line], Coordinate{ 0,line }, Coordinate{ size.x,1 }, output_buffer, size);
-			output_buffer[(line * size.x) + 1] = selected_index == line ? '*' : ' ';
-			if (line == highlighted_index && enabled)
-				fillColour(focused ? getHighlightedColour() : getUnfocusedColour(), Coordinate{ 0,line }, Coordinate{ size.x,1}, output_buffer, size);
+			for (int x = 0; x < width; x++)
+			{
+				uint32_t out = ' ';
+				uint8_t in = grayscale_image[(x / 2) + (y * image_size.x)];
+				if (in >= 192) out = UNICODE_BLOCK;
+				else if (in >= 128) out = UNICODE_DARK_SHADE;
+				else if (in >= 96) out = UNICODE_MID_SHADE;
+				else if (in >= 64) out = UNICODE_LIGHT_SHADE;
+				else if (in >= 32) out = UNICODE_MIDDLE_DOT;
+				else out = ' ';
+				output_buffer[x + (y * size.x)] = out;
+			}
 		}
 	}
 #endif
 	;
 
-	GETMAXSIZE_STUB { return Coordinate{ -1,-1 }; }
-	GETMINSIZE_STUB { return Coordinate{ 5, static_cast<int>(options.size()) }; }
+	GETMAXSIZE_STUB { return Coordinate{ image_size.x * 2, image_size.y }; }
+	GETMINSIZE_STUB { return Coordinate{ 1, 1 }; }
+};
 
-	ISFOCUSABLE_STUB { return true; }
+/**
+ * @brief display element for full-colour images, such as thumbnails or plots.
+ * 
+ * the image is scaled to fit whatever size it is given (averaging together all the pixels
+ * which land in each output pixel when shrinking it), and drawn with half-block characters so
+ * that each cell shows two pixels, one above the other. with `STUI_TRUECOLOUR` these are drawn
+ * in 24-bit colour, otherwise each pixel is drawn in the nearest of the terminal's colours.
+ * 
+ * the scaled image is kept between frames and only worked out again when the size changes, or
+ * when `imageChanged` is called. the buffer isn't copied, so it must outlive this `Component`,
+ * and you must call `imageChanged` whenever you change its contents.
+ **/
+class ColourImageView : public Component, public Utility
+{
+public:
+	/**
+	 * @brief layout of each pixel in the image buffer.
+	 **/
+	enum Format
+	{
+		GRAYSCALE,	// one byte per pixel
+		RGB,		// three bytes per pixel, red first
+		RGBA		// four bytes per pixel, red first, with alpha blending onto `background`
+	};
 
-	HANDLEINPUT_STUB
+	const uint8_t* pixels;
+	Coordinate image_size;
+	Format format;
+	uint32_t background = 0x000000;		// colour (as `0xRRGGBB`) shown behind transparent pixels, and around the image
+	bool keep_aspect = true;			// if false, the image is stretched to fill the whole area
+
+	ColourImageView(const uint8_t* _pixels, Coordinate _image_size, Format _format) : pixels(_pixels), image_size(_image_size), format(_format) { }
+
+	GETTYPENAME_STUB("ColourImageView");
+
+	/**
+	 * @brief throw away the scaled image, so that it's worked out again from the image buffer
+	 * next time, and mark this as changed. call this whenever the contents of the image buffer change.
+	 **/
+	inline void imageChanged() { raster_valid = false; markDirty(); }
+
+	RENDER_STUB
 #ifdef STUI_IMPLEMENTATION
 	{
-		if (!focused || !enabled) return false;
-
-		if (input_character == Input::ArrowKeys::UP && highlighted_index > 0) highlighted_index--;
-		if (input_character == Input::ArrowKeys::DOWN && highlighted_index + 1 < static_cast<int>(options.size())) highlighted_index++;
-		if (input_character == Input::ArrowKeys::LEFT) highlighted_index = 0;
-		if (input_character == Input::ArrowKeys::RIGHT) highlighted_index = max(0, static_cast<int>(options.size()) - 1);
-		if (input_character == ' ' || input_character == '\n') selected_index = highlighted_index;
-		return false;
+		render(BufferView(output_buffer, size));
 	}
 #endif
 	;
-};
 
-/**
- * @brief list of options from which the user can select any, all, or none by navigating
- * up/down and pressing enter/space.
- **/
-class ToggleButton : public Component, public Utility
-{
-	int highlighted_index = 0;
+	RENDERVIEW_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (!target.isValid()) return;
+		if (pixels == nullptr || image_size.x <= 0 || image_size.y <= 0) { target.fill(getBlankTixel()); return; }
+
+		// anything which changes the result without going through `imageChanged` is checked here
+		if (!raster_valid || raster_size.x != target.size.x || raster_size.y != target.size.y
+			|| raster_pixels != pixels || raster_image_size.x != image_size.x || raster_image_size.y != image_size.y
+			|| raster_format != format || raster_background != background || raster_keep_aspect != keep_aspect)
+			rasterize(target.size);
+#ifdef STUI_TRUECOLOUR
+		// the palette has been emptied since, so the colours need new entries
+		else if (raster_true_colour_generation != Tixel::getTrueColourGeneration())
+			applyTrueColour();
+#endif
 
-public:
-	vector<pair<string, bool>> options;
-	bool enabled;
+		for (int y = 0; y < target.size.y; y++)
+			memcpy(target.row(y), raster.data() + (y * target.size.x), target.size.x * sizeof(Tixel));
+	}
+#endif
+	;
 
-	ToggleButton(vector<pair<string, bool>> _options, bool _enabled) : options(_options), enabled(_enabled) { }
+	GETMAXSIZE_STUB { return Coordinate{ image_size.x, (image_size.y + 1) / 2 }; }
+	GETMINSIZE_STUB { return Coordinate{ 1, 1 }; }
 
-	GETTYPENAME_STUB("ToggleButton");
+private:
+	vector<Tixel> raster;					// the scaled image, ready to copy out
+	vector<uint32_t> scaled;				// the scaled image, as `0xRRGGBB`, two rows per row of cells
+	vector<uint32_t> column_sums;			// premultiplied colour and alpha of each column of source pixels, summed over some rows
+	bool raster_valid = false;
+	Coordinate raster_size{ 0,0 };
+	const uint8_t* raster_pixels = nullptr;
+	Coordinate raster_image_size{ 0,0 };
+	Format raster_format = GRAYSCALE;
+	uint32_t raster_background = 0;
+	bool raster_keep_aspect = true;
+#ifdef STUI_TRUECOLOUR
+	size_t raster_true_colour_generation = 0;	// palette generation the colours in `raster` were looked up in
+#endif
 
-	RENDER_STUB
+	void rasterize(Coordinate size)
 #ifdef STUI_IMPLEMENTATION
 	{
-		if (size.y < 1) return;
+		raster_valid = true;
+		raster_size = size;
+		raster_pixels = pixels;
+		raster_image_size = image_size;
+		raster_format = format;
+		raster_background = background;
+		raster_keep_aspect = keep_aspect;
+
+		// each cell is roughly twice as tall as it is wide, so two pixels per cell keeps them square
+		Coordinate area{ size.x, size.y * 2 };
+		Coordinate fitted = area;
+		if (keep_aspect)
+		{
+			float scale = min(static_cast<float>(area.x) / image_size.x, static_cast<float>(area.y) / image_size.y);
+			fitted.x = max(1, min(area.x, static_cast<int>(roundf(image_size.x * scale))));
+			fitted.y = max(1, min(area.y, static_cast<int>(roundf(image_size.y * scale))));
+		}
+		Coordinate offset{ (area.x - fitted.x) / 2, (area.y - fitted.y) / 2 };
 
-		for (int line = 0; line < static_cast<int>(options.size()); line++)
+		scaled.assign(static_cast<size_t>(area.x) * area.y, background);
+		column_sums.resize(static_cast<size_t>(image_size.x) * 4 + 4);
+		for (int dy = 0; dy < fitted.y; dy++)
 		{
-			if (line >= size.y) break;
-			drawText("[ ] " + options[line].first, Coordinate{ 0,line }, Coordinate{ size.x,1 }, output_buffer, size);
-			output_buffer[(line * size.x) + 1] = options[line].second ? '*' : ' ';
-			if (line == highlighted_index && enabled)
-				fillColour(focused ? getHighlightedColour() : getUnfocusedColour(), Coordinate{ 0,line }, Coordinate{ size.x,1}, output_buffer, size);
+			// each output pixel covers a block of source pixels, or just one when enlarging
+			int first_row = static_cast<int>((static_cast<int64_t>(dy) * image_size.y) / fitted.y);
+			int end_row = max(first_row + 1, static_cast<int>((static_cast<int64_t>(dy + 1) * image_size.y) / fitted.y));
+			memset(column_sums.data(), 0, column_sums.size() * sizeof(uint32_t));
+			for (int sy = first_row; sy < end_row; sy++) addRow(sy);
+
+			uint32_t* row = scaled.data() + (static_cast<size_t>(dy + offset.y) * area.x) + offset.x;
+			for (int dx = 0; dx < fitted.x; dx++)
+			{
+				int first_column = static_cast<int>((static_cast<int64_t>(dx) * image_size.x) / fitted.x);
+				int end_column = max(first_column + 1, static_cast<int>((static_cast<int64_t>(dx + 1) * image_size.x) / fitted.x));
+				uint64_t sums[4] = { 0, 0, 0, 0 };
+				for (int sx = first_column; sx < end_column; sx++)
+					for (int c = 0; c < 4; c++) sums[c] += column_sums[(sx * 4) + c];
+
+				// blend the average colour onto the background by the average alpha
+				uint64_t full = static_cast<uint64_t>(end_column - first_column) * (end_row - first_row) * 255;
+				uint64_t uncovered = full - sums[3];
+				uint32_t colour = 0;
+				for (int c = 0; c < 3; c++)
+				{
+					uint64_t behind = (background >> (16 - (c * 8))) & 0xFF;
+					uint64_t value = (sums[c] + (behind * uncovered) + (full / 2)) / full;
+					colour |= static_cast<uint32_t>(min(value, static_cast<uint64_t>(255))) << (16 - (c * 8));
+				}
+				row[dx] = colour;
+			}
+		}
+
+		// the top pixel of each cell is the foreground of an upper half block, and the bottom one the background
+		raster.resize(static_cast<size_t>(size.x) * size.y);
+		for (int y = 0; y < size.y; y++)
+		{
+			for (int x = 0; x < size.x; x++)
+			{
+				uint32_t top = scaled[x + (static_cast<size_t>(y * 2) * area.x)];
+				uint32_t bottom = scaled[x + (static_cast<size_t>((y * 2) + 1) * area.x)];
+				uint8_t top_colour = getNearestColour(top);
+				uint8_t bottom_colour = getNearestColour(bottom);
+				Tixel& t = raster[x + (static_cast<size_t>(y) * size.x)];
+				t = Tixel{ };
+				t.character = UNICODE_QUADRANT_TOP;
+				t.colour = static_cast<Tixel::ColourCommand>(top_colour | (bottom_colour << 4));
+#ifndef STUI_TRUECOLOUR
+				if (top_colour == bottom_colour) t.character = ' ';
+#endif
+			}
 		}
+#ifdef STUI_TRUECOLOUR
+		applyTrueColour();
+#endif
 	}
 #endif
 	;
 
-	GETMAXSIZE_STUB { return Coordinate{ -1,-1 }; }
-	GETMINSIZE_STUB { return Coordinate{ 5, static_cast<int>(options.size()) }; }
-
-	ISFOCUSABLE_STUB { return true; }
+#ifdef STUI_TRUECOLOUR
+	// looks up the palette entry for each cell of `raster`, from the colours in `scaled`
+	void applyTrueColour()
+#ifdef STUI_IMPLEMENTATION
+	{
+		raster_true_colour_generation = Tixel::getTrueColourGeneration();
+		for (int y = 0; y < raster_size.y; y++)
+		{
+			const uint32_t* top = scaled.data() + (static_cast<size_t>(y * 2) * raster_size.x);
+			const uint32_t* bottom = top + raster_size.x;
+			Tixel* row = raster.data() + (static_cast<size_t>(y) * raster_size.x);
+			for (int x = 0; x < raster_size.x; x++) row[x].setTrueColour(top[x], bottom[x]);
+		}
+	}
+#endif
+	;
+#endif
 
-	HANDLEINPUT_STUB
+	// adds one row of the source image to `column_sums`, with the colours multiplied by alpha
+	void addRow(int y)
 #ifdef STUI_IMPLEMENTATION
 	{
-		if (!focused || !enabled) return false;
+		uint32_t* sums = column_sums.data();
+		int x = 0;
+		if (format == RGBA)
+		{
+			const uint8_t* source = pixels + (static_cast<size_t>(y) * image_size.x * 4);
+#ifdef STUI_SSE2
+			// four pixels at a time: widen to 16 bits, multiply by alpha (leaving alpha itself alone), then widen again and add
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i colour_lanes = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+			const __m128i alpha_lanes = _mm_set_epi16(1, 0, 0, 0, 1, 0, 0, 0);
+			for (; x + 4 <= image_size.x; x += 4)
+			{
+				__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + (x * 4)));
+				__m128i halves[2] = { _mm_unpacklo_epi8(block, zero), _mm_unpackhi_epi8(block, zero) };
+				for (int h = 0; h < 2; h++)
+				{
+					__m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(halves[h], _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+					alpha = _mm_or_si128(_mm_and_si128(alpha, colour_lanes), alpha_lanes);
+					__m128i weighted = _mm_mullo_epi16(halves[h], alpha);
+					__m128i* first = reinterpret_cast<__m128i*>(sums + ((x + (h * 2)) * 4));
+					_mm_storeu_si128(first, _mm_add_epi32(_mm_loadu_si128(first), _mm_unpacklo_epi16(weighted, zero)));
+					_mm_storeu_si128(first + 1, _mm_add_epi32(_mm_loadu_si128(first + 1), _mm_unpackhi_epi16(weighted, zero)));
+				}
+			}
+#endif
+			for (; x < image_size.x; x++)
+			{
+				const uint8_t* p = source + (x * 4);
+				uint32_t alpha = p[3];
+				sums[(x * 4) + 0] += p[0] * alpha;
+				sums[(x * 4) + 1] += p[1] * alpha;
+				sums[(x * 4) + 2] += p[2] * alpha;
+				sums[(x * 4) + 3] += alpha;
+			}
+		}
+		else if (format == RGB)
+		{
+			const uint8_t* source = pixels + (static_cast<size_t>(y) * image_size.x * 3);
+			for (; x < image_size.x; x++)
+			{
+				const uint8_t* p = source + (x * 3);
+				sums[(x * 4) + 0] += p[0] * 255u;
+				sums[(x * 4) + 1] += p[1] * 255u;
+				sums[(x * 4) + 2] += p[2] * 255u;
+				sums[(x * 4) + 3] += 255u;
+			}
+		}
+		else
+		{
+			const uint8_t* source = pixels + (static_cast<size_t>(y) * image_size.x);
+			for (; x < image_size.x; x++)
+			{
+				uint32_t value = source[x] * 255u;
+				sums[(x * 4) + 0] += value;
+				sums[(x * 4) + 1] += value;
+				sums[(x * 4) + 2] += value;
+				sums[(x * 4) + 3] += 255u;
+			}
+		}
+	}
+#endif
+	;
 
-		if (input_character == Input::ArrowKeys::UP && highlighted_index > 0) highlighted_index--;
-		if (input_character == Input::ArrowKeys::DOWN && highlighted_index + 1 < static_cast<int>(options.size())) highlighted_index++;
-		if (input_character == Input::ArrowKeys::LEFT) highlighted_index = 0;
-		if (input_character == Input::ArrowKeys::RIGHT) highlighted_index = max(0, static_cast<int>(options.size()) - 1);
-		if (input_character == ' ' || input_character == '\n') options[highlighted_index].second = !options[highlighted_index].second;
-		return false;
+	// finds which of the terminal's colours is closest to a 24-bit one, as a foreground `Tixel::ColourCommand`
+	static uint8_t getNearestColour(uint32_t rgb)
+#ifdef STUI_IMPLEMENTATION
+	{
+		// roughly what most terminals show for the colours `Tixel::toANSI` uses
+		static const pair<uint8_t, uint32_t> colours[] =
+		{
+			{ Tixel::FG_BLACK, 0x000000 }, { Tixel::FG_RED, 0xFF5555 }, { Tixel::FG_GREEN, 0x55FF55 },
+			{ Tixel::FG_YELLOW, 0xFFFF55 }, { Tixel::FG_BLUE, 0x5555FF }, { Tixel::FG_MAGENTA, 0xFF55FF },
+			{ Tixel::FG_CYAN, 0x55FFFF }, { Tixel::FG_GRAY, 0x7F7F7F }, { Tixel::FG_WHITE, 0xFFFFFF }
+		};
+		uint8_t nearest = Tixel::FG_BLACK;
+		int nearest_distance = (256 * 256 * 3) + 1;	// further apart than any two colours can be
+		for (const auto& colour : colours)
+		{
+			int distance = 0;
+			for (int shift = 0; shift <= 16; shift += 8)
+			{
+				int difference = static_cast<int>((rgb >> shift) & 0xFF) - static_cast<int>((colour.second >> shift) & 0xFF);
+				distance += difference * difference;
+			}
+			if (distance < nearest_distance) { nearest_distance = distance; nearest = colour.first; }
+		}
+		return nearest;
 	}
 #endif
 	;
 };
 
 /**
- * @brief simple text entry box.
+ * @brief container which limits the maximum size of the child component.
+ * 
+ * the specified `max_size` should probably be at least as large as the minimum
+ * size of the `child`
  **/
-class TextInputBox : public Component, public Utility
+class SizeLimiter : public Component, public Utility
 {
-	size_t cursor_index = 0;
-	int horizontal_scroll = 0;
 public:
-	string text;
-	void (*callback)();
-	bool enabled;
-
-	TextInputBox(string _text, void (*_callback)(), bool _enabled) : text(_text), callback(_callback), enabled(_enabled) { }
-
-	GETTYPENAME_STUB("TextInputBox");
+	Component* child;
+	Coordinate max_size;
+	
+	SizeLimiter(Component* _child, Coordinate _max_size) : child(_child), max_size(_max_size) { }
 
+	GETTYPENAME_STUB("SizeLimiter");
+	
 	RENDER_STUB
 #ifdef STUI_IMPLEMENTATION
 	{
-		if (size.y < 1) return;
+		render(BufferView(output_buffer, size));
+	}
+#endif
+	;
 
-		cursor_index = min(cursor_index, text.length());
-		horizontal_scroll = max(0, (static_cast<int>(cursor_index) - size.x) + 3);
+	RENDERVIEW_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		ensureLayout(target.size);
+		if (getPlacements().empty()) { target.fill(getBlankTixel()); return; }
+		renderChild(child, target);
+	}
+#endif
+	;
 
-		drawText("> " + text, Coordinate{ -horizontal_scroll,0 }, Coordinate{ static_cast<int>(text.length()) + 2,1 }, output_buffer, size);
-		if (enabled) output_buffer[(cursor_index - horizontal_scroll) + 2].colour = focused ? getHighlightedColour() : getUnfocusedColour();
+	LAYOUT_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		placeChild(child, Coordinate{ 0,0 }, size);
 	}
 #endif
 	;
 
-	GETMAXSIZE_STUB { return Coordinate{ -1,1 }; }
-	GETMINSIZE_STUB { return Coordinate{ 6,1 }; }
+	GETMAXSIZE_STUB { return Coordinate{ max_size.x, max_size.y }; }
 
-	HANDLEINPUT_STUB
+	GETMINSIZE_STUB
+	{
+		if (child == nullptr) return Coordinate{ 0,0 };
+		return child->getLayoutMinSize();
+	}
+
+	GETALLCHILDREN_STUB { return (child == nullptr) ? vector<Component*>{ } : vector<Component*>{ child }; }
+	GETCHILDCOUNT_STUB { return (child == nullptr) ? 0 : 1; }
+	GETCHILD_STUB { return (index == 0) ? child : nullptr; }
+
+	/**
+	 * @brief replaces the child. unlike changing `child` directly, this tells any `Page`
+	 * the limiter belongs to about the change.
+	 * 
+	 * @param _child new child. may be null
+	 **/
+	inline void setChild(Component* _child)
+	{
+		if (_child == child) return;
+		Component* old_child = child;
+		child = _child;
+		attachChild(child);
+		detachChild(old_child);
+	}
+};
+
+/**
+ * @brief shows a list of tabs (or just items of any kind really) arranged horizontally,
+ * where the selection can be shown.
+ */
+class TabDisplay : public Component, public Utility
+{
+public:
+	vector<string> tab_descriptions;
+	size_t current_tab;
+
+	TabDisplay(vector<string> _tab_descriptions, size_t _current_tab) : tab_descriptions(_tab_descriptions), current_tab(_current_tab) { }
+
+	GETTYPENAME_STUB("TabDisplay");
+
+	RENDER_STUB
 #ifdef STUI_IMPLEMENTATION
 	{
-		if (!focused || !enabled) return false;
-		if (input_character == '\n') { if (callback != nullptr) callback(); }
-		else if (input_character == Input::ArrowKeys::LEFT) { if (cursor_index > 0) cursor_index--; }
-		else if (input_character == Input::ArrowKeys::RIGHT) { if (cursor_index < text.length()) cursor_index++; }
-		else if (input_character == Input::ArrowKeys::UP) cursor_index = 0;
-		else if (input_character == Input::ArrowKeys::DOWN) cursor_index = text.length();
-		else if (input_character == '\b' || input_character == 127)
-		{ if ((input_character == '\b') ? cursor_index > 0 : (text.length() > 0 && cursor_index < text.length()))
-		{
-			for (size_t first = (input_character == '\b') ? (cursor_index - 1) : cursor_index; first < text.length() - 1; first++)
-				text[first] = text[first + 1];
-			text.pop_back();
-			if (input_character == '\b') cursor_index--;
-		} }
-		else if (input_character == '\t') return false;
-		else
+		if (size.y < 1) return;
+		int offset = 0;
+		for (size_t i = 0; i < tab_descriptions.size(); i++)
 		{
-			text.push_back(' ');
-			for (size_t first = text.length() - 1; first > cursor_index; first--)
-				text[first] = text[first - 1];
-			text[cursor_index] = input_character;
-			cursor_index++;
+			string_view tab_text = scratchJoin({ "[", scratchFormat("%zu", i + 1), " - ", tab_descriptions[i], "]" });
+			drawText(tab_text, Coordinate{ offset,0 }, Coordinate{ size.x,1 }, output_buffer, size);
+			if (i == current_tab)
+				fillColour(getUnfocusedColour(), Coordinate{ offset,0 }, Coordinate{ static_cast<int>(tab_text.length()),1 }, output_buffer, size);
+			offset += static_cast<int>(tab_text.length() + 1);
 		}
+	}
+#endif
+	;
+
+	FIXEDSIZE_STUB(10, 1, -1, 1);
+};
+
+/**
+ * @brief displays a block of text in the center of it's area.
+ * 
+ * does not wrap text, but does respect line breaks using `\n`.
+ **/
+class Banner : public Component, public Utility
+{
+public:
+	string text;
+
+	Banner(string _text) : text(_text) { }
+
+	GETTYPENAME_STUB("Banner");
+
+	RENDER_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		// walk the lines in place, rather than splitting them into new strings
+		string_view remaining = text;
+		int line_count = static_cast<int>(count(remaining.begin(), remaining.end(), '\n')) + 1;
+
+		int y_offset = (size.y - line_count) / 2;
+		while (true)
+		{
+			size_t end = remaining.find('\n');
+			string_view line = remaining.substr(0, end);
+			int x_offset = (size.x - static_cast<int>(line.length())) / 2;
 
-		return true;
+			drawText(line, Coordinate{ x_offset, y_offset }, Coordinate{ size.x, 1 }, output_buffer, size);
+
+			y_offset++;
+			if (end == string_view::npos) break;
+			remaining.remove_prefix(end + 1);
+		}
 	}
 #endif
 	;
 
-	ISFOCUSABLE_STUB { return enabled; }
+	FIXEDSIZE_STUB(4, 1, -1, -1);
 };
 
 /**
- * @brief multi-line wrapping text area. scrollable
- **/
-class TextArea : public Component, public Utility
+ * @brief provides a vertical line which can be placed between two components
+ * arranged next to one another horizontally to separate them visually.
+ */
+class VerticalDivider : public Component
 {
-	int last_rendered_height = 0;
-	int last_lines_of_text = 0;
 public:
-	string text;
-	int scroll;
-
-	TextArea(string _text, int _scroll) : text(_text), scroll(_scroll) { }
+	VerticalDivider() { };
 
-	GETTYPENAME_STUB("TextArea");
+	GETTYPENAME_STUB("VerticalDivider");
 
 	RENDER_STUB
 #ifdef STUI_IMPLEMENTATION
 	{
-		if (size.y < 2 || size.x < 2) return;
+		if (size.x < 1) return;
 
-		last_rendered_height = size.y;
-		last_lines_of_text = (drawTextWrapped(stripNullsAndMore(text, ""), Coordinate{ 0, -scroll }, Coordinate{ size.x - 1, size.y + scroll }, output_buffer, size)).size();
-		scroll = max(0, min(scroll, max(0, last_lines_of_text - last_rendered_height)));
-		
-		output_buffer[(max(0, (int)(((float)scroll / (float)max(0, last_lines_of_text - last_rendered_height)) * (float)(last_rendered_height - 1))) * size.x) + size.x - 1] = Tixel{ '|', focused ? getHighlightedColour() : getUnfocusedColour() };
+		for (int i = 0; i < size.y; i++)
+			output_buffer[i * size.x] = UNICODE_BOXLIGHT_VERTICAL;
 	}
 #endif
 	;
 
-	GETMAXSIZE_STUB { return Coordinate{ -1, -1 }; }
-	GETMINSIZE_STUB { return Coordinate{ 3, 3 }; }
-
-	ISFOCUSABLE_STUB { return true; }
-
-	HANDLEINPUT_STUB
-	{
-		if (!focused) return false;
-
-		if (input_character == Input::ArrowKeys::UP)
-		{
-			if (scroll > 0) scroll--;
-		}
-		else if (input_character == Input::ArrowKeys::DOWN)
-		{
-			if (scroll < last_lines_of_text - last_rendered_height) scroll++;
-		}
-		else return false;
-
-		return true;
-	}
+	FIXEDSIZE_STUB(1, 1, 1, -1);
 };
 
 /**
- * @brief linear progress bar.
- * 
- * progress is expressed as a `fraction` between 0 and 1.
- **/
-class ProgressBar : public Component
+ * @brief provides a horizontal line which can be placed between two components
+ * arranged next to one another vertically to separate them visually.
+ */
+class HorizontalDivider : public Component
 {
 public:
-	float fraction;
-	
-	ProgressBar(float _fraction) : fraction(_fraction) { }
+	HorizontalDivider() { };
 
-	GETTYPENAME_STUB("ProgressBar");
+	GETTYPENAME_STUB("HorizontalDivider");
 
 	RENDER_STUB
 #ifdef STUI_IMPLEMENTATION
 	{
 		if (size.y < 1) return;
 
-		int completed = (int)round((float)size.x * fraction);
-			
 		for (int i = 0; i < size.x; i++)
-			output_buffer[i] = i < completed ? UNICODE_BLOCK : UNICODE_LIGHT_SHADE;
+			output_buffer[i] = UNICODE_BOXLIGHT_HORIZONTAL;
 	}
 #endif
 	;
 
-	GETMAXSIZE_STUB { return Coordinate{ -1, 1 }; }
-	GETMINSIZE_STUB { return Coordinate{ 1, 1 }; }
+	FIXEDSIZE_STUB(1, 1, -1, 1);
 };
 
 /**
- * @brief user-interactible slider widget.
+ * @brief checks whether a `Component` type declares its own `BufferView` version of `render`
+ * (or doesn't declare `render` at all), rather than only the plain `Tixel*` version.
  **/
-class Slider : public Component, public Utility
+template<typename T, typename = void>
+struct DeclaresViewRender : false_type { };
+
+template<typename T>
+struct DeclaresViewRender<T, void_t<decltype(static_cast<void (T::*)(BufferView)>(&T::render))>> : true_type { };
+
+template<typename T>
+inline void Component::renderChildAs(T& child, BufferView target)
 {
-public:
-	float value;
+	if (isMeasuringDraws()) { renderChild(&child, target); return; }
+	if (!startDraw(this, render_pass, &child, target)) return;
+
+	// naming the class skips the vtable, as this is exactly what a virtual call would have reached
+	if constexpr (DeclaresViewRender<T>::value)
+		child.T::render(target);
+	else if (clearForPlainRender(target))
+		child.T::render(target.row(0), target.size);
+	else
+		child.Component::render(target);
+	static_cast<Component&>(child).recordScroll(target);
+}
 
-	Slider(float _value) : value(_value) { }
+/**
+ * @brief wraps a child of a `VBox` or `HBox` to give it a `BoxSizing` at compile time, rather
+ * than the default. use `Fixed`, `Percent` or `Flex` rather than this directly.
+ **/
+template<BoxSizing::Mode M, int V, typename T>
+struct Sized
+{
+	T child;
 
-	GETTYPENAME_STUB("Slider");
+	Sized() : child() { }
+	Sized(T _child) : child(move(_child)) { }
+};
 
-	RENDER_STUB
-#ifdef STUI_IMPLEMENTATION
+template<int N, typename T> using Fixed = Sized<BoxSizing::FIXED, N, T>;			// makes the child exactly `N` cells long
+template<int P, typename T> using Percent = Sized<BoxSizing::PERCENTAGE, P, T>;	// makes the child `P` percent of the length of the box
+template<int W, typename T> using Flex = Sized<BoxSizing::FLEX, W, T>;			// makes the child grow with a weight of `W`
+
+/**
+ * @brief base class of the static layout templates (`VBox`, `HBox` and `Bordered`), which
+ * decides how each kind of child they can hold is measured and drawn.
+ * 
+ * children can either be held by value, in which case their type is known at compile time and
+ * they're drawn with `renderChildAs`, or as a pointer to a `Component` which lives somewhere
+ * else (and may be null), which is drawn like a child of any other container. children whose
+ * sizes never change (those declared with `FIXEDSIZE_STUB`, or static layouts made only of
+ * them) are measured at compile time.
+ **/
+class StaticContainer : public Component, public Utility
+{
+protected:
+	template<typename T>
+	struct ChildTraits
 	{
-		if (size.x < 3 || size.y < 1) return;
+		using type = T;
+		static constexpr BoxSizing sizing{ };
+		static inline T& get(T& child) { return child; }
+	};
 
-		output_buffer[0] = '[';
-		output_buffer[size.x - 1] = ']';
-		for (int x = 1; x < size.x - 1; x++)
-			output_buffer[x] = '-';
-		output_buffer[(int)round(value * (size.x - 2.0f)) + 1].colour = focused ? getHighlightedColour() : getUnfocusedColour();
+	template<BoxSizing::Mode M, int V, typename T>
+	struct ChildTraits<Sized<M, V, T>>
+	{
+		using type = T;
+		static constexpr BoxSizing sizing{ M, V };
+		static inline T& get(Sized<M, V, T>& sized) { return sized.child; }
+	};
+
+	// only true if `T` itself declares a fixed size: a subclass which inherits the constants may
+	// still override `getMinSize` or `getMaxSize`, so it has to be measured through its vtable
+	template<typename T, typename = void>
+	struct HasFixedSize : false_type { };
+
+	template<typename T>
+	struct HasFixedSize<T, void_t<decltype(declval<const T&>().fixedSizeOwner())>>
+		: bool_constant<is_same<decltype(declval<const T&>().fixedSizeOwner()), const T*>::value && T::has_fixed_size> { };
+
+	template<typename T>
+	static constexpr Coordinate fixedMinSizeOf()
+	{
+		if constexpr (HasFixedSize<T>::value) return T::fixed_min_size;
+		else return Coordinate{ 0,0 };
 	}
-#endif
-	;
 
-	GETMAXSIZE_STUB { return Coordinate{ -1,1 }; }
-	GETMINSIZE_STUB { return Coordinate{ 5,1 }; }
+	template<typename T>
+	static constexpr Coordinate fixedMaxSizeOf()
+	{
+		if constexpr (HasFixedSize<T>::value) return T::fixed_max_size;
+		else return Coordinate{ 0,0 };
+	}
 
-	ISFOCUSABLE_STUB { return true; }
+	template<typename T>
+	static inline Coordinate minSizeOf(T& child)
+	{
+		if constexpr (is_pointer<T>::value) return (child == nullptr) ? Coordinate{ 0,0 } : child->getLayoutMinSize();
+		else if constexpr (HasFixedSize<T>::value) return T::fixed_min_size;
+		else return child.getLayoutMinSize();
+	}
 
-	HANDLEINPUT_STUB
-#ifdef STUI_IMPLEMENTATION
+	template<typename T>
+	static inline Coordinate maxSizeOf(T& child)
 	{
-		if (!focused) return false;
-		float difference = 0.0;
-		if (input_character == Input::ArrowKeys::LEFT) difference = -0.01f;
-		if (input_character == Input::ArrowKeys::RIGHT) difference = 0.01f;
-		if (modifiers & Input::ControlKeys::SHIFT) difference *= 5.0f;
-		value = max(0.0f, min(value + difference, 1.0f));
-		return true;
+		if constexpr (is_pointer<T>::value) return (child == nullptr) ? Coordinate{ 0,0 } : child->getLayoutMaxSize();
+		else if constexpr (HasFixedSize<T>::value) return T::fixed_max_size;
+		else return child.getLayoutMaxSize();
 	}
-#endif
-	;
-};
 
-/**
- * @brief simple activity spinner.
- * 
- * described by its `state` (effectively the current animation frame index), and its `type`
- * (style setting between 0 and 3 inclusive).
- **/
-class Spinner : public Component
-{
-	static constexpr int types = 4;
-	static constexpr uint32_t sequences[types][4]
+	template<typename T>
+	static inline Component* pointerTo(T& child)
 	{
-		{ '|', '/', '-', '\\' },
-		{ UNICODE_QUADRANT_LOWERLEFT, UNICODE_QUADRANT_TOPLEFT, UNICODE_QUADRANT_TOPRIGHT, UNICODE_QUADRANT_LOWERRIGHT },
-		{ UNICODE_BOXLIGHT_UP, UNICODE_BOXLIGHT_UPRIGHT, UNICODE_BOXLIGHT_UPRIGHTDOWN, UNICODE_BOXLIGHT_UPRIGHTDOWNLEFT },
-		{ UNICODE_BLOCK_1_8, UNICODE_BLOCK_3_8, UNICODE_BLOCK_6_8, UNICODE_BLOCK }
-	};
-public:
-	size_t state;
-	int type;
+		if constexpr (is_pointer<T>::value) return child;
+		else return &child;
+	}
 
-	Spinner(size_t _state, int _type) : state(_state), type(_type) { }
+	template<typename T>
+	inline void renderStaticChild(T& child, BufferView target)
+	{
+		if constexpr (is_pointer<T>::value)
+		{
+			if (child == nullptr) target.fill(getBlankTixel());
+			else renderChild(child, target);
+		}
+		else renderChildAs(child, target);
+	}
 
-	GETTYPENAME_STUB("Spinner");
+	/**
+	 * @brief combines the sizes of a list of children placed one after another, in the same way as
+	 * `VerticalBox` (if `vertical` is true) or `HorizontalBox`.
+	 * 
+	 * @returns the minimum size of the list, followed by its maximum size
+	 **/
+	template<size_t N>
+	static constexpr array<Coordinate, 2> stackSizes(const array<Coordinate, N>& min_sizes, const array<Coordinate, N>& max_sizes, const array<BoxSizing, N>& sizing, bool vertical)
+	{
+		array<Coordinate, 2> result{ };
+		int& min_along = vertical ? result[0].y : result[0].x;
+		int& min_across = vertical ? result[0].x : result[0].y;
+		int& max_along = vertical ? result[1].y : result[1].x;
+		int& max_across = vertical ? result[1].x : result[1].y;
+		for (size_t i = 0; i < N; i++)
+		{
+			int c_min_along = vertical ? min_sizes[i].y : min_sizes[i].x;
+			int c_max_along = vertical ? max_sizes[i].y : max_sizes[i].x;
+			int c_min_across = vertical ? min_sizes[i].x : min_sizes[i].y;
+			int c_max_across = vertical ? max_sizes[i].x : max_sizes[i].y;
+			sizing[i].apply(-1, c_min_along, c_max_along);
+
+			min_along += c_min_along;
+			if (c_min_across > min_across) min_across = c_min_across;
+			if (c_max_along == -1) max_along = -1;
+			else if (max_along != -1) max_along += c_max_along;
+			if (max_across != -1 && (c_max_across > max_across || c_max_across == -1))
+				max_across = c_max_across;
+		}
 
-	RENDER_STUB
-#ifdef STUI_IMPLEMENTATION
+		return result;
+	}
+
+	template<typename... Children>
+	static constexpr array<Coordinate, 2> stackFixedSizes(bool vertical)
 	{
-		output_buffer[0] = sequences[type % types][state % 4];
+		return stackSizes<sizeof...(Children)>(
+			{ fixedMinSizeOf<typename ChildTraits<Children>::type>()... },
+			{ fixedMaxSizeOf<typename ChildTraits<Children>::type>()... },
+			{ ChildTraits<Children>::sizing... }, vertical);
 	}
-#endif
-	;
 
-	GETMAXSIZE_STUB { return Coordinate{ 1, 1 }; }
-	GETMINSIZE_STUB { return Coordinate{ 1, 1 }; }
+	static constexpr Coordinate addBorder(Coordinate size)
+	{
+		return Coordinate{ (size.x == -1) ? -1 : size.x + 2, (size.y == -1) ? -1 : size.y + 2 };
+	}
 };
 
 /**
- * @brief vertical layout box containing a list of child widgets.
+ * @brief layout box whose children are fixed at compile time, laid out exactly as `VerticalBox`
+ * (if `VERTICAL` is true) or `HorizontalBox` lay out theirs. use it through `VBox` and `HBox`.
  * 
- * the layout algorithm will attempt to meet the minimum sizes of all children first, then
- * expand each element one-by-one until they either meet their max height or there's no more
- * space to expand into. ensures minimum widths for all elements.
+ * each type in `Children` is either a `Component` type, in which case that child is held inside
+ * the box, a pointer to a `Component` which lives elsewhere (see `setChild`), or one of those
+ * wrapped in `Fixed`, `Percent` or `Flex` to give it a `BoxSizing`. boxes of boxes can be nested
+ * to describe a whole interface as a single type, for example:
+ * 
+ * `VBox<Bordered<ListView>, HBox<Fixed<12, Button>, TextInputBox>, Component*>`
+ * 
+ * since the type of every child is known, drawing one doesn't go through its vtable, and the
+ * compiler is free to inline the whole tree into the box's `render`. if every child's size is
+ * fixed too, the box's own size is worked out at compile time (see `FIXEDSIZE_STUB`). the
+ * children are laid out in the same way as the dynamic boxes, and drawn with the same caching,
+ * so a static layout can be swapped for the equivalent `VerticalBox` and `HorizontalBox` tree
+ * (or the other way around) without the output changing.
+ * 
+ * do not move or copy a box once it has been drawn or added to a `Page`, since the children
+ * live inside it.
  **/
-class VerticalBox : public Component, public Utility
+template<bool VERTICAL, typename... Children>
+class StaticBox : public StaticContainer
 {
+	static_assert(sizeof...(Children) > 0, "a static box needs at least one child");
+
 public:
-	vector<Component*> children;
-	
-	VerticalBox(vector<Component*> _children) : children(_children) { }
-	
-	GETTYPENAME_STUB("VerticalBox");
+	static constexpr size_t child_count = sizeof...(Children);
+	static constexpr bool has_fixed_size = (HasFixedSize<typename ChildTraits<Children>::type>::value && ...);
+	static constexpr Coordinate fixed_min_size = stackFixedSizes<Children...>(VERTICAL)[0];
+	static constexpr Coordinate fixed_max_size = stackFixedSizes<Children...>(VERTICAL)[1];
+	auto fixedSizeOwner() const -> decltype(this);
+
+	tuple<Children...> children;
+
+	StaticBox() { }
+	StaticBox(Children... _children) : children(move(_children)...) { }
+
+	GETTYPENAME_STUB(VERTICAL ? "VBox" : "HBox");
+
+	/**
+	 * @brief get one of the children, without any `Fixed`, `Percent` or `Flex` wrapped around it.
+	 * 
+	 * @returns reference to the child (or to the pointer to it)
+	 **/
+	template<size_t I>
+	inline auto& get() { return ChildTraits<tuple_element_t<I, tuple<Children...>>>::get(std::get<I>(children)); }
+
+	/**
+	 * @brief replaces a child which is held by pointer. unlike assigning to it through `get`, this
+	 * tells any `Page` the box belongs to about the change.
+	 * 
+	 * @param _child new child. may be null
+	 **/
+	template<size_t I, typename T>
+	inline void setChild(T* _child)
+	{
+		auto& slot = get<I>();
+		static_assert(is_pointer<remove_reference_t<decltype(slot)>>::value, "only children held by pointer can be replaced");
+		if (slot == _child) return;
+		Component* old_child = slot;
+		slot = _child;
+		attachChild(slot);
+		detachChild(old_child);
+	}
 
 	RENDER_STUB
-#ifdef STUI_IMPLEMENTATION
-	{	
-		vector<int> min_heights(children.size());
-		vector<int> max_heights(children.size());
-		vector<int> calculated_heights(children.size());
-		int total_height = 0;
-		for (size_t i = 0; i < children.size(); i++)
-		{
-			min_heights[i] = children[i]->getMinSize().y;
-			max_heights[i] = children[i]->getMaxSize().y;
-			calculated_heights[i] = min_heights[i];
-			total_height += calculated_heights[i];
-		}
+	{
+		render(BufferView(output_buffer, size));
+	}
+
+	LAYOUT_STUB
+	{
+		vector<int>& min_lengths = layout_scratch.min_sizes;
+		vector<int>& max_lengths = layout_scratch.max_sizes;
+		vector<int>& weights = layout_scratch.weights;
+		vector<int>& calculated_lengths = layout_scratch.sizes;
+		min_lengths.resize(child_count);
+		max_lengths.resize(child_count);
+		weights.resize(child_count);
+		forEachChild([&](auto& child, BoxSizing sizing, size_t i)
+			{
+				min_lengths[i] = along(minSizeOf(child));
+				max_lengths[i] = along(maxSizeOf(child));
+				weights[i] = sizing.apply(along(size), min_lengths[i], max_lengths[i]);
+			});
+
+		overflowed = !distributeSpace(along(size), min_lengths, max_lengths, weights, calculated_lengths);
+		if (overflowed) return;
 
-		int budget = size.y - total_height;
-		if (budget < 0)
+		int offset = 0;
+		forEachChild([&](auto& child, BoxSizing, size_t i)
+			{
+				int max_across = across(maxSizeOf(child));
+				int length_across = (max_across == -1) ? across(size) : min(across(size), max_across);
+				child_offsets[i] = VERTICAL ? Coordinate{ 0,offset } : Coordinate{ offset,0 };
+				child_sizes[i] = VERTICAL ? Coordinate{ length_across,calculated_lengths[i] } : Coordinate{ calculated_lengths[i],length_across };
+				placeChild(pointerTo(child), child_offsets[i], child_sizes[i]);
+				offset += calculated_lengths[i];
+			});
+	}
+
+	RENDERVIEW_STUB
+	{
+		if (!target.isValid()) return;
+		Coordinate size = target.size;
+		ensureLayout(size);
+
+		if (overflowed)
 		{
-			string error_text = "[...]";
-			if (size.y > 0)
-				drawText(error_text, Coordinate{ static_cast<int>(size.x - error_text.size()) / 2, static_cast<int>(size.y) / 2 }, Coordinate{ size.x, 1 }, output_buffer, size);
+			target.fill(getBlankTixel());
+			string_view error_text = "[...]";
+			if (VERTICAL && size.y > 0)
+				drawText(error_text, Coordinate{ static_cast<int>(size.x - error_text.size()) / 2, static_cast<int>(size.y) / 2 }, Coordinate{ size.x, 1 }, target);
 			return;
 		}
 
-		while (budget > 0)
-		{
-			for (size_t i = 0; i < children.size(); i++)
+		// parallel rendering can only hand children over from `renderChildren`
+		bool measuring = isMeasuringDraws();
+		if (measuring) renderChildren(target);
+		forEachChild([&](auto& child, BoxSizing, size_t i)
 			{
-				if (calculated_heights[i] >= max_heights[i] && max_heights[i] != -1) continue;
+				BufferView view = target.subView(child_offsets[i], child_sizes[i]);
+				if (pointerTo(child) == nullptr) view.fill(getBlankTixel());
+				else if (!measuring) renderStaticChild(child, view);
 
-				calculated_heights[i]++;
-
-				budget--;
-				if (budget == 0) break;
-			}
-		}
+				// children don't necessarily cover the whole area, so clear whatever is left over
+				if (VERTICAL)
+					target.subView(Coordinate{ child_sizes[i].x,child_offsets[i].y }, Coordinate{ size.x - child_sizes[i].x,child_sizes[i].y }).fill(getBlankTixel());
+				else
+					target.subView(Coordinate{ child_offsets[i].x,child_sizes[i].y }, Coordinate{ child_sizes[i].x,size.y - child_sizes[i].y }).fill(getBlankTixel());
+			});
+		int end = along(child_offsets[child_count - 1]) + along(child_sizes[child_count - 1]);
+		if (VERTICAL) target.subView(Coordinate{ 0,end }, Coordinate{ size.x,size.y - end }).fill(getBlankTixel());
+		else target.subView(Coordinate{ end,0 }, Coordinate{ size.x - end,size.y }).fill(getBlankTixel());
+	}
 
-		int y_offset = 0;
-		for (size_t i = 0; i < children.size(); i++)
-		{
-			Coordinate component_size{ children[i]->getMaxSize().x == -1 ? size.x : min(size.x, children[i]->getMaxSize().x), calculated_heights[i] };
-			Tixel* component_buffer = makeBuffer(component_size);
-			children[i]->render(component_buffer, component_size);
-			copyBox(component_buffer, component_size, Coordinate{ 0,0 }, component_size, output_buffer, size, Coordinate{ 0,y_offset });
-			delete[] component_buffer;
-			y_offset += component_size.y;
-		}
+	GETMINSIZE_STUB
+	{
+		if constexpr (has_fixed_size) return fixed_min_size;
+		else return stackChildSizes(index_sequence_for<Children...>{ })[0];
 	}
-#endif
-	;
 
 	GETMAXSIZE_STUB
 	{
-		Coordinate max_size{ 0,0 };
-		for (Component* child : children)
-		{
-			Coordinate c_max = child->getMaxSize();
-			if (max_size.x != -1 && (c_max.x > max_size.x || c_max.x == -1))
-				max_size.x = c_max.x;
+		if constexpr (has_fixed_size) return fixed_max_size;
+		else return stackChildSizes(index_sequence_for<Children...>{ })[1];
+	}
+
+	GETALLCHILDREN_STUB
+	{
+		vector<Component*> all;
+		forEachChild([&](auto& child, BoxSizing, size_t) { if (pointerTo(child) != nullptr) all.push_back(pointerTo(child)); });
+		return all;
+	}
+	GETCHILDCOUNT_STUB { return child_count; }
+	GETCHILD_STUB
+	{
+		Component* found = nullptr;
+		forEachChild([&](auto& child, BoxSizing, size_t i) { if (i == index) found = pointerTo(child); });
+		return found;
+	}
+
+private:
+	bool overflowed = false;				// the children didn't fit during the last layout pass
+	BoxLayoutScratch layout_scratch;
+	array<Coordinate, sizeof...(Children)> child_offsets{ };	// where each child was placed during the last layout pass
+	array<Coordinate, sizeof...(Children)> child_sizes{ };	// size allocated to each child during the last layout pass
+
+	static constexpr int along(Coordinate c) { return VERTICAL ? c.y : c.x; }
+	static constexpr int across(Coordinate c) { return VERTICAL ? c.x : c.y; }
+
+	template<typename F>
+	inline void forEachChild(F&& function) { forEachChild(function, index_sequence_for<Children...>{ }); }
+
+	template<typename F, size_t... I>
+	inline void forEachChild(F& function, index_sequence<I...>) { (function(get<I>(), ChildTraits<Children>::sizing, I), ...); }
+
+	template<size_t... I>
+	inline array<Coordinate, 2> stackChildSizes(index_sequence<I...>)
+	{
+		return stackSizes<child_count>({ minSizeOf(get<I>())... }, { maxSizeOf(get<I>())... }, { ChildTraits<Children>::sizing... }, VERTICAL);
+	}
+};
+
+template<typename... Children> using VBox = StaticBox<true, Children...>;	// static version of `VerticalBox`, see `StaticBox`
+template<typename... Children> using HBox = StaticBox<false, Children...>;	// static version of `HorizontalBox`, see `StaticBox`
+
+/**
+ * @brief static version of `BorderedBox`, which holds its child (of type `T`) inside it, or
+ * points to it if `T` is a pointer. see `StaticBox`.
+ **/
+template<typename T>
+class Bordered : public StaticContainer
+{
+public:
+	static constexpr bool has_fixed_size = HasFixedSize<T>::value;
+	static constexpr Coordinate fixed_min_size = addBorder(fixedMinSizeOf<T>());
+	static constexpr Coordinate fixed_max_size = addBorder(fixedMaxSizeOf<T>());
+	auto fixedSizeOwner() const -> decltype(this);
+
+	T child;
+	string name;
+
+	Bordered() : child() { }
+	Bordered(T _child, string _name = "") : child(move(_child)), name(_name) { }
+
+	GETTYPENAME_STUB("Bordered");
+
+	RENDER_STUB
+	{
+		render(BufferView(output_buffer, size));
+	}
+
+	RENDERVIEW_STUB
+	{
+		if (!target.isValid()) return;
+		Coordinate size = target.size;
+		if (size.x < 3 || size.y < 3) { target.fill(getBlankTixel()); return; }
+		drawBox(Coordinate{ 0,0 }, size, target);
+		if (name.size() > 0)
+			drawText(name, Coordinate{ 3,0 }, Coordinate{ size.x - 6,1 }, target);
 
-			if (c_max.y == -1) max_size.y = -1;
-			else if (max_size.y != -1)
-				max_size.y += c_max.y;
-		}
+		ensureLayout(size);
+		BufferView inside = target.subView(Coordinate{ 1,1 }, Coordinate{ size.x - 2, size.y - 2 });
+		if (getPlacements().empty()) { inside.fill(getBlankTixel()); return; }
+		renderStaticChild(child, inside);
+	}
 
-		return max_size;
+	LAYOUT_STUB
+	{
+		if (size.x < 3 || size.y < 3) return;
+		placeChild(pointerTo(child), Coordinate{ 1,1 }, Coordinate{ size.x - 2, size.y - 2 });
 	}
 
 	GETMINSIZE_STUB
 	{
-		Coordinate min_size{ 0,0 };
-		for (Component* child : children)
-		{
-			Coordinate c_min = child->getMinSize();
-			if (c_min.x > min_size.x)
-				min_size.x = c_min.x;
-
-			min_size.y += c_min.y;
-		}
+		if constexpr (has_fixed_size) return fixed_min_size;
+		else return addBorder(minSizeOf(child));
+	}
 
-		return min_size;
+	GETMAXSIZE_STUB
+	{
+		if constexpr (has_fixed_size) return fixed_max_size;
+		else return addBorder(maxSizeOf(child));
 	}
 
-	GETALLCHILDREN_STUB { return children; }
+	GETALLCHILDREN_STUB { return (pointerTo(child) == nullptr) ? vector<Component*>{ } : vector<Component*>{ pointerTo(child) }; }
+	GETCHILDCOUNT_STUB { return (pointerTo(child) == nullptr) ? 0 : 1; }
+	GETCHILD_STUB { return (index == 0) ? pointerTo(child) : nullptr; }
 };
 
 /**
- * @brief horizontal layout box containing a list of child widgets.
- * 
- * the layout algorithm will attempt ot meet the minimum sizes of all children first, then
- * expand each element one-by-one until they either meet their max width or there's no more
- * space to expand into. ensures minimum heights for all elements.
+ * @brief purely static class which encapsulates code for rendering a page
+ * to the terminal. a page just consists of a `Component` tree
+ *
  **/
-class HorizontalBox : public Component, public Utility
+class Renderer : public Utility
 {
 public:
-	vector<Component*> children;
-	
-	HorizontalBox(vector<Component*> _children) : children(_children) { }
+	/**
+	 * @brief describes the output produced by the most recent call to `render`.
+	 *
+	 * useful for checking how much data is actually being sent to the terminal
+	 * each frame.
+	 **/
+	struct RenderStats
+	{
+		size_t bytes_emitted;	// number of bytes written to the terminal
+		size_t cells_changed;	// number of cells which differed from the previous frame
+		size_t spans_emitted;	// number of separate runs of cells which were written
+		bool full_repaint;		// whether the entire screen was repainted
+		size_t allocations;		// number of heap allocations made while drawing, only counted if `STUI_COUNT_ALLOCATIONS` is defined
+		size_t rows_scrolled;	// number of rows which the terminal was asked to move, rather than being sent again
+	};
 
-	GETTYPENAME_STUB("HorizontalBox");
+	/**
+	 * @brief draws a `Component` into the terminal via `std::cout`.
+	 *
+	 * if the `Component` has children, their drawing will be handled automatically
+	 * by the `Component` itself. the root `Component` is always drawn to fill the
+	 * terminal.
+	 *
+	 * the previous frame is kept, and only cells which have changed since then are
+	 * sent to the terminal. the whole screen is cleared and repainted on the first
+	 * frame, after the terminal is resized, or after `requestFullRepaint` is called.
+	 *
+	 * @param root_component element to draw into the terminal
+	 **/
+	static void render(Component* root_component);
 
-	RENDER_STUB
-#ifdef STUI_IMPLEMENTATION
-	{
-		vector<int> min_widths(children.size());
-		vector<int> max_widths(children.size());
-		vector<int> calculated_widths(children.size());
-		int total_width = 0;
-		for (size_t i = 0; i < children.size(); i++)
-		{
-			min_widths[i] = children[i]->getMinSize().x;
-			max_widths[i] = children[i]->getMaxSize().x;
-			calculated_widths[i] = min_widths[i];
-			total_width += calculated_widths[i];
-		}
+	/**
+	 * @brief draws a `Component` into several `Session`s' terminals (see the other version of
+	 * `render`). sessions which are the same size are all sent the same frame, so the tree is
+	 * only laid out and drawn once for each different size. the active session is left
+	 * unchanged afterwards.
+	 *
+	 * @param root_component element to draw
+	 * @param sessions sessions to draw into. null means the process's own terminal
+	 **/
+	static void render(Component* root_component, const vector<class Session*>& sessions);
 
-		int budget = size.x - total_width;
-		if (budget < 0) return;
+	/**
+	 * @brief forces the next call to `render` to clear and repaint the entire
+	 * terminal, rather than only the cells which have changed.
+	 *
+	 * you should call this if something other than the `Renderer` has drawn
+	 * into the terminal.
+	 **/
+	static void requestFullRepaint();
 
-		while (budget > 0)
-		{
-			for (size_t i = 0; i < children.size(); i++)
-			{
-				if (calculated_widths[i] >= max_widths[i] && max_widths[i] != -1) continue;
+	/**
+	 * @brief get statistics about the output of the most recent frame.
+	 *
+	 * @returns information about the last call to `render`
+	 **/
+	static RenderStats getLastRenderStats();
 
-				calculated_widths[i]++;
+	/**
+	 * @brief turns cached rendering on or off. it is off by default.
+	 *
+	 * with caching on, the output of each `Component` is kept between frames, and a
+	 * `Component` is only drawn again if it (or something inside it) has been marked
+	 * as changed with `Component::markDirty`, or if it has moved. this makes the cost of
+	 * a frame depend on how much has changed, rather than on how big the UI is, but
+	 * it means you must call `markDirty` on any `Component` whose properties you
+	 * change yourself.
+	 *
+	 * @param enabled whether or not caching should be used
+	 **/
+	static void enableCaching(bool enabled);
 
-				budget--;
-				if (budget == 0) break;
-			}
-		}
+	/**
+	 * @brief turns parallel rendering on or off. it is off by default.
+	 *
+	 * with parallel rendering on, the children of `VerticalBox`, `HorizontalBox` (and any
+	 * other container which uses `Component::renderChildren`) which took a while to draw
+	 * during the last frame are drawn on a pool of threads at the same time. the output is
+	 * exactly the same as drawing them one after another.
+	 *
+	 * this means `render` functions, and anything they call (such as `TreeView::load_children`
+	 * or `ListView::get_item`), may run on a thread other than the one which called
+	 * `Renderer::render`, so they mustn't touch anything shared without locking it. components
+	 * which appear more than once in the tree are always drawn on the calling thread, and
+	 * while the `Profiler` is enabled everything is drawn on the calling thread.
+	 *
+	 * @param enabled whether or not parallel rendering should be used
+	 * @param threads how many threads to start, or 0 to use one fewer than the number of cores
+	 * @param cost_threshold how long, in seconds, a child must have taken to draw before it is
+	 * worth handing to another thread
+	 **/
+	static void enableParallelRendering(bool enabled, size_t threads = 0, float cost_threshold = 0.0005f);
 
-		int x_offset = 0;
-		for (size_t i = 0; i < children.size(); i++)
-		{
-			Coordinate component_size{ calculated_widths[i], children[i]->getMaxSize().y == -1 ? size.y : min(size.y, children[i]->getMaxSize().y) };
-			Tixel* component_buffer = makeBuffer(component_size);
-			children[i]->render(component_buffer, component_size);
-			copyBox(component_buffer, component_size, Coordinate{ 0,0 }, component_size, output_buffer, size, Coordinate{ x_offset,0 });
-			delete[] component_buffer;
-			x_offset += component_size.x;
-		}
-	}
-#endif
-	;
+	/**
+	 * @brief turns hardware scrolling on or off. it is on by default.
+	 *
+	 * when a scrollable `Component` (one which calls `Component::reportScroll`, such as
+	 * `ListView`, `TextArea`, `LogView`, or `TreeView`) is drawn in the same place as last
+	 * frame but scrolled, the rows it covers are moved by the terminal itself, using a scroll
+	 * region, so only the rows which have come into view need to be sent. this is only done
+	 * when it sends less than just sending the changed cells would, and the result is the same
+	 * either way. turn it off for terminals which don't support scroll regions.
+	 *
+	 * @param enabled whether or not hardware scrolling should be used
+	 **/
+	static void enableHardwareScrolling(bool enabled);
 
-	GETMAXSIZE_STUB
-	{
-		Coordinate max_size{ 0,0 };
-		for (Component* child : children)
-		{
-			Coordinate c_max = child->getMaxSize();
-			if (c_max.x == -1) max_size.x = -1;
-			else if (max_size.x != -1)
-				max_size.x += c_max.x;
+	/**
+	 * @brief turns drawing straight into the console's screen buffer on or off, on Windows. it
+	 * is on by default, unless `STUI_TRUECOLOUR` is defined.
+	 *
+	 * with it on, the changed parts of each frame are copied into the console with
+	 * `WriteConsoleOutputW` instead of being sent as text and escape codes, which the console
+	 * would otherwise have to spend far longer reading back. the console can only show the
+	 * 16 colours, underlining and reversed colours this way, so 24-bit colours and the other
+	 * attributes are lost, and characters outside the Basic Multilingual Plane are shown as a
+	 * replacement character. hardware scrolling isn't used, since it needs escape codes. when
+	 * stdout isn't a console, or the console won't accept the frame, escape codes are used
+	 * instead, in a single write. this does nothing elsewhere.
+	 *
+	 * @param enabled whether or not frames should be written to the console directly
+	 **/
+	static void enableNativeConsoleOutput(bool enabled);
 
-			if (max_size.y != -1 && (c_max.y > max_size.y || c_max.y == -1))
-				max_size.y = c_max.y;
-		}
+	/**
+	 * @brief check for queued input, handle shortcut triggers, and send remaining
+	 * input to the specified component. order of input event is preserved.
+	 *
+	 * each key is looked up in the focused component's `keymap`, then in `keymap`,
+	 * then in the global keymap, and the first one with a binding consumes it. only
+	 * keys which aren't bound anywhere reach the component.
+	 *
+	 * @param focused_component component to send input to
+	 * @param keymap shortcuts which apply regardless of focus, usually a `Page`'s. may be null
+	 **/
+	static bool handleInput(Component* focused_component, const Keymap* keymap = nullptr);
 
-		return max_size;
-	}
+	/**
+	 * @brief check for queued input, handle shortcut triggers, and send remaining
+	 * input to the specified component. order of input event is preserved.
+	 *
+	 * the shortcuts in the list are checked before any keymaps. this has to look through
+	 * the whole list for every key, so a `Keymap` is better if you have lots of them.
+	 *
+	 * @param focused_component component to send input to
+	 * @param shortcut_bindings list of shortcuts to check for
+	 * @param keymap shortcuts to check after the list (see the other version of `handleInput`). may be null
+	 **/
+	static bool handleInput(Component* focused_component, const vector<Input::Shortcut>& shortcut_bindings, const Keymap* keymap = nullptr);
 
-	GETMINSIZE_STUB
+	/**
+	 * @brief get the keymap which is checked last by `handleInput`, for shortcuts which should
+	 * work on every `Page`.
+	 *
+	 * @returns the global keymap
+	 **/
+	static Keymap& getGlobalKeymap();
+
+	/**
+	 * @brief stores information about a frame-wait which just happened
+	 *
+	 **/
+	struct FrameData
 	{
-		Coordinate min_size{ 0,0 };
-		for (Component* child : children)
-		{
-			Coordinate c_min = child->getMinSize();
-			min_size.x += c_min.x;
+		float delta_time;		// time since the last time `targetFramerate` was called
+		float active_fraction;	// fraction of the delta_time which was taken up by rendering
+	};
 
-			if (c_min.y > min_size.y)
-				min_size.y = c_min.y;
-		}
+	/**
+	 * @brief maintains the desired framerate by waiting for the remainder of the frame's
+	 * duration.
+	 *
+	 * requires a variable in which to store the last time the function was called in order
+	 * to work correctly.
+	 *
+	 * @param fps desired framerate in frames per second
+	 * @param last_frame_time persistent storage for the time the function was last called
+	 * @return information about the frame: the delta time since the previous call, and
+	 * the fraction of the delta time which was taken up by the time between calls (the
+	 * remaining fraction being occupied by the `targetFramerate` function idling)
+	 **/
+	static FrameData targetFramerate(int fps, clock_type::time_point& last_frame_time);
 
-		return min_size;
-	}
+private:
+	/**
+	 * @brief calculate an appropriate size for a `Component` (or, one dimension of it)
+	 *
+	 * @param available amount of space available to use
+	 * @param max maximum desired size of the subject
+	 * @param min minimum desired size of the subject
+	 * @return resulting constrained size
+	 **/
+	static inline int getConstrainedSize(int available, int _max, int _min);
 
-	GETALLCHILDREN_STUB { return children; }
+	/**
+	 * @brief converts a range of `Tixel`s into characters and colour escape codes,
+	 * and appends them to an output string.
+	 *
+	 * style state is tracked across calls via `style`, so escape codes are only
+	 * emitted when the style actually changes, and set the foreground and background
+	 * together in a single sequence.
+	 *
+	 * @param tixels first `Tixel` to transcode
+	 * @param count number of `Tixel`s to transcode
+	 * @param output string to append the transcoded output to
+	 * @param style the style (see `Tixel::getStyle`) the terminal is currently using
+	 **/
+	static inline void transcode(const Tixel* tixels, size_t count, string& output, uint32_t& style);
+
+	/**
+	 * @brief appends the escape code which switches the terminal to a new style.
+	 *
+	 * @param style style to switch to (see `Tixel::getStyle`)
+	 * @param previous_style style the terminal is currently using
+	 * @param output string to append the escape code to
+	 **/
+	static inline void appendStyle(uint32_t style, uint32_t previous_style, string& output);
+
+	/**
+	 * @brief moves rows of the terminal (and of the previous frame, to match) for each area which
+	 * scrolled during the last draw, wherever that means fewer cells need to be sent.
+	 *
+	 * @param screen_size size of the frame surface and previous frame
+	 * @param output string to append the scrolling escape codes to
+	 **/
+	static void applyScrolling(Coordinate screen_size, string& output);
+
+#if defined(_WIN32)
+	/**
+	 * @brief copies whatever has changed in the frame surface since the previous frame into the
+	 * console's screen buffer, one rectangle for each run of rows containing changes.
+	 *
+	 * @param screen_size size of the frame surface
+	 * @param full_repaint whether the whole frame should be copied
+	 * @returns false if the console wouldn't accept the frame, in which case escape codes
+	 * should be used instead
+	 **/
+	static bool presentToConsole(Coordinate screen_size, bool full_repaint);
+#endif
 };
 
-/**
- * @brief blank spacing element which fills a set amount of space vertically.
- **/
-class VerticalSpacer : public Component
+#if defined(__linux__)
+#ifdef STUI_IMPLEMENTATION
+static termios original_termios;
+static bool linux_resized_triggered = true;
+static int wakeup_pipe[2] = { -1, -1 };	// written to by the resize handler and `Terminal::postWakeup`
+#endif
+#elif defined(_WIN32)
+#ifdef STUI_IMPLEMENTATION
+static HANDLE wakeup_event = nullptr;	// signalled by `Terminal::postWakeup`
+static DWORD original_input_mode = 0;
+static DWORD original_output_mode = 0;
+static bool console_output = false;		// stdout is a console, rather than a file or pipe
+#endif
+#endif
+
+#ifdef STUI_IMPLEMENTATION
+static void (*exit_callback)() = nullptr;
+static Keymap global_keymap;					// checked after every other keymap by `Renderer::handleInput`
+
+static Tixel* frame_surface = nullptr;
+static Coordinate frame_surface_size{ 0,0 };
+static Component* last_root_component = nullptr;
+static Tixel* previous_frame = nullptr;
+static Coordinate previous_frame_size{ 0,0 };
+static bool full_repaint_requested = true;
+static Renderer::RenderStats last_render_stats{ 0, 0, 0, false, 0, 0 };
+
+static string terminal_output;				// bytes waiting to be sent to the terminal
+static bool terminal_output_held = false;	// a frame is being assembled, so don't send anything yet
+static bool synchronized_output = false;	// the terminal supports synchronized update mode (DEC mode 2026)
+static Coordinate session_checked_size{ -1,-1 };		// size the active session was last seen at by `Terminal::isTerminalResized`
+static uint64_t presented_surface_version = 0;			// version of the frame surface `previous_frame` is up to date with
+#ifdef STUI_TRUECOLOUR
+static size_t presented_true_colour_generation = 0;		// palette generation `previous_frame` was drawn with
+#endif
+static uint64_t surface_version = 0;					// changes every time something is drawn into the frame surface
+static bool reuse_frame_surface = false;				// the frame surface already holds this frame, so `render` only needs to send it
+
+// preformatted `ESC[fg;bgm` sequences for every possible `ColourCommand`
+static const struct SGRTable
 {
-public:
-	int height;
-	
-	VerticalSpacer(int _height) : height(_height) { }
+	struct Entry
+	{
+		char bytes[11];
+		uint8_t length;
+	} entries[256];
 
-	GETTYPENAME_STUB("VerticalSpacer");
+	SGRTable()
+	{
+		for (int c = 0; c < 256; c++)
+		{
+			string sequence = "\033[" + to_string(Tixel::toANSI((Tixel::ColourCommand)(c & Tixel::ColourCommand::FG_WHITE)))
+				+ ';' + to_string(Tixel::toANSI((Tixel::ColourCommand)(c & Tixel::ColourCommand::BG_WHITE))) + 'm';
+			memcpy(entries[c].bytes, sequence.data(), sequence.size());
+			entries[c].length = static_cast<uint8_t>(sequence.size());
+		}
+	}
+} sgr_table;
+#endif
 
-	GETMAXSIZE_STUB { return Coordinate{ 1, height }; }
-	GETMINSIZE_STUB { return Coordinate{ 1, max(height, 0) }; }
-};
+static string default_banner = string("Simple Text UI  Copyright (C) 2024  Jacob Costen\nThis program comes with ABSOLUTELY NO WARRANTY.\nThis is free software, and you are welcome to redistribute it\nunder certain conditions; see the license for details.");
 
 /**
- * @brief blank spacing element which fills a set amount of space horizontally.
+ * @brief everything STUI keeps about one terminal: where output goes, the last frame sent to
+ * it (to compare the next one against), and the input which has been half-read from it. the
+ * active `Session`'s state lives in the `Renderer` and `Terminal` themselves, and is swapped
+ * into its `SessionState` when another one is activated.
  **/
-class HorizontalSpacer : public Component
+struct SessionState
 {
-public:
-	int width;
-	
-	HorizontalSpacer(int _width) : width(_width) { }
-
-	GETTYPENAME_STUB("HorizontalSpacer");
-
-	GETMAXSIZE_STUB { return Coordinate{ width, 1 }; }
-	GETMINSIZE_STUB { return Coordinate{ max(width, 0), 1 }; }
+	TerminalBackend* backend = nullptr;
+	Tixel* previous_frame = nullptr;
+	Coordinate previous_frame_size{ 0,0 };
+	bool full_repaint_requested = true;
+	Renderer::RenderStats last_render_stats{ 0, 0, 0, false, 0, 0 };
+	uint64_t presented_surface_version = 0;	// version of the frame surface `previous_frame` was last brought up to date with
+#ifdef STUI_TRUECOLOUR
+	size_t presented_true_colour_generation = 0;	// palette generation `previous_frame` was drawn with
+#endif
+	string output;
+	bool synchronized_output = false;
+	Coordinate checked_size{ -1,-1 };			// size `Terminal::isTerminalResized` last saw
+	string input_pending;
+	bool input_in_paste = false;
+	string input_paste;
+	clock_type::time_point input_paste_updated;
+	vector<string> input_pasted_text;
+	size_t input_pasted_taken = 0;
+	bool input_stalled = false;
 };
 
 /**
- * @brief draws a border around another component using IBM box characters.
+ * @brief one of several terminals being drawn to by the same process, like a viewer connected
+ * over a socket. each session has its own size, output, input, and record of what's on its
+ * screen, but they all draw the same components.
+ * 
+ * activate one with `Terminal::setSession`, after which `Renderer::render`,
+ * `Renderer::handleInput`, and the rest of `Terminal` act on that session's terminal. to draw
+ * the same UI to many sessions at once, use the version of `Renderer::render` which takes a
+ * list; sessions which are the same size share one layout and drawing pass.
  **/
-class BorderedBox : public Component, public Utility
+class Session
 {
-public:
-	Component* child;
-	string name;
-
-	BorderedBox(Component* _child, string _name) : child(_child), name(_name) { }
-
-	GETTYPENAME_STUB("BorderedBox");
-
-	RENDER_STUB
-#ifdef STUI_IMPLEMENTATION
-	{
-		if (size.x < 3 || size.y < 3) return;
-		drawBox(Coordinate{ 0,0 }, size, output_buffer, size);
-		if (name.size() > 0)
-			drawText(name, Coordinate{ 3,0 }, Coordinate{ size.x - 6,1 }, output_buffer, size);
-		if (child == nullptr) return;
-
-		Coordinate component_size{ size.x - 2, size.y - 2 };
-		Tixel* component_buffer = makeBuffer(component_size);
-		child->render(component_buffer, component_size);
-		copyBox(component_buffer, component_size, Coordinate{ 0,0 }, component_size, output_buffer, size, Coordinate{ 1,1 });
-		delete[] component_buffer;
-	}
-#endif
-	;
+	friend class Terminal;
 
-	GETMAXSIZE_STUB
-	{
-		if (child == nullptr) return Coordinate{ 2,2 };
-		Coordinate max_size = child->getMaxSize();
-		if (max_size.x != -1) max_size.x += 2;
-		if (max_size.y != -1) max_size.y += 2;
-		return max_size;
-	}
-	GETMINSIZE_STUB { return (child == nullptr) ? Coordinate{ 2,2 } : Coordinate{ child->getMinSize().x + 2, child->getMinSize().y + 2 }; }
+	SessionState state;
+	
+public:
+	/**
+	 * @param _backend where the session's output goes, and input comes from. this must
+	 * outlive the session
+	 **/
+	Session(TerminalBackend* _backend) { state.backend = _backend; }
+	~Session();
+
+	Session(Session& other) = delete;
+	Session operator=(Session& other) = delete;
 
-	GETALLCHILDREN_STUB { return { child }; }
+	/**
+	 * @brief makes the next frame drawn to this session repaint the whole screen.
+	 **/
+	void requestFullRepaint();
 };
 
+#ifdef STUI_IMPLEMENTATION
+static Session* active_session = nullptr;			// session whose state is currently in use, or null for the process's own terminal
+static SessionState default_session_state;			// the process's own terminal's state, while another session is active
+#endif
+
 /**
- * @brief element which displays a list of strings.
- * 
- * allows scrolling.
+ * @brief encapsulates some functionality relating to control of the terminal window.
  * 
- **/
-class ListView : public Component, public Utility
+ * before you start drawing things using `Renderer`, you should definitely call `configure`,
+ * although it's not strictly necessary.
+ */
+class Terminal
 {
-	int last_render_height = 0;
-
-public:
-	vector<string> elements;
-	int scroll;
-	int selected_index;
+	friend class Renderer;
+	friend class Input;
 
-	ListView(vector<string> _elements, int _scroll, int _selected_index) : elements(_elements), scroll(_scroll), selected_index(_selected_index) { }
+private:
+	/**
+	 * @brief queue bytes to be sent to the terminal. they're sent straight away, unless a frame
+	 * is being drawn, in which case they're sent along with the rest of the frame.
+	 * 
+	 * @param data bytes to send
+	 **/
+	static void writeOutput(const string& data);
 
-	GETTYPENAME_STUB("ListView");
+	/**
+	 * @brief send everything queued by `writeOutput` to the terminal in a single write.
+	 **/
+	static void flushOutput();
 
-	RENDER_STUB
+	/**
+	 * @brief asks the terminal whether it supports synchronized update mode (DEC mode 2026),
+	 * which lets a whole frame be shown at once instead of being drawn as it arrives.
+	 * 
+	 * any other input which arrives while waiting for the answer is discarded.
+	 * 
+	 * @returns true if the terminal reported that the mode is supported
+	 **/
+	static bool querySynchronizedOutput()
 #ifdef STUI_IMPLEMENTATION
 	{
-		if (size.x < 2 || size.y < 2) return;
-		last_render_height = size.y;
-		int row = -1 - scroll;
-		int index = -1;
-		selected_index = max(min(selected_index, static_cast<int>(elements.size()) - 1), 0);
-		for (string element : elements)
+#if defined(__linux__)
+		if (!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO)) return false;
+
+		// the mode request is followed by a primary device attributes request, which every
+		// terminal answers, so we know when to stop waiting even if the first one is ignored
+		writeOutput("\033[?2026$p\033[c");
+		string received;
+		string input;
+		bool supported = false;
+		bool answered = false;
+		auto deadline = clock_type::now() + chrono::milliseconds(200);
+		while (!answered)
 		{
-			index++;
-			row++;
-			if (row < 0) continue;
-			if (row >= size.y) break;
-
-			if ((row == 0 && index != 0) || (row == size.y - 1 && index != static_cast<int>(elements.size()) - 1))
-				output_buffer[row * size.x] = UNICODE_ELLIPSIS_VERTICAL;
-			else
+			int remaining = static_cast<int>(chrono::duration_cast<chrono::milliseconds>(deadline - clock_type::now()).count());
+			pollfd poll_fd{ STDIN_FILENO, POLLIN, 0 };
+			if (remaining <= 0 || poll(&poll_fd, 1, remaining) <= 0) break;
+
+			char buffer[64];
+			ssize_t bytes = read(STDIN_FILENO, buffer, sizeof(buffer));
+			if (bytes <= 0) break;
+			received.append(buffer, static_cast<size_t>(bytes));
+
+			// pick out the replies (`ESC[?2026;N$y` and `ESC[?...c`). anything else was typed while
+			// we waited, and is kept as input
+			size_t i = 0;
+			while (i < received.size() && !answered)
 			{
-				drawText(stripNullsAndMore(element, "\n\t"), Coordinate{ 0, row }, Coordinate{ size.x, 1 }, output_buffer, size);
-				string index_str = " (" + to_string(index) + ")";
-				drawText(index_str, Coordinate{ size.x - static_cast<int>(index_str.length()), row }, Coordinate{ size.x, 1 }, output_buffer, size);
+				size_t prefix = min<size_t>(3, received.size() - i);
+				if (received.compare(i, prefix, "\033[?", prefix) != 0)
+				{
+					input += received[i++];
+					continue;
+				}
+				size_t end = i + 3;
+				while (end < received.size() && ((received[end] >= '0' && received[end] <= '9') || received[end] == ';' || received[end] == '$')) end++;
+				if (end >= received.size()) break;
+				if (received[end] == 'c') answered = true;
+				else if (received[end] == 'y')
+				{
+					string_view mode(received.data() + i, end + 1 - i);
+					supported = mode == "\033[?2026;1$y" || mode == "\033[?2026;2$y";
+				}
+				else input.append(received, i, end + 1 - i);
+				i = end + 1;
 			}
+			received.erase(0, i);
 		}
-		
-		fillColour(focused ? getHighlightedColour() : getUnfocusedColour(), Coordinate{ 0, selected_index - scroll }, Coordinate{ size.x,1 }, output_buffer, size);
+
+		input += received;
+		input_pending += input;
+		return supported;
+#else
+		return false;
+#endif
 	}
 #endif
 	;
 
-	GETMAXSIZE_STUB { return Coordinate{ -1, -1 }; }
-	GETMINSIZE_STUB { return Coordinate{ 10, 3 }; }
+public:
+	static void configure(string banner_text = "", float banner_duration_seconds = 3.0f)
+#ifdef STUI_IMPLEMENTATION
+	{
+		ios_base::sync_with_stdio(false);
+		isTerminalResized();
+#ifdef DEBUG
+		debug_log.open("stui_debug.log");
+		DEBUG_LOG("STUI logging started");
+#endif
+#if defined(_WIN32)
+		SetConsoleCtrlHandler(windowsControlHandler, true);
+		// resizes are reported as input events, and escape codes are used when not drawing to the console directly
+		HANDLE input = GetStdHandle(STD_INPUT_HANDLE);
+		HANDLE output = GetStdHandle(STD_OUTPUT_HANDLE);
+		if (GetConsoleMode(input, &original_input_mode))
+			SetConsoleMode(input, original_input_mode | ENABLE_WINDOW_INPUT);
+		console_output = GetConsoleMode(output, &original_output_mode) != 0;
+		if (console_output)
+			SetConsoleMode(output, original_output_mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING | DISABLE_NEWLINE_AUTO_RETURN);
+#elif defined(__linux__)
+		signal(SIGINT, linuxControlHandler);
+		signal(SIGQUIT, linuxControlHandler);
+		signal(SIGTSTP, linuxControlHandler);
+		signal(SIGWINCH, linuxResizeHandler);
+		termios new_termios;
+		tcgetattr(STDIN_FILENO, &new_termios);
+		tcgetattr(STDIN_FILENO, &original_termios);
+
+		new_termios.c_iflag &= ~(IGNBRK | BRKINT | IXON);
+		new_termios.c_lflag &= ~(ICANON | ECHO);
+        new_termios.c_cc[VMIN] = 1;
+		// ctrl+z (and ctrl+y, where it's a delayed suspend) arrive as keys instead of stopping the program
+		new_termios.c_cc[VSUSP] = _POSIX_VDISABLE;
+#ifdef VDSUSP
+		new_termios.c_cc[VDSUSP] = _POSIX_VDISABLE;
+#endif
+		tcsetattr(STDIN_FILENO, TCSANOW, &new_termios);
+		// ask for pasted text to be marked, so it can be handled in one go
+		writeOutput("\033[?2004h");
+#endif
+		synchronized_output = querySynchronizedOutput();
+		createWakeupSignal();
+		Banner b(banner_text + "\n\nusing\n" + default_banner);
+		BorderedBox bb(&b, "");
+		Renderer::render(&bb);
+		this_thread::sleep_for(chrono::duration<float>(banner_duration_seconds));
+	}
+#endif
+	;
 
-	ISFOCUSABLE_STUB { return true; }
+	static void registerExitCallback(void (*callback)())
+#ifdef STUI_IMPLEMENTATION
+	{
+		exit_callback = callback;
+	}
+#endif
+	;
 
-	HANDLEINPUT_STUB
+	static void unConfigure(bool clear_terminal)
 #ifdef STUI_IMPLEMENTATION
 	{
-		if (input_character == Input::ArrowKeys::DOWN && selected_index < static_cast<int>(elements.size()) - 1)
+		// if we were interrupted in the middle of a frame, throw it away
+		if (terminal_output_held)
 		{
-			selected_index++;
-			if (selected_index - scroll >= last_render_height - 1 && (static_cast<int>(elements.size()) - scroll > last_render_height))
-				scroll++;
+			terminal_output.clear();
+			terminal_output_held = false;
+			if (synchronized_output) writeOutput("\033[?2026l");
 		}
-		else if (input_character == Input::ArrowKeys::UP && selected_index > 0)
+		setCursorVisible(true);
+#if defined(__linux__)
+		writeOutput("\033[?2004l");
+		tcsetattr(STDIN_FILENO, TCSANOW, &original_termios);
+#endif
+		if (clear_terminal)
 		{
-			selected_index--;
-			if (selected_index - scroll < 1 && scroll > 0)
-				scroll--;
+			clear();
+			setCursorPosition(Coordinate{ 0,0 });
 		}
-		else return false;
-
-		return true;
+		else
+			setCursorPosition(Coordinate{ 0,getScreenSize().y + 1 });
+#if defined(_WIN32)
+		// the escape codes above still need the console's terminal mode, so it's put back last
+		if (original_input_mode != 0) SetConsoleMode(GetStdHandle(STD_INPUT_HANDLE), original_input_mode);
+		if (console_output) SetConsoleMode(GetStdHandle(STD_OUTPUT_HANDLE), original_output_mode);
+#endif
+#ifdef DEBUG
+		DEBUG_LOG("STUI logging stopped");
+		DEBUG_LOG("timing data:\n\trender:\t\t\t" + to_string(debug_timing.d_render) + "\t\t" + to_string(debug_timing.i_render) + "\t\t" + to_string(debug_timing.d_render / debug_timing.i_render)
+		                    + "\n\ttranscoding:\t" + to_string(debug_timing.d_transcoding) + "\t\t" + to_string(debug_timing.i_transcoding) + "\t\t" + to_string(debug_timing.d_transcoding / debug_timing.i_transcoding)
+		                    + "\n\tmakebuffer:\t\t" + to_string(debug_timing.d_makebuffer) + "\t\t" + to_string(debug_timing.i_makebuffer) + "\t\t" + to_string(debug_timing.d_makebuffer / debug_timing.i_makebuffer)
+		                    + "\n\tcopybuffer:\t\t" + to_string(debug_timing.d_copybuffer) + "\t\t" + to_string(debug_timing.i_copybuffer) + "\t\t" + to_string(debug_timing.d_copybuffer / debug_timing.i_copybuffer)
+		                    + "\n\tdrawtext:\t\t" + to_string(debug_timing.d_drawtext) + "\t\t" + to_string(debug_timing.i_drawtext) + "\t\t" + to_string(debug_timing.d_drawtext / debug_timing.i_drawtext)
+				);
+		
+		debug_log.close();
+#endif
 	}
 #endif
 	;
-};
-
-/**
- * @brief complex display element capable of visualising tree structures as a heirarchy
- * with nested, expandable nodes.
- * 
- * nodes can be given a descriptive name, and an identifier (which could be used to
- * index into your own array of proprietary nodes). expansion of nodes can be toggled;
- * if a node is expanded then its children will be shown, otherwise they will not.
- **/
-class TreeView : public Component, public Utility
-{
-	int last_render_height = 0;
 
-public:
-	struct Node
+	/**
+	 * @brief sends everything which would have been written to the terminal somewhere else,
+	 * like a `VirtualTerminal`, and takes the screen size from there too. input still comes from
+	 * the real terminal, unless the backend `providesInput`. the next frame is drawn from scratch.
+	 * 
+	 * this changes the backend of the active `Session`.
+	 * 
+	 * @param backend where to send output, or null to go back to the real terminal
+	 **/
+	static void setBackend(TerminalBackend* backend)
+#ifdef STUI_IMPLEMENTATION
 	{
-		string name = "empty tree node";
-		vector<Node*> children;
-		uint32_t id = 0;
-		bool expanded = true;
-	};
-
-	Node* root;
-	size_t scroll;
-	size_t selected_index = 0;
-
-	TreeView(Node* _root, size_t _scroll, size_t _selected_index) : root(_root), scroll(_scroll), selected_index(_selected_index) { }
-
-	GETTYPENAME_STUB("TreeView");
+		flushOutput();
+		terminal_backend = backend;
+		Renderer::requestFullRepaint();
+#if defined(__linux__)
+		linux_resized_triggered = true;
+#endif
+	}
+#endif
+	;
 
-	RENDER_STUB
+	/**
+	 * @returns the backend output is being sent to, or null if it's going to the real terminal
+	 **/
+	static TerminalBackend* getBackend()
 #ifdef STUI_IMPLEMENTATION
 	{
-		if (size.x < 2 || size.y < 2) return;
-		last_render_height = size.y;
-		if (root == nullptr)
-		{
-			fillColour(focused ? getHighlightedColour() : getUnfocusedColour(), Coordinate{ 0,0, }, Coordinate{ size.x,1 }, output_buffer, size);
-			return;
-		}
-		int top = 0 - static_cast<int>(scroll);
-		printNode(root, 0, top, output_buffer, size, false);
+		return terminal_backend;
 	}
 #endif
 	;
 
-	GETMAXSIZE_STUB { return Coordinate{ -1, -1 }; }
-	GETMINSIZE_STUB { return Coordinate{ 10, 3 }; }
-
-	ISFOCUSABLE_STUB { return true; }
-
-	HANDLEINPUT_STUB
+	/**
+	 * @brief makes a different `Session` the one which is drawn to and read from. anything
+	 * waiting to be written to the previous one is sent first.
+	 * 
+	 * @param session session to switch to, or null for the process's own terminal
+	 **/
+	static void setSession(Session* session)
 #ifdef STUI_IMPLEMENTATION
 	{
-		if (!focused) return false;
-
-		vector<Node*> parents;
-		vector<size_t> indices_within_parents;
-		int actual_offset;
-		Node* node = findNodeWithID(selected_index, parents, indices_within_parents, actual_offset);
-		if (node == nullptr)
-		{
-			if (root != nullptr) selected_index = root->id;
-			return true;
-		}
-
-		if (input_character == Input::ArrowKeys::DOWN)
-		{
-			size_t steps_up = 0;
-
-			Node* tmp_parent = node;
-			size_t next_index = 0;
-			while (!(tmp_parent->children.size() > next_index && tmp_parent->expanded))
-			{
-				steps_up++;
-				if (steps_up > parents.size()) return true;
-				tmp_parent = parents[parents.size() - steps_up];
-				next_index = indices_within_parents[parents.size() - steps_up] + 1;
-			}
-			if (steps_up == 0)
-				selected_index = tmp_parent->children[0]->id;
-			else
-				selected_index = tmp_parent->children[next_index]->id;
-			
-			if (actual_offset - static_cast<int>(scroll) >= last_render_height)
-				scroll++;
-		}
-		else if (input_character == Input::ArrowKeys::UP)
-		{
-			if (parents.size() < 1) return true;
-			else if (indices_within_parents[parents.size() - 1] == 0)
-				selected_index = parents[parents.size() - 1]->id;
-			else
-			{
-				Node* tmp_parent = parents[parents.size() - 1]->children[indices_within_parents[parents.size() - 1] - 1];
-				while (tmp_parent->expanded && tmp_parent->children.size() > 0)
-					tmp_parent = tmp_parent->children[tmp_parent->children.size() - 1];
-				selected_index = tmp_parent->id;
-			}
-
-			if (actual_offset - static_cast<int>(scroll) <= 0 && scroll > 0)
-				scroll--;
-		}
-		else if (input_character == Input::ArrowKeys::RIGHT)
-		{
-			node->expanded = true;
-		}
-		else if (input_character == Input::ArrowKeys::LEFT)
-		{
-			node->expanded = false;
-		}
-		else return false;
-
-		return true;
+		if (session == active_session) return;
+		flushOutput();
+		// the active session's state is always the one in use, so swap it back out, then swap the new one in
+		swapSessionState((active_session == nullptr) ? default_session_state : active_session->state);
+		swapSessionState((session == nullptr) ? default_session_state : session->state);
+		active_session = session;
 	}
 #endif
 	;
 
-private:
-	inline Node* findNodeWithID(uint32_t id, vector<Node*>& parents, vector<size_t>& indices, int& actual_offset)
-	{
-		Node* current_node = root;
-		parents.clear();
-		indices.clear();
-		actual_offset = 0;
-		if (root == nullptr) return nullptr;
-		int level = 0;
-		int parent_expansion_level = root->expanded ? 0 : -1;
-		while (current_node->id != id)
-		{
-		// TODO: actual_offset is still not correct
-			if (!current_node->children.empty())
-			{
-				parents.push_back(current_node);
-				indices.push_back(0);
-				level++;
-				current_node = current_node->children[0];
+	/**
+	 * @returns the active `Session`, or null if it's the process's own terminal
+	 **/
+	static Session* getSession()
+#ifdef STUI_IMPLEMENTATION
+	{
+		return active_session;
+	}
+#endif
+	;
 
-				if (parent_expansion_level == (level - 1))
-				{
-					actual_offset++;
-					if (current_node->expanded)
-						parent_expansion_level++;
-				}
-			}
-			else
-			{
-				if (level == 0) return nullptr;
-				if (indices[level - 1] < parents[level - 1]->children.size() - 1)
-				{
-					indices[level - 1]++;
-					if (parent_expansion_level == level)
-					{
-						if (current_node->expanded)
-							parent_expansion_level--;
-					}
-					
-					if (parent_expansion_level == (level - 1))	
-						actual_offset++;
-
-					current_node = parents[level - 1]->children[indices[level - 1]];
-					
-					if (parent_expansion_level == (level - 1) && current_node->expanded)
-						parent_expansion_level++;
-				}
-				else
-				{
-					if (parent_expansion_level == level)
-					{
-						actual_offset++;
-						if (current_node->expanded)
-							parent_expansion_level--;
-					}
-					level--;
-					indices.pop_back();
-					parents.pop_back();
-				}
-			}
+	static bool isTerminalResized()
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (active_session != nullptr)
+		{
+			// sessions don't get resize signals, so just see if the size is different
+			Coordinate size = getScreenSize();
+			bool resized = size.x != session_checked_size.x || size.y != session_checked_size.y;
+			session_checked_size = size;
+			return resized;
 		}
-
-		return current_node;
+#if defined(_WIN32)
+		// the console reports resizes of its buffer as input events, picked out as the input is read.
+		// with a scrollback buffer, resizing only the window doesn't send one, so look at that too
+		Input::readAvailableInput();
+		bool resized = windows_resized_triggered;
+		windows_resized_triggered = false;
+		Coordinate size, origin;
+		if (readConsoleWindow(size, origin))
+		{
+			if (size.x != windows_screen_size.x || size.y != windows_screen_size.y) resized = true;
+			windows_screen_size = size;
+		}
+		return resized;
+#elif defined(__linux__)
+		bool resized = linux_resized_triggered;
+		linux_resized_triggered = false;
+		return resized;
+#endif
 	}
+#endif
+	;
 
-	void printNode(Node* node, int depth, int& top, Tixel* output_buffer, Coordinate buffer_size, bool more_to_draw_after)
+private:
+	/**
+	 * @brief exchanges everything which belongs to one terminal with the contents of `state`.
+	 **/
+	static void swapSessionState(SessionState& state)
 #ifdef STUI_IMPLEMENTATION
 	{
-		if (top >= buffer_size.y) return;
+		swap(state.backend, terminal_backend);
+		swap(state.previous_frame, previous_frame);
+		swap(state.previous_frame_size, previous_frame_size);
+		swap(state.full_repaint_requested, full_repaint_requested);
+		swap(state.last_render_stats, last_render_stats);
+		swap(state.presented_surface_version, presented_surface_version);
+#ifdef STUI_TRUECOLOUR
+		swap(state.presented_true_colour_generation, presented_true_colour_generation);
+#endif
+		swap(state.output, terminal_output);
+		swap(state.synchronized_output, synchronized_output);
+		swap(state.checked_size, session_checked_size);
+		swap(state.input_pending, input_pending);
+		swap(state.input_in_paste, input_in_paste);
+		swap(state.input_paste, input_paste);
+		swap(state.input_paste_updated, input_paste_updated);
+		swap(state.input_pasted_text, input_pasted_text);
+		swap(state.input_pasted_taken, input_pasted_taken);
+		swap(state.input_stalled, input_stalled);
+	}
+#endif
+	;
 
-		if (top >= 0)
-		{
-			if (top == buffer_size.y - 1 && more_to_draw_after)
-			{
-				output_buffer[top * buffer_size.x] = UNICODE_ELLIPSIS_VERTICAL;
-			}
-			else
-			{
-				drawText((node->expanded ? "  " : "> ") + stripNullsAndMore(node->name, "\n\t"), Coordinate{ depth, top }, Coordinate{ buffer_size.x - 2 - depth, 1 }, output_buffer, buffer_size);
-				for (int i = 0; i < depth; i++) output_buffer[i + (top * buffer_size.x)] = '|';
-				if (node->expanded) output_buffer[depth + (top * buffer_size.x)] = UNICODE_NOT;
-				string id_desc = " [" + to_string(node->children.size()) + "]";
-				drawText(id_desc, Coordinate{ buffer_size.x - (int)id_desc.length(), top }, Coordinate{ (int)id_desc.length(), 1 }, output_buffer, buffer_size);
-			}
-			if (selected_index == node->id)
-				fillColour(focused ? getHighlightedColour() : getUnfocusedColour(), Coordinate{ 0,top, }, Coordinate{ buffer_size.x,1 }, output_buffer, buffer_size);
-		}
-		if (node->expanded)
+#if defined(_WIN32)
+	static int WINAPI windowsControlHandler(DWORD control_type) noexcept
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (control_type == 0)
 		{
-			for (size_t i = 0; i < node->children.size(); i++)
-			{
-				top++;
-				printNode(node->children[i], depth + 1, top, output_buffer, buffer_size, more_to_draw_after || (i != node->children.size() - 1));
-			}
+			commonExitHandler();
 		}
+
+		return 1;
 	}
 #endif
 	;
-};
-
-/**
- * @brief complex display element capable of displaying simple low-resolution grayscale
- * images.
- * 
- * images will be displayed at twice the width they are stored at to compensate for the
- * aspect ratio of terminal characters. each pixel should be described by a single byte.
- * the size of the image buffer must be allocated to match the image size parameter.
- **/
-class ImageView : public Component
-{
-public:
-	uint8_t* grayscale_image;
-	Coordinate image_size;
-	
-	ImageView(uint8_t* _grayscale_image, Coordinate _image_size) : grayscale_image(_grayscale_image), image_size(_image_size) { }
-	
-	GETTYPENAME_STUB("ImageView");
 
-	RENDER_STUB
+#elif defined(__linux__)
+	static void linuxControlHandler(int control_type)
 #ifdef STUI_IMPLEMENTATION
 	{
-		if (grayscale_image == nullptr) return;
+		commonExitHandler();
+	}
+#endif
+	;
 
-		for (int y = 0; y < size.y; y++)
+	static void linuxResizeHandler(int s)
+#ifdef STUI_IMPLEMENTATION
+	{
+		DEBUG_LOG("screen resized");
+		linux_resized_triggered = true;
+		if (wakeup_pipe[1] >= 0)
 		{
-			for (int x = 0; x < size.x; x++)
-			{
-				uint32_t out = ' ';
-				uint8_t in = grayscale_image[(x / 2) + (y * image_size.x)];
-				if (in >= 192) out = UNICODE_BLOCK;
-				else if (in >= 128) out = UNICODE_DARK_SHADE;
-				else if (in >= 96) out = UNICODE_MID_SHADE;
-				else if (in >= 64) out = UNICODE_LIGHT_SHADE;
-				else if (in >= 32) out = UNICODE_MIDDLE_DOT;
-				else out = ' ';
-				output_buffer[x + (y * size.x)] = out;
-			}
+			int saved_errno = errno;
+			char c = 'r';
+			ssize_t ignored = write(wakeup_pipe[1], &c, 1);
+			(void)ignored;
+			errno = saved_errno;
 		}
 	}
 #endif
 	;
 
-	GETMAXSIZE_STUB { return Coordinate{ image_size.x * 2, image_size.y }; }
-	GETMINSIZE_STUB { return Coordinate{ 1, 1 }; }
-};
-
-/**
- * @brief container which limits the maximum size of the child component.
- * 
- * the specified `max_size` should probably be at least as large as the minimum
- * size of the `child`
- **/
-class SizeLimiter : public Component
-{
-public:
-	Component* child;
-	Coordinate max_size;
-	
-	SizeLimiter(Component* _child, Coordinate _max_size) : child(_child), max_size(_max_size) { }
+#endif
 
-	GETTYPENAME_STUB("SizeLimiter");
-	
-	RENDER_STUB
+	static void commonExitHandler()
 #ifdef STUI_IMPLEMENTATION
 	{
-		if (child == nullptr) return;
-		child->render(output_buffer, size);
+		unConfigure(true);
+		if (exit_callback != nullptr)
+			exit_callback();
+		exit(0);
 	}
 #endif
 	;
 
-	GETMAXSIZE_STUB { return Coordinate{ max_size.x, max_size.y }; }
-
-	GETMINSIZE_STUB
+	/**
+	 * @brief clear the entire terminal, including scrollback and onscreen buffers
+	 **/
+	static inline void clear()
 	{
-		if (child == nullptr) return Coordinate{ 0,0 };
-		return child->getMinSize();
+		ostringstream sequence;
+		sequence << ANSI_CLEAR_SCREEN << ANSI_CLEAR_SCROLL;
+		writeOutput(sequence.str());
+		Renderer::requestFullRepaint();
 	}
 
-	GETALLCHILDREN_STUB { return { child }; }
-};
-
-/**
- * @brief shows a list of tabs (or just items of any kind really) arranged horizontally,
- * where the selection can be shown.
- */
-class TabDisplay : public Component, public Utility
-{
-public:
-	vector<string> tab_descriptions;
-	size_t current_tab;
-
-	TabDisplay(vector<string> _tab_descriptions, size_t _current_tab) : tab_descriptions(_tab_descriptions), current_tab(_current_tab) { }
-
-	GETTYPENAME_STUB("TabDisplay");
-
-	RENDER_STUB
+	/**
+	 * @brief get the size of the terminal window in characters
+	 * 
+	 * @return size of the terminal window 
+	 **/
+	static Coordinate getScreenSize()
 #ifdef STUI_IMPLEMENTATION
 	{
-		if (size.y < 1) return;
-		int offset = 0;
-		for (size_t i = 0; i < tab_descriptions.size(); i++)
+		if (terminal_backend != nullptr) return terminal_backend->getSize();
+#if defined(_WIN32)
+		// kept up to date by `isTerminalResized` and resize events, either of which may forget it
+		if (windows_screen_size.x < 0)
 		{
-			string tab_text = "[" + to_string(i+1) + " - " + tab_descriptions[i] + "]";
-			drawText(tab_text, Coordinate{ offset,0 }, Coordinate{ size.x,1 }, output_buffer, size);
-			if (i == current_tab)
-				fillColour(getUnfocusedColour(), Coordinate{ offset,0 }, Coordinate{ static_cast<int>(tab_text.length()),1 }, output_buffer, size);
-			offset += static_cast<int>(tab_text.length() + 1);
+			Coordinate origin;
+			if (!readConsoleWindow(windows_screen_size, origin)) return Coordinate{ 0,0 };
 		}
+		return windows_screen_size;
+#elif defined(__linux__)
+		struct winsize size;
+		ioctl(STDOUT_FILENO, TIOCGWINSZ, &size);
+		return Coordinate{ (int)size.ws_col, (int)size.ws_row };
+#endif
 	}
 #endif
 	;
 
-	GETMAXSIZE_STUB { return Coordinate{ -1,1 }; }
-	GETMINSIZE_STUB { return Coordinate{ 10,1 }; }
-};
+	/**
+	 * @brief move the cursor to a given position in the terminal window
+	 * 
+	 * @param position desired position of the cursor
+	 **/
+	static inline void setCursorPosition(Coordinate position)
+	{
+		ostringstream sequence;
+		sequence << ANSI_SET_CURSOR(position.x, position.y);
+		writeOutput(sequence.str());
+	}
 
-/**
- * @brief displays a block of text in the center of it's area.
- * 
- * does not wrap text, but does respect line breaks using `\n`.
- **/
-class Banner : public Component, public Utility
-{
-public:
-	string text;
+	/**
+	 * @brief toggle terminal cursor visibility
+	 * 
+	 * @param visible whether or not the cursor should be visible
+	 **/
+	static inline void setCursorVisible(bool visible)
+	{
+#if defined(_WIN32)
+		CONSOLE_CURSOR_INFO info;
+		GetConsoleCursorInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info);
+		info.bVisible = visible;
+		SetConsoleCursorInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info);
+#elif defined(__linux__)
+		ostringstream sequence;
+		if (visible) sequence << ANSI_SHOW_CURSOR;
+		else sequence << ANSI_HIDE_CURSOR;
+		writeOutput(sequence.str());
+#endif
+	}
 
-	Banner(string _text) : text(_text) { }
+	/**
+	 * @brief forces the current terminal to respect UTF-8
+	 */
+	static inline void enableUTF8()
+	{
+#if defined(_WIN32)
+		SetConsoleOutputCP(CP_UTF8);
+#endif
+	}
 
-	GETTYPENAME_STUB("Banner");
+public:
+	/**
+	 * @brief enumerates the reasons `waitForEvents` can return for. more than one may be
+	 * or-ed together.
+	 **/
+	enum WaitResult : uint8_t
+	{
+		TIMEOUT	= 0b000,
+		INPUT	= 0b001,
+		RESIZE	= 0b010,
+		WAKEUP	= 0b100
+	};
 
-	RENDER_STUB
+	/**
+	 * @brief sleeps until there is input waiting to be read, the terminal is resized,
+	 * `postWakeup` is called, or the timeout runs out, whichever comes first.
+	 * 
+	 * unlike polling in a loop with `Renderer::targetFramerate`, this uses no CPU time
+	 * at all while nothing is happening.
+	 * 
+	 * @param timeout_seconds maximum time to wait for, or a negative number to wait forever
+	 * 
+	 * @returns the reasons for waking up
+	 **/
+	static WaitResult waitForEvents(float timeout_seconds = -1.0f)
 #ifdef STUI_IMPLEMENTATION
 	{
-		vector<string> lines = splitString(text, '\n');
-
-		int y_offset = (size.y - static_cast<int>(lines.size())) / 2;
-		for (string line : lines)
+		createWakeupSignal();
+		uint8_t result = TIMEOUT;
+#if defined(_WIN32)
+		HANDLE handles[2] = { GetStdHandle(STD_INPUT_HANDLE), wakeup_event };
+		auto deadline = clock_type::now() + chrono::duration_cast<clock_type::duration>(chrono::duration<float>(max(0.0f, timeout_seconds)));
+		// anything read already, but not yet handled, doesn't need waiting for
+		if (!input_records.empty()) result |= INPUT;
+		if (windows_resized_triggered) result |= RESIZE;
+		while (result == TIMEOUT)
 		{
-			int x_offset = (size.x - static_cast<int>(line.length())) / 2;
-
-			drawText(line, Coordinate{ x_offset, y_offset }, Coordinate{ size.x, 1 }, output_buffer, size);
-
-			y_offset++;
+			DWORD timeout = INFINITE;
+			if (timeout_seconds >= 0.0f)
+			{
+				auto remaining = chrono::duration_cast<chrono::milliseconds>(deadline - clock_type::now()).count();
+				timeout = static_cast<DWORD>(max(static_cast<decltype(remaining)>(0), remaining));
+			}
+			DWORD signalled = WaitForMultipleObjects(2, handles, false, timeout);
+			if (signalled == WAIT_OBJECT_0 + 1) result |= WAKEUP;
+			else if (signalled != WAIT_OBJECT_0) break;
+			else
+			{
+				// the input handle is also signalled by resizes and by events which are
+				// ignored (such as the mouse), which are read now so it stops being signalled
+				if (Input::readAvailableInput() || !input_records.empty()) result |= INPUT;
+				if (windows_resized_triggered) result |= RESIZE;
+				if (timeout == 0) break;
+			}
+		}
+#elif defined(__linux__)
+		pollfd fds[2] = { { STDIN_FILENO, POLLIN, 0 }, { wakeup_pipe[0], POLLIN, 0 } };
+		int timeout = (timeout_seconds < 0.0f) ? -1 : static_cast<int>(ceil(timeout_seconds * 1000.0f));
+		if (poll(fds, (wakeup_pipe[0] >= 0) ? 2 : 1, timeout) > 0)
+		{
+			if (fds[0].revents & POLLIN) result |= INPUT;
+			if (fds[1].revents & POLLIN)
+			{
+				char buffer[64];
+				ssize_t bytes;
+				while ((bytes = read(wakeup_pipe[0], buffer, sizeof(buffer))) > 0)
+					for (ssize_t i = 0; i < bytes; i++)
+						result |= (buffer[i] == 'r') ? RESIZE : WAKEUP;
+			}
 		}
+#endif
+		return (WaitResult)result;
 	}
 #endif
 	;
 
-	GETMAXSIZE_STUB { return Coordinate{ -1,-1 }; }
-	GETMINSIZE_STUB { return Coordinate{ 4, 1 }; }
-};
-
-/**
- * @brief provides a vertical line which can be placed between two components
- * arranged next to one another horizontally to separate them visually.
- */
-class VerticalDivider : public Component
-{
-public:
-	VerticalDivider() { };
-
-	GETTYPENAME_STUB("VerticalDivider");
-
-	RENDER_STUB
+	/**
+	 * @brief wakes up `waitForEvents`, for instance so that another thread can get the
+	 * interface redrawn after changing something. safe to call from any thread.
+	 **/
+	static void postWakeup()
 #ifdef STUI_IMPLEMENTATION
 	{
-		if (size.x < 1) return;
-
-		for (int i = 0; i < size.y; i++)
-			output_buffer[i * size.x] = UNICODE_BOXLIGHT_VERTICAL;
-	}
+#if defined(_WIN32)
+		if (wakeup_event != nullptr) SetEvent(wakeup_event);
+#elif defined(__linux__)
+		if (wakeup_pipe[1] < 0) return;
+		char c = 'w';
+		ssize_t ignored = write(wakeup_pipe[1], &c, 1);
+		(void)ignored;
 #endif
-	;
-
-	GETMAXSIZE_STUB { return Coordinate{ 1,-1 }; }
-	GETMINSIZE_STUB { return Coordinate{ 1, 1 }; }
-};
-
-/**
- * @brief provides a horizontal line which can be placed between two components
- * arranged next to one another vertically to separate them visually.
- */
-class HorizontalDivider : public Component
-{
-public:
-	HorizontalDivider() { };
-
-	GETTYPENAME_STUB("HorizontalDivider");
+	}
+#endif
+	;
 
-	RENDER_STUB
+#if defined(__linux__)
+	/**
+	 * @brief get the file descriptor which becomes readable when `postWakeup` is called (or the
+	 * terminal is resized), for event loops which need to wait on other things too. read
+	 * everything from it once woken, and don't close it.
+	 * 
+	 * @returns readable end of the wakeup pipe, or -1 if it couldn't be created
+	 **/
+	static int getWakeupDescriptor()
 #ifdef STUI_IMPLEMENTATION
 	{
-		if (size.y < 1) return;
-
-		for (int i = 0; i < size.x; i++)
-			output_buffer[i] = UNICODE_BOXLIGHT_HORIZONTAL;
+		createWakeupSignal();
+		return wakeup_pipe[0];
 	}
 #endif
 	;
+#endif
 
-	GETMAXSIZE_STUB { return Coordinate{ -1,1 }; }
-	GETMINSIZE_STUB { return Coordinate{ 1, 1 }; }
+private:
+	/**
+	 * @brief sets up whatever `waitForEvents` needs to be woken up by `postWakeup` (a
+	 * self-pipe on Linux, an event on Windows), if it hasn't been already.
+	 **/
+	static void createWakeupSignal()
+#ifdef STUI_IMPLEMENTATION
+	{
+#if defined(_WIN32)
+		if (wakeup_event == nullptr) wakeup_event = CreateEvent(nullptr, false, false, nullptr);
+#elif defined(__linux__)
+		if (wakeup_pipe[0] >= 0) return;
+		if (pipe(wakeup_pipe) != 0) { wakeup_pipe[0] = wakeup_pipe[1] = -1; return; }
+		for (int fd : wakeup_pipe)
+		{
+			fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+			fcntl(fd, F_SETFD, FD_CLOEXEC);
+		}
+#endif
+	}
+#endif
+	;
 };
 
+#ifdef STUI_IMPLEMENTATION
+Session::~Session()
+{
+	if (active_session == this) Terminal::setSession(nullptr);
+	delete[] state.previous_frame;
+}
+
+void Session::requestFullRepaint()
+{
+	if (active_session == this) Renderer::requestFullRepaint();
+	else state.full_repaint_requested = true;
+}
+#endif
+
 /**
- * @brief purely static class which encapsulates code for rendering a page
- * to the terminal. a page just consists of a `Component` tree
- *
+ * @brief a terminal which only exists in memory. it reads the escape codes written to it back
+ * into a grid of cells, so that you can draw without a real terminal (for tests and benchmarks,
+ * say) and then look at what would have been on the screen.
+ * 
+ * use it by passing it to `Terminal::setBackend`. it understands the escape codes which STUI
+ * itself sends (cursor movement, clearing, colours and attributes including 24-bit colour,
+ * scrolling regions, and the modes STUI switches on and off), and ignores anything else.
  **/
-class Renderer : public Utility
+class VirtualTerminal : public TerminalBackend
 {
 public:
+	static constexpr uint32_t DEFAULT_COLOUR = 0xFFFFFFFF;	// the terminal's default colour
+	static constexpr uint32_t RGB_COLOUR = 0x01000000;		// or-ed with `0xRRGGBB` for 24-bit colours
+
 	/**
-	 * @brief draws a `Component` into the terminal via `std::cout`.
-	 *
-	 * if the `Component` has children, their drawing will be handled automatically
-	 * by the `Component` itself. the root `Component` is always drawn to fill the
-	 * terminal, which is completely cleared to prevent scrolling jank.
-	 *
-	 * @param root_component element to draw into the terminal
+	 * @brief describes one character cell of the screen. colours are either an index into
+	 * the 256-colour palette (0-7 for the normal colours, 8-15 for the bright ones),
+	 * `RGB_COLOUR | 0xRRGGBB`, or `DEFAULT_COLOUR`.
 	 **/
-	static void render(Component* root_component);
+	struct Cell
+	{
+		uint32_t character;		// UTF-8 byte pattern, in the same layout as `Tixel::character`
+		uint32_t foreground;
+		uint32_t background;
+		uint8_t attributes;		// bold, dim, italic, underline, blink, reverse, strikethrough, from the lowest bit up
+	};
+
+	VirtualTerminal(Coordinate _size) { resize(_size); }
+
+	void write(const char* data, size_t length) override;
+	inline Coordinate getSize() override { return size; }
 
 	/**
-	 * @brief check for queued input, handle shortcut triggers, and send remaining
-	 * input to the specified component. order of input event is preserved.
-	 *
-	 * @param focused_component component to send input to
-	 * @param shortcut_bindings list of shortcuts to check for
+	 * @brief changes the size of the screen. whatever fits in the new size is kept.
+	 * 
+	 * @param new_size new size, in characters
 	 **/
-	static bool handleInput(Component* focused_component, vector<Input::Shortcut> shortcut_bindings);
+	void resize(Coordinate new_size);
 
 	/**
-	 * @brief stores information about a frame-wait which just happened
-	 *
+	 * @brief get a cell of the screen.
+	 * 
+	 * @param position position of the cell, which must be on the screen
+	 * 
+	 * @returns the cell
 	 **/
-	struct FrameData
-	{
-		float delta_time;		// time since the last time `targetFramerate` was called
-		float active_fraction;	// fraction of the delta_time which was taken up by rendering
-	};
+	inline const Cell& getCell(Coordinate position) const { return cells[(position.y * size.x) + position.x]; }
 
 	/**
-	 * @brief maintains the desired framerate by waiting for the remainder of the frame's
-	 * duration.
-	 *
-	 * requires a variable in which to store the last time the function was called in order
-	 * to work correctly.
-	 *
-	 * @param fps desired framerate in frames per second
-	 * @param last_frame_time persistent storage for the time the function was last called
-	 * @return information about the frame: the delta time since the previous call, and
-	 * the fraction of the delta time which was taken up by the time between calls (the
-	 * remaining fraction being occupied by the `targetFramerate` function idling)
+	 * @brief get the text of one row of the screen, as UTF-8.
+	 * 
+	 * @param y row to fetch
+	 * 
+	 * @returns text of the row, including any trailing spaces
 	 **/
-	static FrameData targetFramerate(int fps, clock_type::time_point& last_frame_time);
+	string getLine(int y) const;
 
-private:
 	/**
-	 * @brief calculate an appropriate size for a `Component` (or, one dimension of it)
-	 *
-	 * @param available amount of space available to use
-	 * @param max maximum desired size of the subject
-	 * @param min minimum desired size of the subject
-	 * @return resulting constrained size
+	 * @brief get the text of the whole screen, with rows separated by newlines.
+	 * 
+	 * @returns text on the screen
 	 **/
-	static inline int getConstrainedSize(int available, int _max, int _min);
+	string getText() const;
+
+	/**
+	 * @returns the position the cursor is currently at
+	 **/
+	inline Coordinate getCursor() const { return cursor; }
+
+	/**
+	 * @returns whether the cursor has been hidden
+	 **/
+	inline bool isCursorVisible() const { return cursor_visible; }
+
+	/**
+	 * @returns total number of bytes written to this terminal
+	 **/
+	inline size_t getBytesReceived() const { return bytes_received; }
+
+private:
+	Coordinate size{ 0,0 };
+	vector<Cell> cells;
+	Cell pen{ ' ', DEFAULT_COLOUR, DEFAULT_COLOUR, 0 };	// colours and attributes new characters are written with
+	Coordinate cursor{ 0,0 };
+	Coordinate saved_cursor{ 0,0 };
+	bool wrap_pending = false;		// the last column was just written to, so the next character goes on the next line
+	bool cursor_visible = true;
+	int scroll_top = 0;				// top row of the scrolling region
+	int scroll_bottom = 0;			// bottom row of the scrolling region
+	size_t bytes_received = 0;
+	string unparsed;				// the start of an escape code or character which was cut off at the end of a write
+
+	void parse(const char* data, size_t length);
+	size_t parseEscape(const char* data, size_t length, size_t start);
+	void handleCSI(const char* parameters, size_t parameters_length, char final_byte);
+	void handleSGR(const int* values, size_t count);
+	void putCharacter(uint32_t character);
+	void lineFeed();
+	void scrollRegion(int lines);
+	void eraseCells(size_t start, size_t end);
+	static inline size_t getUTF8Length(uint8_t lead) { return (lead < 0xC0) ? 1 : (lead < 0xE0) ? 2 : (lead < 0xF0) ? 3 : 4; }
 };
 
-#if defined(__linux__)
 #ifdef STUI_IMPLEMENTATION
-static termios original_termios;
-static bool linux_resized_triggered = true;
-#endif
+void VirtualTerminal::resize(Coordinate new_size)
+{
+	new_size.x = max(0, new_size.x);
+	new_size.y = max(0, new_size.y);
+	vector<Cell> new_cells(static_cast<size_t>(new_size.x) * new_size.y, Cell{ ' ', DEFAULT_COLOUR, DEFAULT_COLOUR, 0 });
+	for (int y = 0; y < min(size.y, new_size.y); y++)
+		for (int x = 0; x < min(size.x, new_size.x); x++)
+			new_cells[(y * new_size.x) + x] = cells[(y * size.x) + x];
+
+	cells = move(new_cells);
+	size = new_size;
+	cursor = Coordinate{ min(cursor.x, max(0, size.x - 1)), min(cursor.y, max(0, size.y - 1)) };
+	wrap_pending = false;
+	scroll_top = 0;
+	scroll_bottom = max(0, size.y - 1);
+#if defined(__linux__)
+	if (terminal_backend == this) linux_resized_triggered = true;
 #endif
+}
 
-#ifdef STUI_IMPLEMENTATION
-static void (*exit_callback)() = nullptr;
-#endif
+void VirtualTerminal::write(const char* data, size_t length)
+{
+	bytes_received += length;
+	if (unparsed.empty())
+	{
+		parse(data, length);
+		return;
+	}
 
-static string default_banner = string("Simple Text UI  Copyright (C) 2024  Jacob Costen\nThis program comes with ABSOLUTELY NO WARRANTY.\nThis is free software, and you are welcome to redistribute it\nunder certain conditions; see the license for details.");
+	// finish off whatever was cut off last time first
+	string text = move(unparsed);
+	unparsed.clear();
+	text.append(data, length);
+	parse(text.data(), text.size());
+}
 
-/**
- * @brief encapsulates some functionality relating to control of the terminal window.
- * 
- * before you start drawing things using `Renderer`, you should definitely call `configure`,
- * although it's not strictly necessary.
- */
-class Terminal
+void VirtualTerminal::parse(const char* data, size_t length)
 {
-	friend class Renderer;
-	friend class Input;
+	size_t i = 0;
+	while (i < length)
+	{
+		uint8_t c = static_cast<uint8_t>(data[i]);
+		if (c == 0x1B)
+		{
+			size_t end = parseEscape(data, length, i);
+			if (end == 0) { unparsed.assign(data + i, length - i); return; }
+			i = end;
+		}
+		else if (c < 0x20 || c == 0x7F)
+		{
+			switch (c)
+			{
+			case '\n': case '\v': case '\f': lineFeed(); break;
+			case '\r': cursor.x = 0; wrap_pending = false; break;
+			case '\b': if (cursor.x > 0) cursor.x--; wrap_pending = false; break;
+			case '\t': cursor.x = min(max(0, size.x - 1), ((cursor.x / 8) + 1) * 8); break;
+			default: break;
+			}
+			i++;
+		}
+		else if (c < 0x80)
+		{
+			putCharacter(c);
+			i++;
+		}
+		else
+		{
+			size_t character_length = getUTF8Length(c);
+			if (i + character_length > length) { unparsed.assign(data + i, length - i); return; }
+			uint32_t character = 0;
+			for (size_t b = 0; b < character_length; b++)
+				character |= static_cast<uint32_t>(static_cast<uint8_t>(data[i + b])) << (8 * b);
+			putCharacter(character);
+			i += character_length;
+		}
+	}
+}
 
-private:
+string VirtualTerminal::getLine(int y) const
+{
+	string line;
+	if (y < 0 || y >= size.y) return line;
+	for (int x = 0; x < size.x; x++)
+	{
+		uint32_t character = cells[(y * size.x) + x].character;
+		size_t length = getUTF8Length(static_cast<uint8_t>(character & 0xFF));
+		for (size_t b = 0; b < length; b++) line += static_cast<char>((character >> (8 * b)) & 0xFF);
+	}
+	return line;
+}
 
-public:
-	static void configure(string banner_text = "", float banner_duration_seconds = 3.0f)
-#ifdef STUI_IMPLEMENTATION
+string VirtualTerminal::getText() const
+{
+	string text;
+	for (int y = 0; y < size.y; y++)
 	{
-		ios_base::sync_with_stdio(false);
-		isTerminalResized();
-#ifdef DEBUG
-		debug_log.open("stui_debug.log");
-		DEBUG_LOG("STUI logging started");
+		if (y > 0) text += '\n';
+		text += getLine(y);
+	}
+	return text;
+}
+
+size_t VirtualTerminal::parseEscape(const char* data, size_t length, size_t start)
+{
+	// returns the index just after the escape code, or 0 if it hasn't all arrived yet
+	if (start + 1 >= length) return 0;
+	char kind = data[start + 1];
+	if (kind == '[')
+	{
+		size_t i = start + 2;
+		while (i < length && !(data[i] >= 0x40 && data[i] <= 0x7E)) i++;
+		if (i >= length) return 0;
+		handleCSI(data + start + 2, i - (start + 2), data[i]);
+		return i + 1;
+	}
+	if (kind == ']')
+	{
+		// operating system commands (like setting the title) end with BEL or ESC backslash
+		for (size_t i = start + 2; i < length; i++)
+		{
+			if (data[i] == '\a') return i + 1;
+			if (data[i] == 0x1B && i + 1 < length && data[i + 1] == '\\') return i + 2;
+		}
+		return 0;
+	}
+	if (kind == '(' || kind == ')' || kind == '#')
+		return (start + 2 < length) ? start + 3 : 0;
+
+	switch (kind)
+	{
+	case '7': saved_cursor = cursor; break;
+	case '8': cursor = saved_cursor; wrap_pending = false; break;
+	case 'D': lineFeed(); break;
+	case 'E': cursor.x = 0; lineFeed(); break;
+	case 'M':
+		wrap_pending = false;
+		if (cursor.y == scroll_top) scrollRegion(-1);
+		else if (cursor.y > 0) cursor.y--;
+		break;
+	default: break;
+	}
+	return start + 2;
+}
+
+void VirtualTerminal::handleCSI(const char* parameters, size_t parameters_length, char final_byte)
+{
+	bool is_private = parameters_length > 0 && parameters[0] == '?';
+	int values[32];
+	size_t count = 0;
+	values[0] = -1;
+	for (size_t i = is_private ? 1 : 0; i < parameters_length; i++)
+	{
+		char c = parameters[i];
+		if (c >= '0' && c <= '9')
+		{
+			if (values[count] < 0) values[count] = 0;
+			values[count] = (values[count] * 10) + (c - '0');
+		}
+		else if ((c == ';' || c == ':') && count + 1 < 32) values[++count] = -1;
+		else if (c < '0' || c > '?') return;	// intermediate bytes (like `$`) aren't anything STUI draws with
+	}
+	count++;
+	auto value = [&](size_t index, int fallback) { return (index < count && values[index] >= 0) ? values[index] : fallback; };
+
+	if (is_private)
+	{
+		if (final_byte != 'h' && final_byte != 'l') return;
+		for (size_t i = 0; i < count; i++)
+			if (values[i] == 25) cursor_visible = (final_byte == 'h');
+		return;
+	}
+
+	// changing colours is the only thing here which keeps a wrap that's been put off
+	if (final_byte != 'm') wrap_pending = false;
+	switch (final_byte)
+	{
+	case 'H': case 'f':
+		cursor = Coordinate{ min(max(0, value(1, 1) - 1), max(0, size.x - 1)), min(max(0, value(0, 1) - 1), max(0, size.y - 1)) };
+		break;
+	case 'A': cursor.y = max(0, cursor.y - max(1, value(0, 1))); break;
+	case 'B': cursor.y = min(max(0, size.y - 1), cursor.y + max(1, value(0, 1))); break;
+	case 'C': cursor.x = min(max(0, size.x - 1), cursor.x + max(1, value(0, 1))); break;
+	case 'D': cursor.x = max(0, cursor.x - max(1, value(0, 1))); break;
+	case 'G': cursor.x = min(max(0, value(0, 1) - 1), max(0, size.x - 1)); break;
+	case 'd': cursor.y = min(max(0, value(0, 1) - 1), max(0, size.y - 1)); break;
+	case 'J':
+	{
+		size_t here = (static_cast<size_t>(cursor.y) * size.x) + cursor.x;
+		int mode = value(0, 0);
+		if (mode == 0) eraseCells(here, cells.size());
+		else if (mode == 1) eraseCells(0, here + 1);
+		else if (mode == 2) eraseCells(0, cells.size());
+		// 3 only clears the scrollback, which this terminal doesn't have
+		break;
+	}
+	case 'K':
+	{
+		size_t row_start = static_cast<size_t>(cursor.y) * size.x;
+		int mode = value(0, 0);
+		if (mode == 0) eraseCells(row_start + cursor.x, row_start + size.x);
+		else if (mode == 1) eraseCells(row_start, row_start + cursor.x + 1);
+		else if (mode == 2) eraseCells(row_start, row_start + size.x);
+		break;
+	}
+	case 'S': scrollRegion(max(1, value(0, 1))); break;
+	case 'T': scrollRegion(-max(1, value(0, 1))); break;
+	case 'r':
+	{
+		int top = value(0, 1) - 1;
+		int bottom = value(1, size.y) - 1;
+		if (top < 0 || bottom >= size.y || top >= bottom) { top = 0; bottom = max(0, size.y - 1); }
+		scroll_top = top;
+		scroll_bottom = bottom;
+		cursor = Coordinate{ 0,0 };
+		break;
+	}
+	case 'm': handleSGR(values, count); break;
+	default: break;
+	}
+}
+
+void VirtualTerminal::handleSGR(const int* values, size_t count)
+{
+	static const uint8_t attribute_bits[10] = { 0, 1 << 0, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 0, 1 << 5, 0, 1 << 6 };
+	for (size_t i = 0; i < count; i++)
+	{
+		int v = max(0, values[i]);
+		if (v == 0) pen = Cell{ ' ', DEFAULT_COLOUR, DEFAULT_COLOUR, 0 };
+		else if (v <= 9) pen.attributes |= attribute_bits[v];
+		else if (v == 22) pen.attributes &= ~(attribute_bits[1] | attribute_bits[2]);
+		else if (v >= 23 && v <= 29) pen.attributes &= ~attribute_bits[v - 20];
+		else if (v >= 30 && v <= 37) pen.foreground = static_cast<uint32_t>(v - 30);
+		else if (v >= 40 && v <= 47) pen.background = static_cast<uint32_t>(v - 40);
+		else if (v >= 90 && v <= 97) pen.foreground = static_cast<uint32_t>(v - 90 + 8);
+		else if (v >= 100 && v <= 107) pen.background = static_cast<uint32_t>(v - 100 + 8);
+		else if (v == 39) pen.foreground = DEFAULT_COLOUR;
+		else if (v == 49) pen.background = DEFAULT_COLOUR;
+		else if (v == 38 || v == 48)
+		{
+			uint32_t& target = (v == 38) ? pen.foreground : pen.background;
+			if (i + 2 < count && values[i + 1] == 5) { target = static_cast<uint32_t>(max(0, values[i + 2]) & 0xFF); i += 2; }
+			else if (i + 4 < count && values[i + 1] == 2)
+			{
+				target = RGB_COLOUR | ((static_cast<uint32_t>(max(0, values[i + 2])) & 0xFF) << 16)
+					| ((static_cast<uint32_t>(max(0, values[i + 3])) & 0xFF) << 8) | (static_cast<uint32_t>(max(0, values[i + 4])) & 0xFF);
+				i += 4;
+			}
+		}
+	}
+}
+
+void VirtualTerminal::putCharacter(uint32_t character)
+{
+	if (size.x <= 0 || size.y <= 0) return;
+	if (wrap_pending)
+	{
+		cursor.x = 0;
+		lineFeed();
+	}
+	Cell& cell = cells[(cursor.y * size.x) + cursor.x];
+	cell = pen;
+	cell.character = character;
+	if (cursor.x == size.x - 1) wrap_pending = true;
+	else cursor.x++;
+}
+
+void VirtualTerminal::lineFeed()
+{
+	wrap_pending = false;
+	if (cursor.y == scroll_bottom) scrollRegion(1);
+	else if (cursor.y < size.y - 1) cursor.y++;
+}
+
+void VirtualTerminal::scrollRegion(int lines)
+{
+	// positive numbers move the contents of the scrolling region up, negative ones move it down
+	int height = scroll_bottom - scroll_top + 1;
+	if (height <= 0 || lines == 0) return;
+	int distance = min(abs(lines), height);
+	size_t row = static_cast<size_t>(size.x);
+	Cell* region = cells.data() + (scroll_top * row);
+	if (lines > 0)
+	{
+		memmove(region, region + (distance * row), (height - distance) * row * sizeof(Cell));
+		eraseCells((scroll_bottom - distance + 1) * row, (scroll_bottom + 1) * row);
+	}
+	else
+	{
+		memmove(region + (distance * row), region, (height - distance) * row * sizeof(Cell));
+		eraseCells(scroll_top * row, (scroll_top + distance) * row);
+	}
+}
+
+void VirtualTerminal::eraseCells(size_t start, size_t end)
+{
+	// erased cells take on the current background, like a real terminal
+	Cell blank{ ' ', DEFAULT_COLOUR, pen.background, 0 };
+	for (size_t i = start; i < min(end, cells.size()); i++) cells[i] = blank;
+}
 #endif
-#if defined(_WIN32)
-		SetConsoleCtrlHandler(windowsControlHandler, true);
-#elif defined(__linux__)
-		signal(SIGINT, linuxControlHandler);
-		signal(SIGQUIT, linuxControlHandler);
-		signal(SIGTSTP, linuxControlHandler);
-		signal(SIGWINCH, linuxResizeHandler);
-		termios new_termios;
-		tcgetattr(STDIN_FILENO, &new_termios);
-		tcgetattr(STDIN_FILENO, &original_termios);
 
-		new_termios.c_iflag &= ~(IGNBRK | BRKINT | IXON);
-		new_termios.c_lflag &= ~(ICANON | ECHO);
-        new_termios.c_cc[VMIN] = 1;
-		new_termios.c_cc[VSUSP] = 255;
-		tcsetattr(STDIN_FILENO, TCSANOW, &new_termios);
+#ifdef STUI_IMPLEMENTATION
+void Renderer::render(Component* root_component)
+{
+	DEBUG_TIMER_S(render);
+	bool profiling = profiling_enabled;
+	clock_type::time_point frame_start_time, layout_end_time, draw_end_time;
+	if (profiling) frame_start_time = clock_type::now();
+#ifdef STUI_COUNT_ALLOCATIONS
+	size_t allocations_at_start = allocation_count;
+	parallel_allocations.store(0);
 #endif
-		Banner b(banner_text + "\n\nusing\n" + default_banner);
-		BorderedBox bb(&b, "");
-		Renderer::render(&bb);
-		this_thread::sleep_for(chrono::duration<float>(banner_duration_seconds));
+	// text built for the last frame isn't needed any more
+	scratch_arena.reset();
+	// everything sent to the terminal during the frame is collected and sent in one go at the end
+	string& output = terminal_output;
+	terminal_output_held = true;
+	if (synchronized_output) output += "\033[?2026h";
+	Terminal::setCursorVisible(false);
+	Terminal::enableUTF8();
+	size_t frame_start = output.size();
+
+	Coordinate screen_size = Terminal::getScreenSize();
+	size_t length = static_cast<size_t>(max(0, screen_size.x * screen_size.y));
+
+	// another session the same size may have just drawn this frame, in which case it only needs sending
+	bool reuse = reuse_frame_surface && frame_surface != nullptr && root_component == last_root_component
+		&& frame_surface_size.x == screen_size.x && frame_surface_size.y == screen_size.y;
+
+	// the palette can't be allowed to fill up, but emptying it changes what the palette entries
+	// already on the surface mean, so everything has to be drawn again
+	bool palette_recycled = false;
+#ifdef STUI_TRUECOLOUR
+	if (!reuse && recycleTrueColourPalette())
+	{
+		palette_recycled = true;
+		surface_generation++;
 	}
 #endif
-	;
 
-	static void registerExitCallback(void (*callback)())
-#ifdef STUI_IMPLEMENTATION
+	// the surface is kept between frames, so that unchanged components can leave their output in place
+	if (frame_surface == nullptr || frame_surface_size.x != screen_size.x || frame_surface_size.y != screen_size.y)
+	{
+		delete[] frame_surface;
+		frame_surface = makeBuffer(screen_size);
+		frame_surface_size = screen_size;
+		surface_generation++;
+		surface_version++;
+	}
+
+	render_frame_index++;
+	surface_touched = false;
+	if (!reuse) scroll_hints.clear();
+	if (reuse) { }
+	else if (root_component != nullptr && frame_surface != nullptr)
+	{
+		Coordinate root_component_size
+		{
+			getConstrainedSize(screen_size.x, root_component->getLayoutMaxSize().x, root_component->getLayoutMinSize().x),
+			getConstrainedSize(screen_size.y, root_component->getLayoutMaxSize().y, root_component->getLayoutMinSize().y)
+		};
+		// lay out the whole tree before drawing anything; parts of the tree which haven't changed
+		// keep their previous layout
+		root_component->layout_offset = Coordinate{ 0,0 };
+		root_component->ensureLayout(root_component_size);
+		// work out what can be drawn on other threads before any of it is handed over
+		if (parallel_rendering && !render_pool.threads.empty()) Component::findSharedComponents(root_component);
+		if (profiling) layout_end_time = clock_type::now();
+		// if the root is going to be drawn from scratch, anything outside it must be cleared too.
+		// the root may not draw anything (if it has no size), so the clear counts as a change itself
+		if (!caching_enabled || root_component != last_root_component || palette_recycled)
+		{
+			BufferView(frame_surface, screen_size).fill(getBlankTixel());
+			surface_touched = true;
+		}
+		if (root_component_size.x > 0 && root_component_size.y > 0)
+			Component::drawCached(nullptr, render_frame_index, root_component, BufferView(frame_surface, screen_size.x, Coordinate{ 0,0 }, root_component_size));
+	}
+	else if (frame_surface != nullptr && last_root_component != nullptr)
 	{
-		exit_callback = callback;
+		BufferView(frame_surface, screen_size).fill(getBlankTixel());
+		surface_touched = true;
+	}
+	last_root_component = root_component;
+	if (surface_touched) surface_version++;
+	DEBUG_TIMER_E(render);
+	if (profiling)
+	{
+		draw_end_time = clock_type::now();
+		if (layout_end_time < frame_start_time) layout_end_time = frame_start_time;
 	}
+
+	DEBUG_TIMER_S(transcoding);
+	uint32_t style = 0;
+
+	bool full_repaint = full_repaint_requested || previous_frame == nullptr
+		|| previous_frame_size.x != screen_size.x || previous_frame_size.y != screen_size.y;
+#ifdef STUI_TRUECOLOUR
+	// the previous frame can't be compared against once its palette entries have been reused
+	if (presented_true_colour_generation != true_colour_generation) full_repaint = true;
+	presented_true_colour_generation = true_colour_generation;
 #endif
-	;
+	last_render_stats = RenderStats{ 0, 0, 0, full_repaint, 0, 0 };
 
-	static void unConfigure(bool clear_terminal)
-#ifdef STUI_IMPLEMENTATION
+	bool presented = false;
+#if defined(_WIN32)
+	if (native_console_output && console_output && terminal_backend == nullptr)
 	{
-		setCursorVisible(true);
-#if defined(__linux__)
-		tcsetattr(STDIN_FILENO, TCSANOW, &original_termios);
-#endif
-		if (clear_terminal)
+		presented = presentToConsole(screen_size, full_repaint);
+		if (!presented)
 		{
-			clear();
-			setCursorPosition(Coordinate{ 0,0 });
+			// send this frame (and every one after it) as escape codes instead
+			native_console_output = false;
+			full_repaint = true;
+			last_render_stats = RenderStats{ 0, 0, 0, full_repaint, 0, 0 };
 		}
-		else
-			setCursorPosition(Coordinate{ 0,getScreenSize().y + 1 });
-#ifdef DEBUG
-		DEBUG_LOG("STUI logging stopped");
-		DEBUG_LOG("timing data:\n\trender:\t\t\t" + to_string(debug_timing.d_render) + "\t\t" + to_string(debug_timing.i_render) + "\t\t" + to_string(debug_timing.d_render / debug_timing.i_render)
-		                    + "\n\ttranscoding:\t" + to_string(debug_timing.d_transcoding) + "\t\t" + to_string(debug_timing.i_transcoding) + "\t\t" + to_string(debug_timing.d_transcoding / debug_timing.i_transcoding)
-		                    + "\n\tmakebuffer:\t\t" + to_string(debug_timing.d_makebuffer) + "\t\t" + to_string(debug_timing.i_makebuffer) + "\t\t" + to_string(debug_timing.d_makebuffer / debug_timing.i_makebuffer)
-		                    + "\n\tcopybuffer:\t\t" + to_string(debug_timing.d_copybuffer) + "\t\t" + to_string(debug_timing.i_copybuffer) + "\t\t" + to_string(debug_timing.d_copybuffer / debug_timing.i_copybuffer)
-		                    + "\n\tdrawtext:\t\t" + to_string(debug_timing.d_drawtext) + "\t\t" + to_string(debug_timing.i_drawtext) + "\t\t" + to_string(debug_timing.d_drawtext / debug_timing.i_drawtext)
-				);
-		
-		debug_log.close();
-#endif
 	}
 #endif
-	;
 
-	static bool isTerminalResized()
-#ifdef STUI_IMPLEMENTATION
+	if (presented) { }
+	else if (full_repaint)
 	{
-#if defined(_WIN32)
-		static Coordinate last_checked_screen_size;
-		Coordinate new_screen_size = getScreenSize();
-		if (new_screen_size.x == last_checked_screen_size.x && new_screen_size.y == last_checked_screen_size.y)
-			return false;
-
-		last_checked_screen_size = new_screen_size;
-		return true;
-#elif defined(__linux__)
-		bool resized = linux_resized_triggered;
-		linux_resized_triggered = false;
-		return resized;
-#endif
+		// clear the scrollback and send every cell, starting from the top-left
+		output.reserve(frame_start + 2 * length);
+		output += "\033[3J\033[H";
+		transcode(frame_surface, length, output, style);
+		last_render_stats.cells_changed = length;
+		last_render_stats.spans_emitted = 1;
+
+		// keep a copy of this frame to compare the next one against
+		if (previous_frame == nullptr || previous_frame_size.x != screen_size.x || previous_frame_size.y != screen_size.y)
+		{
+			delete[] previous_frame;
+			previous_frame = makeBuffer(screen_size);
+			previous_frame_size = screen_size;
+		}
+		if (previous_frame != nullptr) memcpy(previous_frame, frame_surface, length * sizeof(Tixel));
 	}
-#endif
-	;
-
-private:
-#if defined(_WIN32)
-	static int WINAPI windowsControlHandler(DWORD control_type) noexcept
-#ifdef STUI_IMPLEMENTATION
+	else if (presented_surface_version != surface_version)
 	{
-		if (control_type == 0)
+		if (hardware_scrolling && !scroll_hints.empty()) applyScrolling(screen_size, output);
+
+		// a cursor move costs about this many bytes, so short runs of unchanged
+		// cells between two changed runs are cheaper to just re-send
+		constexpr int merge_gap = 6;
+		for (int y = 0; y < screen_size.y; y++)
 		{
-			commonExitHandler();
+			const Tixel* row = frame_surface + (y * screen_size.x);
+			Tixel* previous_row = previous_frame + (y * screen_size.x);
+			int x = 0;
+			while (x < screen_size.x)
+			{
+				x += static_cast<int>(findTixelDifference(row + x, previous_row + x, static_cast<size_t>(screen_size.x - x)));
+				if (x >= screen_size.x) break;
+
+				// extend the span until we find a run of unchanged cells long enough to be worth skipping
+				int span_start = x;
+				int span_end = x + 1;
+				last_render_stats.cells_changed++;
+				for (int scan = span_end; scan < screen_size.x && scan - span_end < merge_gap; scan++)
+				{
+					if (!tixelsEqual(row[scan], previous_row[scan]))
+					{
+						span_end = scan + 1;
+						last_render_stats.cells_changed++;
+					}
+				}
+
+				output += "\033[" + to_string(y + 1) + ';' + to_string(span_start + 1) + 'H';
+				transcode(row + span_start, static_cast<size_t>(span_end - span_start), output, style);
+				memcpy(previous_row + span_start, row + span_start, (span_end - span_start) * sizeof(Tixel));
+				last_render_stats.spans_emitted++;
+				x = span_end;
+			}
 		}
+	}
+	DEBUG_TIMER_E(transcoding);
+	presented_surface_version = surface_version;
 
-		return 1;
+	terminal_output_held = false;
+	if (output.size() > frame_start)
+	{
+		if (synchronized_output) output += "\033[?2026l";
+		last_render_stats.bytes_emitted = output.size();
+		Terminal::flushOutput();
 	}
+	else
+		output.clear();
+
+	full_repaint_requested = false;
+#ifdef STUI_COUNT_ALLOCATIONS
+	last_render_stats.allocations = allocation_count - allocations_at_start + parallel_allocations.exchange(0);
 #endif
-	;
 
-#elif defined(__linux__)
-	static void linuxControlHandler(int control_type)
-#ifdef STUI_IMPLEMENTATION
+	if (profiling)
 	{
-		commonExitHandler();
+		auto frame_end_time = clock_type::now();
+		Profiler::FrameProfile frame{ render_frame_index, 0, 0, 0, 0, 0, 0, 0, 0, 0, false };
+		frame.total_seconds = chrono::duration<float>(frame_end_time - frame_start_time).count();
+		frame.layout_seconds = chrono::duration<float>(layout_end_time - frame_start_time).count();
+		frame.draw_seconds = chrono::duration<float>(draw_end_time - layout_end_time).count();
+		frame.output_seconds = chrono::duration<float>(frame_end_time - draw_end_time).count();
+		frame.bytes_emitted = last_render_stats.bytes_emitted;
+		frame.cells_changed = last_render_stats.cells_changed;
+		frame.allocations = last_render_stats.allocations;
+		frame.full_repaint = last_render_stats.full_repaint;
+		Profiler::finishFrame(frame);
 	}
-#endif
-	;
+}
 
-	static void linuxResizeHandler(int s)
-#ifdef STUI_IMPLEMENTATION
+void Renderer::render(Component* root_component, const vector<Session*>& sessions)
+{
+	Session* previously_active = Terminal::getSession();
+
+	// draw the sessions grouped by size, so each group after the first session just reuses its frame
+	vector<pair<Coordinate, Session*>> ordered;
+	ordered.reserve(sessions.size());
+	for (Session* session : sessions)
 	{
-		DEBUG_LOG("screen resized");
-		linux_resized_triggered = true;
+		Terminal::setSession(session);
+		ordered.push_back(pair<Coordinate, Session*>(Terminal::getScreenSize(), session));
+	}
+	stable_sort(ordered.begin(), ordered.end(), [](const pair<Coordinate, Session*>& a, const pair<Coordinate, Session*>& b)
+		{ return (a.first.y != b.first.y) ? (a.first.y < b.first.y) : (a.first.x < b.first.x); });
+
+	for (size_t i = 0; i < ordered.size(); i++)
+	{
+		Terminal::setSession(ordered[i].second);
+		reuse_frame_surface = i > 0 && ordered[i].first.x == ordered[i - 1].first.x && ordered[i].first.y == ordered[i - 1].first.y;
+		render(root_component);
 	}
+	reuse_frame_surface = false;
+	Terminal::setSession(previously_active);
+}
+
+void Renderer::enableCaching(bool enabled)
+{
+	if (enabled != caching_enabled) surface_generation++;
+	caching_enabled = enabled;
+}
+
+void Renderer::enableParallelRendering(bool enabled, size_t threads, float cost_threshold)
+{
+	render_pool.stop();
+#ifdef DEBUG
+	// the debug timers aren't safe to use from more than one thread
+	enabled = false;
 #endif
-	;
+	parallel_rendering = enabled;
+	parallel_cost_threshold = cost_threshold;
+#ifdef STUI_TRUECOLOUR
+	true_colour_locking = enabled;
+#endif
+	if (!enabled) return;
+
+	if (threads == 0) threads = max(thread::hardware_concurrency(), 1u) - 1;
+	if (threads > 0) render_pool.start(threads);
+}
+
+void Renderer::enableHardwareScrolling(bool enabled)
+{
+	hardware_scrolling = enabled;
+}
 
+void Renderer::enableNativeConsoleOutput(bool enabled)
+{
+#if defined(_WIN32)
+	// the console and the escape codes were drawn from different copies of the frame
+	if (enabled != native_console_output) full_repaint_requested = true;
+	native_console_output = enabled;
+#else
+	(void)enabled;
 #endif
+}
 
-	static void commonExitHandler()
-#ifdef STUI_IMPLEMENTATION
+void Renderer::applyScrolling(Coordinate screen_size, string& output)
+{
+	// roughly how many bytes it takes to move the cursor to a row before sending it
+	constexpr size_t row_cost = 8;
+	int width = screen_size.x;
+	auto count_changes = [&](int row, int previous_row)
 	{
-		unConfigure(true);
-		if (exit_callback != nullptr)
-			exit_callback();
-		exit(0);
-	}
-#endif
-	;
+		const Tixel* current = frame_surface + (row * width);
+		const Tixel* previous = previous_frame + (previous_row * width);
+		size_t x = findTixelDifference(current, previous, width);
+		if (x == static_cast<size_t>(width)) return static_cast<size_t>(0);
+		size_t changed = row_cost;
+		for (; x < static_cast<size_t>(width); x++)
+			if (!tixelsEqual(current[x], previous[x])) changed++;
+		return changed;
+	};
 
-	/**
-	 * @brief clear the entire terminal, including scrollback and onscreen buffers
-	 **/
-	static inline void clear()
+	for (const ScrollHint& hint : scroll_hints)
 	{
-		OUTPUT_TARGET << ANSI_CLEAR_SCREEN << ANSI_CLEAR_SCROLL;
+		if (hint.surface != frame_surface || hint.top < 0 || hint.height < 2 || hint.top + hint.height > screen_size.y) continue;
+		int distance = abs(hint.rows);
+		if (distance >= hint.height) continue;
+
+		// compare what would need sending with and without moving the rows first. rows which
+		// scroll into view have to be sent in full
+		int top = hint.top;
+		int bottom = hint.top + hint.height;
+		size_t unmoved = 0;
+		size_t moved = static_cast<size_t>(distance) * (width + row_cost);
+		for (int y = top; y < bottom; y++)
+		{
+			unmoved += count_changes(y, y);
+			int from = y + hint.rows;
+			if (from >= top && from < bottom) moved += count_changes(y, from);
+		}
+		// the escape codes cost about as much as a couple of cursor moves
+		if (moved + (2 * row_cost) >= unmoved) continue;
+
+		// the scroll region covers whole rows, so anything beside the area moves too, and is
+		// put right by the usual comparison afterwards
+		output += "\033[" + to_string(top + 1) + ';' + to_string(bottom) + 'r';
+		output += "\033[" + to_string(distance) + (hint.rows > 0 ? 'S' : 'T');
+		output += "\033[r";
+
+		Tixel* first = previous_frame + (top * width);
+		size_t row_bytes = static_cast<size_t>(width) * sizeof(Tixel);
+		size_t kept_rows = static_cast<size_t>(hint.height - distance);
+		Tixel* exposed;
+		if (hint.rows > 0)
+		{
+			memmove(static_cast<void*>(first), first + (distance * width), kept_rows * row_bytes);
+			exposed = first + (kept_rows * width);
+		}
+		else
+		{
+			memmove(static_cast<void*>(first + (distance * width)), first, kept_rows * row_bytes);
+			exposed = first;
+		}
+		// whatever the terminal filled the new rows with, make sure they get sent
+		Tixel unknown{ 0, Tixel::ColourCommand(0) };
+		fillTixels(exposed, static_cast<size_t>(distance) * width, unknown);
+		last_render_stats.rows_scrolled += kept_rows;
 	}
+}
 
-	/**
-	 * @brief get the size of the terminal window in characters
-	 * 
-	 * @return size of the terminal window 
-	 **/
-	static inline Coordinate getScreenSize()
-	{
 #if defined(_WIN32)
-		CONSOLE_SCREEN_BUFFER_INFO info;
-		GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info);
-		return Coordinate{ info.dwSize.X, info.dwSize.Y };
-#elif defined(__linux__)
-		struct winsize size;
-		ioctl(STDOUT_FILENO, TIOCGWINSZ, &size);
-		return Coordinate{ (int)size.ws_col, (int)size.ws_row };
+bool Renderer::presentToConsole(Coordinate screen_size, bool full_repaint)
+{
+	// console colours for each combination of the bits in one half of a `Tixel::ColourCommand`
+	static constexpr WORD console_colours[16] =
+	{
+		0, 0, FOREGROUND_RED | FOREGROUND_INTENSITY, 0,
+		FOREGROUND_GREEN | FOREGROUND_INTENSITY, 0, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_INTENSITY, 0,
+		FOREGROUND_BLUE | FOREGROUND_INTENSITY, 0, FOREGROUND_RED | FOREGROUND_BLUE | FOREGROUND_INTENSITY, 0,
+		FOREGROUND_GREEN | FOREGROUND_BLUE | FOREGROUND_INTENSITY, 0, FOREGROUND_INTENSITY, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE | FOREGROUND_INTENSITY
+	};
+	auto convert = [](const Tixel& tixel)
+	{
+		// each cell holds a single UTF-16 unit, so anything which needs two can't be shown
+		uint32_t chr = tixel.character;
+		uint32_t lead = chr & 0xFF;
+		uint32_t code_point = 0xFFFD;
+		if (lead < 0x80) code_point = lead;
+		else if (lead >= 0xC0 && lead < 0xE0) code_point = ((lead & 0x1F) << 6) | ((chr >> 8) & 0x3F);
+		else if (lead >= 0xE0 && lead < 0xF0) code_point = ((lead & 0x0F) << 12) | (((chr >> 8) & 0x3F) << 6) | ((chr >> 16) & 0x3F);
+
+		uint8_t colour = static_cast<uint8_t>(tixel.colour);
+		WORD attributes = console_colours[colour & 0x0F] | static_cast<WORD>(console_colours[colour >> 4] << 4);
+#ifdef STUI_TRUECOLOUR
+		if (tixel.attributes & Tixel::UNDERLINE) attributes |= COMMON_LVB_UNDERSCORE;
+		if (tixel.attributes & Tixel::REVERSE) attributes |= COMMON_LVB_REVERSE_VIDEO;
 #endif
-	}
+		CHAR_INFO cell;
+		cell.Char.UnicodeChar = static_cast<WCHAR>(code_point);
+		cell.Attributes = attributes;
+		return cell;
+	};
 
-	/**
-	 * @brief move the cursor to a given position in the terminal window
-	 * 
-	 * @param position desired position of the cursor
-	 **/
-	static inline void setCursorPosition(Coordinate position)
+	HANDLE output = GetStdHandle(STD_OUTPUT_HANDLE);
+	int width = screen_size.x;
+	size_t length = static_cast<size_t>(max(0, screen_size.x * screen_size.y));
+	if (length == 0) return true;
+	auto write_rectangle = [&](int top, int bottom, int left, int right)
+	{
+		SMALL_RECT region
+		{
+			static_cast<SHORT>(windows_window_origin.x + left), static_cast<SHORT>(windows_window_origin.y + top),
+			static_cast<SHORT>(windows_window_origin.x + right), static_cast<SHORT>(windows_window_origin.y + bottom)
+		};
+		last_render_stats.spans_emitted++;
+		last_render_stats.bytes_emitted += static_cast<size_t>(right - left + 1) * static_cast<size_t>(bottom - top + 1) * sizeof(CHAR_INFO);
+		return WriteConsoleOutputW(output, console_cells.data(), COORD{ static_cast<SHORT>(width), static_cast<SHORT>(screen_size.y) },
+			COORD{ static_cast<SHORT>(left), static_cast<SHORT>(top) }, &region) != 0;
+	};
+
+	// the window may have been scrolled within the screen buffer since the last frame, in which case
+	// it no longer shows what was drawn there
+	Coordinate window_size, origin;
+	if (readConsoleWindow(window_size, origin) && (origin.x != windows_window_origin.x || origin.y != windows_window_origin.y))
 	{
-		OUTPUT_TARGET << ANSI_SET_CURSOR(position.x, position.y);
+		windows_window_origin = origin;
+		full_repaint = true;
 	}
 
-	/**
-	 * @brief toggle terminal cursor visibility
-	 * 
-	 * @param visible whether or not the cursor should be visible
-	 **/
-	static inline void setCursorVisible(bool visible)
+	if (full_repaint || console_cells.size() != length)
 	{
-#if defined(_WIN32)
-		CONSOLE_CURSOR_INFO info;
-		GetConsoleCursorInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info);
-		info.bVisible = visible;
-		SetConsoleCursorInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info);
-#elif defined(__linux__)
-		if (visible) OUTPUT_TARGET << ANSI_SHOW_CURSOR;
-		else OUTPUT_TARGET << ANSI_HIDE_CURSOR;
-#endif
+		console_cells.resize(length);
+		for (size_t i = 0; i < length; i++) console_cells[i] = convert(frame_surface[i]);
+		if (!write_rectangle(0, screen_size.y - 1, 0, width - 1)) return false;
+		last_render_stats.cells_changed = length;
+		last_render_stats.full_repaint = true;
+
+		delete[] previous_frame;
+		previous_frame = makeBuffer(screen_size);
+		previous_frame_size = screen_size;
+		if (previous_frame != nullptr) memcpy(previous_frame, frame_surface, length * sizeof(Tixel));
+		return true;
 	}
+	if (presented_surface_version == surface_version) return true;
 
-	/**
-	 * @brief forces the current terminal to respect UTF-8
-	 */
-	static inline void enableUTF8()
+	// consecutive rows with changes in are sent together, as the narrowest rectangle covering them
+	int band_top = -1;
+	int band_left = 0;
+	int band_right = 0;
+	for (int y = 0; y <= screen_size.y; y++)
 	{
-#if defined(_WIN32)
-		SetConsoleOutputCP(CP_UTF8);
-#endif
+		int left = -1;
+		int right = -1;
+		if (y < screen_size.y)
+		{
+			const Tixel* row = frame_surface + (y * width);
+			Tixel* previous_row = previous_frame + (y * width);
+			int x = static_cast<int>(findTixelDifference(row, previous_row, static_cast<size_t>(width)));
+			if (x < width)
+			{
+				left = x;
+				right = width - 1;
+				while (tixelsEqual(row[right], previous_row[right])) right--;
+				for (; x <= right; x++)
+				{
+					if (tixelsEqual(row[x], previous_row[x])) continue;
+					console_cells[(y * width) + x] = convert(row[x]);
+					previous_row[x] = row[x];
+					last_render_stats.cells_changed++;
+				}
+			}
+		}
+
+		if (left >= 0 && band_top < 0)
+		{
+			band_top = y;
+			band_left = left;
+			band_right = right;
+		}
+		else if (left >= 0)
+		{
+			band_left = min(band_left, left);
+			band_right = max(band_right, right);
+		}
+		else if (band_top >= 0)
+		{
+			if (!write_rectangle(band_top, y - 1, band_left, band_right)) return false;
+			band_top = -1;
+		}
 	}
-};
+	return true;
+}
+#endif
 
-#ifdef STUI_IMPLEMENTATION
-void Renderer::render(Component* root_component)
+void Renderer::requestFullRepaint()
 {
-	DEBUG_TIMER_S(render);
-	Terminal::setCursorVisible(false);
-	Terminal::enableUTF8();
+	full_repaint_requested = true;
+}
 
-	Coordinate screen_size = Terminal::getScreenSize();
+Renderer::RenderStats Renderer::getLastRenderStats()
+{
+	return last_render_stats;
+}
 
-	Tixel* root_staging_buffer = makeBuffer(screen_size);
+Keymap& Renderer::getGlobalKeymap()
+{
+	return global_keymap;
+}
 
-	if (root_component != nullptr)
-	{
-		Coordinate root_component_size
-		{
-			getConstrainedSize(screen_size.x, root_component->getMaxSize().x, root_component->getMinSize().x),
-			getConstrainedSize(screen_size.y, root_component->getMaxSize().y, root_component->getMinSize().y)
-		};
-		Tixel* root_component_buffer = makeBuffer(root_component_size);
-		root_component->render(root_component_buffer, root_component_size);
-		copyBox(root_component_buffer, root_component_size, Coordinate{ 0,0 }, root_component_size, root_staging_buffer, screen_size, Coordinate{ 0,0 });
-		delete[] root_component_buffer;
+void Terminal::writeOutput(const string& data)
+{
+	terminal_output += data;
+	if (!terminal_output_held) flushOutput();
+}
 
-		OUTPUT_TARGET << ANSI_CLEAR_SCROLL;
-		OUTPUT_TARGET << ANSI_SET_COLOUR(Tixel::toANSI(Tixel::ColourCommand::FG_WHITE));
-		OUTPUT_TARGET << ANSI_SET_COLOUR(Tixel::toANSI(Tixel::ColourCommand::BG_BLACK));
-		Terminal::setCursorPosition(Coordinate{ 0,0 });
+void Terminal::flushOutput()
+{
+	if (terminal_backend != nullptr)
+	{
+		if (!terminal_output.empty()) terminal_backend->write(terminal_output.data(), terminal_output.size());
+		terminal_output.clear();
+		return;
 	}
-	DEBUG_TIMER_E(render);
 
-	DEBUG_TIMER_S(transcoding);
-	string output;
-	output.reserve(2 * screen_size.x * screen_size.y);
+	// anything the application printed itself should come first
+	cout.flush();
 
-	Tixel::ColourCommand foreground = (Tixel::ColourCommand)0;
-	Tixel::ColourCommand background = (Tixel::ColourCommand)0;
+	const char* data = terminal_output.data();
+	size_t remaining = terminal_output.size();
+	while (remaining > 0)
+	{
+#if defined(_WIN32)
+		DWORD written = 0;
+		DWORD chunk = static_cast<DWORD>(min(remaining, static_cast<size_t>(1 << 30)));
+		// the console takes the text as it is, rather than going through the file layer
+		BOOL sent = console_output ? WriteConsoleA(GetStdHandle(STD_OUTPUT_HANDLE), data, chunk, &written, nullptr)
+			: WriteFile(GetStdHandle(STD_OUTPUT_HANDLE), data, chunk, &written, nullptr);
+		if (!sent || written == 0)
+			break;
+#elif defined(__linux__)
+		ssize_t written = write(STDOUT_FILENO, data, remaining);
+		if (written < 0)
+		{
+			if (errno == EINTR) continue;
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+			{
+				pollfd poll_fd{ STDOUT_FILENO, POLLOUT, 0 };
+				poll(&poll_fd, 1, -1);
+				continue;
+			}
+			break;
+		}
+#endif
+		data += written;
+		remaining -= static_cast<size_t>(written);
+	}
+	terminal_output.clear();
+}
 
-	size_t length = static_cast<size_t>(screen_size.x * screen_size.y);
+inline void Renderer::appendStyle(uint32_t style, uint32_t previous_style, string& output)
+{
+#ifdef STUI_TRUECOLOUR
+	uint8_t attributes = static_cast<uint8_t>(style >> 8);
+	uint16_t true_colour = static_cast<uint16_t>(style >> 16);
+	uint8_t previous_attributes = static_cast<uint8_t>(previous_style >> 8);
+	if (attributes != 0 || previous_attributes != 0 || true_colour != 0)
+	{
+		// attributes can only be turned off all at once, so start from a reset if any were on
+		char sequence[64];
+		size_t length = 0;
+		auto append_number = [&](uint32_t n)
+		{
+			char digits[10];
+			size_t count = 0;
+			do { digits[count++] = static_cast<char>('0' + (n % 10)); n /= 10; } while (n != 0);
+			while (count > 0) sequence[length++] = digits[--count];
+		};
+		sequence[length++] = '\033';
+		sequence[length++] = '[';
+		if (previous_attributes != 0) { sequence[length++] = '0'; sequence[length++] = ';'; }
+		static const uint8_t attribute_codes[7] = { 1, 2, 3, 4, 5, 7, 9 };
+		for (int a = 0; a < 7; a++)
+			if (attributes & (1 << a)) { append_number(attribute_codes[a]); sequence[length++] = ';'; }
+
+		const pair<uint32_t, uint32_t>& rgb = true_colour_palette[(true_colour < true_colour_palette.size()) ? true_colour : 0];
+		uint32_t sides[2] = { rgb.first, rgb.second };
+		for (int side = 0; side < 2; side++)
+		{
+			if (side == 1) sequence[length++] = ';';
+			if (sides[side] == Tixel::KEEP_COLOUR)
+			{
+				uint8_t mask = (side == 0) ? Tixel::ColourCommand::FG_WHITE : Tixel::ColourCommand::BG_WHITE;
+				append_number(static_cast<uint32_t>(Tixel::toANSI(static_cast<Tixel::ColourCommand>(style & mask))));
+				continue;
+			}
+			append_number((side == 0) ? 38 : 48);
+			sequence[length++] = ';';
+			sequence[length++] = '2';
+			for (int shift = 16; shift >= 0; shift -= 8)
+			{
+				sequence[length++] = ';';
+				append_number((sides[side] >> shift) & 0xFF);
+			}
+		}
+		sequence[length++] = 'm';
+		output.append(sequence, length);
+		return;
+	}
+#endif
+	const SGRTable::Entry& sgr = sgr_table.entries[style & 0xFF];
+	output.append(sgr.bytes, sgr.length);
+}
 
-	for (size_t i = 0; i < length; i++)
+inline void Renderer::transcode(const Tixel* tixels, size_t count, string& output, uint32_t& style)
+{
+	size_t i = 0;
+	while (i < count)
 	{
-		Tixel::ColourCommand new_foreground = (Tixel::ColourCommand)(root_staging_buffer[i].colour & Tixel::ColourCommand::FG_WHITE);
-		Tixel::ColourCommand new_background = (Tixel::ColourCommand)(root_staging_buffer[i].colour & Tixel::ColourCommand::BG_WHITE);
-		if (foreground != new_foreground)
-			output += "\033[" + to_string(Tixel::toANSI(new_foreground)) + 'm';
+		uint32_t tixel_style = tixels[i].getStyle();
+		if (tixel_style != style)
+		{
+			appendStyle(tixel_style, style, output);
+			style = tixel_style;
+		}
 
-		if (background != new_background)
-			output += "\033[" + to_string(Tixel::toANSI(new_background)) + 'm';
-			
-		foreground = new_foreground;
-		background = new_background;
+		// most of a frame is plain ASCII in long runs of the same style, which can be copied
+		// across in one go without checking the output's capacity for every character
+		size_t run_end = i;
+		while (run_end < count && tixels[run_end].getStyle() == style && tixels[run_end].character < 0x80)
+			run_end++;
+		if (run_end > i)
+		{
+			size_t start = output.size();
+			output.resize(start + (run_end - i));
+			char* out = &output[start];
+			for (size_t j = i; j < run_end; j++)
+				out[j - i] = static_cast<char>(tixels[j].character);
+			i = run_end;
+			continue;
+		}
 
-		uint32_t chr = root_staging_buffer[i].character;
-		output.push_back((char)(chr & 0xFF));
-		if (chr & 0x80) output.push_back((char)((chr >> 8) & 0xFF));
-		if (chr & 0x8000) output.push_back((char)((chr >> 16) & 0xFF));
-		if (chr & 0x800000) output.push_back((char)((chr >> 24) & 0xFF));
+		// otherwise this is a multi-byte UTF-8 character, whose length is given by its first byte
+		uint32_t chr = tixels[i].character;
+		uint8_t lead = static_cast<uint8_t>(chr & 0xFF);
+		size_t length = (lead < 0xC0) ? 1 : (lead < 0xE0) ? 2 : (lead < 0xF0) ? 3 : 4;
+		char bytes[4] = { (char)(chr & 0xFF), (char)((chr >> 8) & 0xFF), (char)((chr >> 16) & 0xFF), (char)((chr >> 24) & 0xFF) };
+		output.append(bytes, length);
+		i++;
 	}
-	DEBUG_TIMER_E(transcoding);
-
-	OUTPUT_TARGET << output;
-	OUTPUT_TARGET.flush();
+}
 
-	delete[] root_staging_buffer;
+bool Renderer::handleInput(Component* focused_component, const Keymap* keymap)
+{
+	static const vector<Input::Shortcut> no_shortcuts;
+	return handleInput(focused_component, no_shortcuts, keymap);
 }
 
-bool Renderer::handleInput(Component* focused_component, vector<Input::Shortcut> shortcut_bindings)
+bool Renderer::handleInput(Component* focused_component, const vector<Input::Shortcut>& shortcut_bindings, const Keymap* keymap)
 {
 	auto keys = Input::getQueuedKeyEvents();
 	bool has_input = keys.size() > 0;
-	Input::processShortcuts(shortcut_bindings, keys);
-	auto text_keys = stui::Input::getTextCharacters(keys);
+	if (!shortcut_bindings.empty()) Input::processShortcuts(shortcut_bindings, keys);
+
+	const Keymap* layers[3] = { (focused_component == nullptr) ? nullptr : focused_component->keymap, keymap, &global_keymap };
+	for (const Input::Key& k : keys)
+	{
+		bool consumed = false;
+		for (const Keymap* layer : layers)
+			if (layer != nullptr && layer->trigger(k)) { consumed = true; break; }
+		if (consumed || focused_component == nullptr)
+		{
+			// keep the pasted text lined up with the remaining `PASTE` events
+			if (k.key == Input::SpecialKeys::PASTE) Input::takePastedText();
+			continue;
+		}
 
-	if (focused_component == nullptr) return has_input;
-	for (pair<uint8_t, Input::ControlKeys> k : text_keys)
-		focused_component->handleInput(k.first, k.second);
+		if (k.key == Input::SpecialKeys::PASTE)
+			consumed = focused_component->handleTextInput(Input::takePastedText());
+		else if (Input::isTextCharacter(k))
+			consumed = focused_component->handleInput(static_cast<uint8_t>(k.key), k.control_states);
+		if (consumed) focused_component->markDirty();
+	}
 
 	return has_input;
 }
@@ -2686,6 +9521,31 @@ inline int Renderer::getConstrainedSize(int available, int _max, int _min)
 
 }
 
+#if defined(STUI_COUNT_ALLOCATIONS) && defined(STUI_IMPLEMENTATION)
+// counts heap allocations so that `Renderer::getLastRenderStats` can report them. define
+// `STUI_COUNT_ALLOCATIONS` alongside `STUI_IMPLEMENTATION` to replace the global allocator.
+// none of these are inlined, since GCC otherwise warns about `malloc`ed memory reaching `delete`
+#if defined(__GNUC__) && !defined(__clang__)
+#define STUI_NOINLINE __attribute__((noinline))
+#else
+#define STUI_NOINLINE
+#endif
+STUI_NOINLINE void* operator new(size_t size)
+{
+	stui::allocation_count++;
+	void* memory = malloc(size == 0 ? 1 : size);
+	if (memory == nullptr) throw bad_alloc();
+	return memory;
+}
+
+STUI_NOINLINE void* operator new[](size_t size) { return operator new(size); }
+STUI_NOINLINE void operator delete(void* memory) noexcept { free(memory); }
+STUI_NOINLINE void operator delete[](void* memory) noexcept { free(memory); }
+STUI_NOINLINE void operator delete(void* memory, size_t) noexcept { free(memory); }
+STUI_NOINLINE void operator delete[](void* memory, size_t) noexcept { free(memory); }
+#undef STUI_NOINLINE
+#endif
+
 #endif
 
 #endif
@@ -2693,14 +9553,18 @@ inline int Renderer::getConstrainedSize(int available, int _max, int _min)
 #ifndef STUI_KEEP_DEFINES
 
 #undef RENDER_STUB
+#undef RENDERVIEW_STUB
+#undef LAYOUT_STUB
 #undef GETMINSIZE_STUB
 #undef GETMAXSIZE_STUB
+#undef FIXEDSIZE_STUB
 #undef HANDLEINPUT_STUB
+#undef HANDLETEXTINPUT_STUB
 #undef ISFOCUSABLE_STUB
 #undef GETTYPENAME_STUB
 #undef GETALLCHILDREN_STUB
-
-#undef OUTPUT_TARGET
+#undef GETCHILDCOUNT_STUB
+#undef GETCHILD_STUB
 
 #undef ANSI_ESCAPE
 #undef ANSI_CLEAR_SCREEN
@@ -28,6 +28,16 @@
 
 #include <map>
 #include <queue>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#if defined(__linux__)
+	#include <sys/socket.h>
+	#include <sys/un.h>
+	#include <netinet/in.h>
+	#include <arpa/inet.h>
+#endif
 
 namespace stui
 {
@@ -47,20 +57,46 @@ static Page* current_page = nullptr;
  * 
  * see HELP.md for more information on how to best make use of this.
  */
-class Page
+class Page : public ChildListener
 {
+	friend class SessionServer;
+
 public:
-	vector<Input::Shortcut> shortcuts;
+	Keymap keymap;								// shortcuts which apply to the whole page. TAB is bound to advancing focus by default
+	vector<Input::Shortcut> shortcuts;			// checked before `keymap`, for older code. prefer `keymap`
 	vector<Component*> focusable_component_sequence;
 
 private:
-	map<string, Component*> components;
+	struct RegistryEntry
+	{
+		string name;
+		size_t references;	// number of places the component appears in the tree under `root`
+	};
+
+	unordered_map<string, Component*> components;
+	unordered_map<Component*, RegistryEntry> registered;
+	unordered_map<string, size_t> next_name_index;	// where `getUniqueName` starts counting from, for each type
 	Component* root = nullptr;
 	size_t focused_component_index = 0;
 	clock_type::time_point last_frame;
+	atomic<bool> running{ true };	// cleared by `stop`, and only set again once `run` returns
+	atomic<bool> redraw_requested{ false };
+
+	struct PendingUpdate
+	{
+		function<void()> update;
+		PendingUpdate* next;
+	};
+	atomic<PendingUpdate*> pending_updates{ nullptr };	// most recently posted first
 
 public:
-	Page() { }
+	Page() { keymap.bind(Input::Key{ '\t', Input::ControlKeys::NONE }, advanceFocus); }
+	~Page()
+	{
+		PendingUpdate* node = pending_updates.exchange(nullptr);
+		while (node != nullptr) { PendingUpdate* next = node->next; delete node; node = next; }
+		for (auto& p : registered) p.first->removeListener(this);
+	}
 
 	Page(Page& other) = delete;
 	Page operator=(Page& other) = delete;
@@ -68,6 +104,9 @@ public:
 	/**
 	 * @brief checks for user input and sends it to the currently focused component.
 	 * 
+	 * shortcuts are checked in `shortcuts`, then the focused component's `keymap`, then
+	 * this page's `keymap`, then the global keymap (see `Renderer::handleInput`).
+	 * 
 	 * @returns true if some input was detected, false if none
 	 */
 	bool checkInput()
@@ -78,14 +117,7 @@ public:
 		Component* focused_component = nullptr;
 		if (focused_component_index < focusable_component_sequence.size() && root != nullptr) focused_component = focusable_component_sequence[focused_component_index];
 
-		vector<Input::Shortcut> shortcuts_tmp = shortcuts;
-		shortcuts_tmp.push_back(Input::Shortcut
-		{
-			Input::Key{ '\t', Input::ControlKeys::NONE },
-			advanceFocus
-		});
-
-		return Renderer::handleInput(focused_component, shortcuts_tmp);
+		return Renderer::handleInput(focused_component, shortcuts, &keymap);
 	}
 #endif
 	;
@@ -96,12 +128,19 @@ public:
 	 * you only actually need to do this if something has changed: for instance,
 	 * you changed the text of a component, or some input was received from the
 	 * user, or the terminal window was resized.
+	 *
+	 * if caching is enabled with `Renderer::enableCaching`, only the components
+	 * which have been marked with `Component::markDirty` (and anything which has
+	 * moved as a result) are actually redrawn.
+	 *
+	 * any updates queued with `post` are applied first.
 	 */
 	void render()
 #ifdef STUI_IMPLEMENTATION
 	{
 		current_page = this;
 
+		processUpdates();
 		if (root == nullptr) return;
 		updateFocus();
 		Renderer::render(root);
@@ -131,6 +170,149 @@ public:
 #endif
 	;
 
+	/**
+	 * @brief runs the page until `stop` is called, sleeping whenever there's nothing to do.
+	 *
+	 * the page is only redrawn when there's input from the user, the terminal is resized,
+	 * the timer fires, an `Animator` timer changes something, or `invalidate` is called, so
+	 * an idle interface uses no CPU time.
+	 * this replaces the usual `framerate`/`checkInput`/`render` loop.
+	 *
+	 * @param timer_interval seconds between calls to `timer_callback`, which is useful for
+	 * things that change on their own, like a clock. zero or less disables the timer
+	 * @param timer_callback function to call each time the timer fires, just before the
+	 * page is redrawn. may be null
+	 */
+	void run(float timer_interval = 0.0f, void (*timer_callback)() = nullptr)
+#ifdef STUI_IMPLEMENTATION
+	{
+		bool needs_redraw = true;
+		auto timer_duration = chrono::duration_cast<clock_type::duration>(chrono::duration<float>(timer_interval));
+		auto next_timer = clock_type::now() + timer_duration;
+
+		while (running)
+		{
+			if (redraw_requested.exchange(false)) needs_redraw = true;
+			if (Terminal::isTerminalResized()) needs_redraw = true;
+			if (needs_redraw)
+			{
+				render();
+				needs_redraw = false;
+			}
+
+			float timeout = -1.0f;
+			if (timer_interval > 0.0f)
+				timeout = max(0.0f, chrono::duration<float>(next_timer - clock_type::now()).count());
+			float animation_timeout = Animator::getTimeUntilNext();
+			if (animation_timeout >= 0.0f && (timeout < 0.0f || animation_timeout < timeout)) timeout = animation_timeout;
+			if (!running) break;
+			Terminal::waitForEvents(timeout);
+
+			if (checkInput()) needs_redraw = true;
+			if (Animator::update()) needs_redraw = true;
+			if (timer_interval > 0.0f && clock_type::now() >= next_timer)
+			{
+				if (timer_callback != nullptr) timer_callback();
+				needs_redraw = true;
+				next_timer += timer_duration;
+				// if we've fallen behind, don't try to catch up with a burst of timer events
+				if (next_timer < clock_type::now()) next_timer = clock_type::now() + timer_duration;
+			}
+		}
+		running = true;
+	}
+#endif
+	;
+
+	/**
+	 * @brief asks a running `run` loop to redraw the page as soon as possible. safe to
+	 * call from any thread.
+	 */
+	inline void invalidate()
+	{
+		redraw_requested = true;
+		Terminal::postWakeup();
+	}
+
+	/**
+	 * @brief makes `run` return, after it finishes whatever it's currently doing. safe to
+	 * call from any thread, or from inside a callback. if `run` hasn't started yet, it
+	 * returns as soon as it's called.
+	 */
+	inline void stop()
+	{
+		running = false;
+		Terminal::postWakeup();
+	}
+
+	/**
+	 * @brief queues a function to be run on the thread which draws the page, the next
+	 * time it's drawn. this is how other threads should change components, since
+	 * changing them directly while the page is being drawn isn't safe.
+	 *
+	 * safe to call from any thread, and never blocks. updates are applied in the order
+	 * they were posted. wakes up `run` if it's waiting.
+	 *
+	 * @param update function to run
+	 */
+	void post(function<void()> update)
+#ifdef STUI_IMPLEMENTATION
+	{
+		PendingUpdate* node = new PendingUpdate{ move(update), pending_updates.load(memory_order_relaxed) };
+		while (!pending_updates.compare_exchange_weak(node->next, node, memory_order_release, memory_order_relaxed)) { }
+		invalidate();
+	}
+#endif
+	;
+
+	/**
+	 * @brief queues a change to a component, which is applied on the thread which draws
+	 * the page (see the other version of `post`). the component is marked dirty afterwards.
+	 *
+	 * @param component component being changed
+	 * @param mutation function which makes the change
+	 */
+	inline void post(Component* component, function<void()> mutation)
+	{
+		post([component, mutation]() { mutation(); if (component != nullptr) component->markDirty(); });
+	}
+
+	/**
+	 * @brief applies all of the updates queued with `post`. called automatically by
+	 * `render`, so you shouldn't normally need to call this yourself.
+	 *
+	 * @returns number of updates applied
+	 */
+	size_t processUpdates()
+#ifdef STUI_IMPLEMENTATION
+	{
+		PendingUpdate* node = pending_updates.exchange(nullptr, memory_order_acquire);
+
+		// the queue is built newest-first, so reverse it to apply things in the order they were posted
+		PendingUpdate* ordered = nullptr;
+		while (node != nullptr)
+		{
+			PendingUpdate* next = node->next;
+			node->next = ordered;
+			ordered = node;
+			node = next;
+		}
+
+		size_t applied = 0;
+		while (ordered != nullptr)
+		{
+			PendingUpdate* next = ordered->next;
+			ordered->update();
+			delete ordered;
+			ordered = next;
+			applied++;
+		}
+
+		return applied;
+	}
+#endif
+	;
+
 	/**
 	 * @brief checks that all components in the UI tree are registered with
 	 * the page.
@@ -146,46 +328,33 @@ public:
 	 *
 	 * if `root` is null when this is called, the entire registry will be
 	 * cleared.
+	 *
+	 * containers tell the page when their children are changed with functions
+	 * like `VerticalBox::setChildren` or `BorderedBox::setChild`, and the registry
+	 * is updated for just the affected components, so you only need to call this
+	 * if you've changed a container's children directly.
 	 */
 	void ensureIntegrity()
 #ifdef STUI_IMPLEMENTATION
 	{
-		if (root == nullptr)
-		{
-			for (auto p : components) unregisterComponent(p.first);
-			DEBUG_LOG("ensure integrity called, root was null so the registry was cleared");
-		}
-
-		map<Component*, int> discovered_nodes;
-		queue<Component*> to_check;
-		to_check.push(root);
-		while (!to_check.empty())
-		{
-			Component* comp = to_check.front();
-			to_check.pop();
-			discovered_nodes.insert_or_assign(comp, 0);
-
-			vector<Component*> children = comp->getAllChildren();
-			for (Component* c : children) to_check.push(c);
-		}
+		unordered_map<Component*, size_t> discovered_nodes;
+		if (root == nullptr) DEBUG_LOG("ensure integrity called, root was null so the registry will be cleared");
+		else countReferences(root, discovered_nodes);
 
-		map<Component*, string> known_nodes;
-		vector<Component*> new_nodes;
-		size_t ignored_nodes = 0;
-		for (auto p : components) known_nodes.insert(pair<Component*, string>(p.second, p.first));
+		vector<string> removed_names;
+		for (auto& p : registered)
+			if (discovered_nodes.count(p.first) == 0) removed_names.push_back(p.second.name);
+		for (const string& name : removed_names) unregisterComponent(name);
 
-		for (auto p : discovered_nodes)
+		size_t new_nodes = 0;
+		for (auto& p : discovered_nodes)
 		{
-			Component* c = p.first;
-			if (known_nodes.count(c) != 0) { known_nodes.erase(c); ignored_nodes++; }
-			else new_nodes.push_back(c);
+			if (registered.count(p.first) == 0) { registerComponent(p.first, ""); new_nodes++; }
+			registered[p.first].references = p.second;
 		}
 
-		for (auto p : known_nodes) unregisterComponent(p.second);
-		for (auto c : new_nodes) registerComponent(c, "");
-
 #ifdef DEBUG
-		DEBUG_LOG("ensure integrity called, registered " + to_string(new_nodes.size()) + " new nodes, ignored " + to_string(ignored_nodes) + " existing nodes, unregistered " + to_string(known_nodes.size()) + " no-longer-referenced nodes.");
+		DEBUG_LOG("ensure integrity called, registered " + to_string(new_nodes) + " new nodes, ignored " + to_string(discovered_nodes.size() - new_nodes) + " existing nodes, unregistered " + to_string(removed_names.size()) + " no-longer-referenced nodes.");
 		string dbg = "component registry now looks like this:";
 		for (auto p : components)
 			dbg += "\n\t" + p.first + " : " + to_string((size_t)p.second);
@@ -207,11 +376,21 @@ public:
 	inline Component* operator[](string identifier) { return components[identifier]; }
 
 	/**
-	 * @brief assign a new root component. automatically calls `ensureIntegrity`.
+	 * @brief assign a new root component. the new tree is registered and the old one is
+	 * unregistered, except for anything the two have in common, which keeps its name.
 	 *
 	 * @param component component to make the new root
 	 */
-	inline void setRoot(Component* component) { registerComponent(component, ""); root = component; ensureIntegrity(); }
+	void setRoot(Component* component)
+#ifdef STUI_IMPLEMENTATION
+	{
+		Component* old_root = root;
+		root = component;
+		attachSubtree(component);
+		detachSubtree(old_root);
+	}
+#endif
+	;
 
 	/**
 	 * @brief get the current root of the UI tree.
@@ -220,12 +399,23 @@ public:
 	 */
 	inline Component* getRoot() { return root; }
 
+	/**
+	 * @brief find the innermost component under a particular position on the screen, according
+	 * to the layout calculated during the last call to `render`.
+	 *
+	 * @param position position on the screen, relative to the top-left corner
+	 *
+	 * @returns component under the position, or null if there isn't one
+	 */
+	inline Component* getComponentAt(Coordinate position) { return (root == nullptr) ? nullptr : root->findComponentAt(position); }
+
 	/**
 	 * @brief add a component to the registry, with a specified name.
 	 *
 	 * if the specified name is not unique, or is an empty string, a
-	 * new unique one will be generated. does not check for the
-	 * component already being in the registry.
+	 * new unique one will be generated. if the component is already in
+	 * the registry, it's renamed if the name is unique, otherwise it
+	 * keeps its old name.
 	 *
 	 * @param component new component to add to the registry
 	 * @param identifier name for the new component, optional if you
@@ -236,13 +426,20 @@ public:
 	string registerComponent(Component* component, string identifier = "")
 #ifdef STUI_IMPLEMENTATION
 	{
-		string name = identifier;
-		if (isNameUnique(name)) components.insert(pair<string, Component*>(name, component));
-		else
+		auto existing = registered.find(component);
+		if (existing != registered.end())
 		{
-			name = getUniqueName(component->getTypeName());
-			components.insert(pair<string, Component*>(name, component));
+			if (!isNameUnique(identifier)) return existing->second.name;
+			components.erase(existing->second.name);
+			components.emplace(identifier, component);
+			existing->second.name = identifier;
+			return identifier;
 		}
+
+		string name = isNameUnique(identifier) ? identifier : getUniqueName(component->getTypeName());
+		components.emplace(name, component);
+		registered.emplace(component, RegistryEntry{ name, 0 });
+		component->addListener(this);
 		return name;
 	}
 #endif
@@ -259,10 +456,13 @@ public:
 	Component* unregisterComponent(string identifier)
 #ifdef STUI_IMPLEMENTATION
 	{
-		if (components.count(identifier) != 0)
+		auto it = components.find(identifier);
+		if (it != components.end())
 		{
-			Component* c = components[identifier];
-			components.erase(identifier);
+			Component* c = it->second;
+			components.erase(it);
+			registered.erase(c);
+			c->removeListener(this);
 			return c;
 		}
 		else throw runtime_error("no component registered with that name");
@@ -274,20 +474,12 @@ public:
 	/**
 	 * @brief checks if a component exists in the registry.
 	 *
-	 * potentially slow for large pages.
-	 *
 	 * @param component component to check for
 	 *
 	 * @returns true if the component is already registered, false
 	 * if not
 	 */
-	inline bool isComponentRegistered(Component* component)
-	{
-		for (pair<string, Component*> p : components)
-			if (p.second == component) return true;
-
-		return false;
-	}
+	inline bool isComponentRegistered(Component* component) { return registered.count(component) != 0; }
 
 	/**
 	 * @brief ensures that only one component is focused. specifically the
@@ -298,13 +490,17 @@ public:
 	inline void updateFocus()
 	{
 		for (size_t i = 0; i < focusable_component_sequence.size(); i++)
-			focusable_component_sequence[i]->focused = (i == focused_component_index);
+		{
+			Component* c = focusable_component_sequence[i];
+			bool should_focus = (i == focused_component_index);
+			if (c->focused != should_focus) { c->focused = should_focus; c->markDirty(); }
+		}
 	}
-private:
 
 	/**
 	 * @brief callback for when the shortcut for advancing to the next focusable
-	 * component is triggered, usually pressing tab.
+	 * component is triggered, usually pressing tab. bind your own function in its
+	 * place if you need to know when the focus moves, and call this from it.
 	 *
 	 * acts on the currently active page, which is set automatically by whichever
 	 * page is currently consuming input/rendering.
@@ -339,6 +535,7 @@ private:
 #endif
 	;
 
+private:
 	/**
 	 * @brief check if a name already exsists in the registry or not.
 	 *
@@ -364,15 +561,731 @@ private:
 	 */
 	inline string getUniqueName(string type)
 	{
-		size_t i = 0;
+		size_t& i = next_name_index[type];
 
 		while (components.count("__component_" + type + '_' + to_string(i)) != 0)
 			i++;
 
-		return "__component_" + type + '_' + to_string(i);
+		return "__component_" + type + '_' + to_string(i++);
+	}
+
+	/**
+	 * @brief adds one to the number of places a component appears in the tree, registering
+	 * it (and everything inside it) if this is the first.
+	 *
+	 * @param component root of the subtree being added. may be null
+	 */
+	void attachSubtree(Component* component)
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (component == nullptr) return;
+
+		auto it = registered.find(component);
+		if (it == registered.end())
+		{
+			registerComponent(component, "");
+			it = registered.find(component);
+		}
+		// if it was already in the tree, so is everything inside it
+		if (it->second.references++ > 0) return;
+
+		for (Component* child : component->getChildren()) attachSubtree(child);
 	}
+#endif
+	;
+
+	/**
+	 * @brief takes one away from the number of places a component appears in the tree,
+	 * unregistering it (and everything inside it which isn't also somewhere else) if that
+	 * was the last.
+	 *
+	 * @param component root of the subtree being removed. may be null
+	 */
+	void detachSubtree(Component* component)
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (component == nullptr) return;
+
+		auto it = registered.find(component);
+		if (it == registered.end() || it->second.references == 0) return;
+		if (--it->second.references > 0) return;
+
+		unregisterComponent(it->second.name);
+		for (Component* child : component->getChildren()) detachSubtree(child);
+	}
+#endif
+	;
+
+	/**
+	 * @brief counts how many times every component appears in a subtree, only looking inside
+	 * each one the first time it's found.
+	 *
+	 * @param component root of the subtree. may be null
+	 * @param counts number of times each component has been found so far
+	 */
+	static void countReferences(Component* component, unordered_map<Component*, size_t>& counts)
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (component == nullptr) return;
+		if (counts[component]++ > 0) return;
+		for (Component* child : component->getChildren()) countReferences(child, counts);
+	}
+#endif
+	;
+
+	/**
+	 * @brief registers a child which was added to a container in the tree.
+	 */
+	void childAttached(Component* container, Component* child) override
+#ifdef STUI_IMPLEMENTATION
+	{
+		auto it = registered.find(container);
+		if (it != registered.end() && it->second.references > 0) attachSubtree(child);
+	}
+#endif
+	;
+
+	/**
+	 * @brief unregisters a child which was removed from a container in the tree, unless
+	 * it's still somewhere else in the tree.
+	 */
+	void childDetached(Component* container, Component* child) override
+#ifdef STUI_IMPLEMENTATION
+	{
+		auto it = registered.find(container);
+		if (it != registered.end() && it->second.references > 0) detachSubtree(child);
+	}
+#endif
+	;
+
+	/**
+	 * @brief forgets about a registered component which no longer exists.
+	 */
+	void componentDestroyed(Component* component) override
+#ifdef STUI_IMPLEMENTATION
+	{
+		auto it = registered.find(component);
+		if (it != registered.end())
+		{
+			components.erase(it->second.name);
+			registered.erase(it);
+		}
+		if (root == component) root = nullptr;
+	}
+#endif
+	;
 };
 
+/**
+ * @brief runs a piece of work on a background thread, so that slow things (like waiting
+ * for another program to finish) don't stop the interface from responding.
+ *
+ * the work function must not touch components directly. instead, it should send its
+ * results back with `post`, which queues them to be applied by the `Page` the next time
+ * it's drawn; this can be done as many times as you like, so results can be shown as they
+ * arrive. long-running work should check `isCancelled` every so often.
+ *
+ * destroying the `Task` cancels it and waits for the thread to finish.
+ */
+class Task
+{
+private:
+	Page& page;
+	atomic<bool> running{ true };
+	atomic<bool> cancelled{ false };
+	thread worker;
+
+public:
+	/**
+	 * @brief starts running some work on a new thread.
+	 *
+	 * @param _page page which results should be posted to
+	 * @param work function to run on the background thread. it is given this `Task`
+	 * @param on_finished function to run on the page's thread once the work is done. may be null
+	 */
+	Task(Page& _page, function<void(Task&)> work, function<void()> on_finished = nullptr) : page(_page)
+	{
+		worker = thread([this, work, on_finished]()
+		{
+			work(*this);
+			running = false;
+			if (on_finished) page.post(on_finished);
+			else page.invalidate();
+		});
+	}
+
+	Task(Task& other) = delete;
+	Task operator=(Task& other) = delete;
+
+	~Task()
+	{
+		cancel();
+		if (worker.joinable()) worker.join();
+	}
+
+	/**
+	 * @brief queues an update to be applied on the page's thread. see `Page::post`.
+	 *
+	 * @param update function to run
+	 */
+	inline void post(function<void()> update) { page.post(move(update)); }
+
+	/**
+	 * @brief queues a change to a component, which is marked dirty afterwards. see `Page::post`.
+	 *
+	 * @param component component being changed
+	 * @param mutation function which makes the change
+	 */
+	inline void post(Component* component, function<void()> mutation) { page.post(component, move(mutation)); }
+
+	/**
+	 * @brief asks the work function to stop early. it's up to the work function to check
+	 * `isCancelled` and return.
+	 */
+	inline void cancel() { cancelled = true; }
+
+	/**
+	 * @brief checks whether `cancel` has been called.
+	 *
+	 * @returns true if the work should stop
+	 */
+	inline bool isCancelled() const { return cancelled; }
+
+	/**
+	 * @brief checks whether the work function is still running.
+	 *
+	 * @returns true if the work hasn't finished yet
+	 */
+	inline bool isRunning() const { return running; }
+};
+
+#if defined(__linux__)
+/**
+ * @brief serves one `Page` to any number of terminals connected over TCP or Unix sockets, so
+ * that many people can watch (and use) the same interface from a single process.
+ *
+ * each connection becomes a `Session` with its own size, input, and focus, while the
+ * components themselves are shared, so a change to one is seen by everybody. connections
+ * which are the same size and have the same component focused share a single layout and
+ * drawing pass each frame.
+ *
+ * the other end needs to be a terminal in raw mode, for instance
+ * `socat -,raw,echo=0 TCP:host:port`. its size is asked for with an escape code when it
+ * connects and every few seconds after, since there's no other way to find out over a
+ * socket. if the size is known some other way (like an SSH channel's window-change request),
+ * pass it to `setSessionSize`, after which that connection's terminal isn't asked again.
+ *
+ * keymap callbacks run with the connection whose input triggered them active, so
+ * `Terminal::getSession` tells you who pressed the key.
+ */
+class SessionServer
+{
+private:
+	struct Connection : public TerminalBackend
+	{
+		int fd;
+		Coordinate size{ 80, 24 };
+		string raw;			// bytes received which haven't been checked for size reports yet
+		string received;	// input waiting to be read by the session
+		string unsent;		// output the socket wasn't ready for
+		size_t focused_component_index = 0;
+		bool closing = false;
+		bool size_fixed = false;	// set by `setSessionSize`, after which the terminal isn't asked for its size
+		bool in_paste = false;		// inside a bracketed paste, whose contents are passed on untouched
+		uint8_t paste_marker = 0;	// how much of a paste start or end sequence has been seen so far
+		clock_type::time_point recheck_input_at = clock_type::time_point::max();
+		Session session{ this };
+
+		Connection(int _fd) : fd(_fd) { }
+
+		void write(const char* data, size_t length) override;
+		inline Coordinate getSize() override { return size; }
+		inline bool providesInput() override { return true; }
+		size_t read(char* buffer, size_t capacity) override;
+
+		bool flush();
+		bool receive(const char* data, size_t length);
+	};
+
+	Page* page;
+	vector<int> listeners;
+	string unix_path;
+	vector<unique_ptr<Connection>> connections;
+	atomic<bool> running{ true };	// cleared by `stop`, and only set again once `run` returns
+	atomic<bool> redraw_requested{ false };
+
+	static constexpr size_t MAX_UNSENT = 4 * 1024 * 1024;	// connections which fall this far behind are dropped
+	static constexpr float SIZE_QUERY_INTERVAL = 2.0f;
+
+public:
+	function<void(Session*)> on_connect;	// called when someone connects, with their session active
+	function<void(Session*)> on_disconnect;	// called just before a connection is closed
+
+	SessionServer(Page* _page) : page(_page) { }
+	~SessionServer()
+#ifdef STUI_IMPLEMENTATION
+	{
+		while (!connections.empty()) closeConnection(connections.size() - 1);
+		for (int fd : listeners) close(fd);
+		if (!unix_path.empty()) unlink(unix_path.c_str());
+	}
+#endif
+	;
+
+	SessionServer(SessionServer& other) = delete;
+	SessionServer operator=(SessionServer& other) = delete;
+
+	/**
+	 * @brief starts accepting connections on a TCP port.
+	 *
+	 * @param port port to listen on
+	 * @param address address to listen on. the default only accepts connections from this machine
+	 *
+	 * @returns true if the port could be listened on
+	 */
+	bool listenTCP(uint16_t port, const string& address = "127.0.0.1")
+#ifdef STUI_IMPLEMENTATION
+	{
+		sockaddr_in socket_address{ };
+		socket_address.sin_family = AF_INET;
+		socket_address.sin_port = htons(port);
+		if (inet_pton(AF_INET, address.c_str(), &socket_address.sin_addr) != 1) return false;
+
+		int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		if (fd < 0) return false;
+		int reuse = 1;
+		setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+		if (bind(fd, reinterpret_cast<sockaddr*>(&socket_address), sizeof(socket_address)) != 0 || listen(fd, 16) != 0)
+		{
+			close(fd);
+			return false;
+		}
+		listeners.push_back(fd);
+		return true;
+	}
+#endif
+	;
+
+	/**
+	 * @brief starts accepting connections on a Unix socket. anything already at that path
+	 * is removed first, and the socket is removed again when the server is destroyed.
+	 *
+	 * @param path where to create the socket
+	 *
+	 * @returns true if the socket could be created
+	 */
+	bool listenUnix(const string& path)
+#ifdef STUI_IMPLEMENTATION
+	{
+		sockaddr_un socket_address{ };
+		socket_address.sun_family = AF_UNIX;
+		if (path.size() >= sizeof(socket_address.sun_path)) return false;
+		memcpy(socket_address.sun_path, path.c_str(), path.size() + 1);
+
+		int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		if (fd < 0) return false;
+		unlink(path.c_str());
+		if (bind(fd, reinterpret_cast<sockaddr*>(&socket_address), sizeof(socket_address)) != 0 || listen(fd, 16) != 0)
+		{
+			close(fd);
+			return false;
+		}
+		listeners.push_back(fd);
+		unix_path = path;
+		return true;
+	}
+#endif
+	;
+
+	/**
+	 * @brief serves a connection which has already been made some other way, like an SSH
+	 * channel. the server takes ownership of the file descriptor.
+	 *
+	 * @param fd connected socket or pipe, to be read from and written to
+	 *
+	 * @returns the new connection's session
+	 */
+	Session* addConnection(int fd)
+#ifdef STUI_IMPLEMENTATION
+	{
+		fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+		connections.emplace_back(new Connection(fd));
+		Connection* connection = connections.back().get();
+
+		// bracketed paste, then ask how big the terminal is
+		connection->write("\033[?2004h\033[18t", 14);
+
+		if (on_connect)
+		{
+			Session* previously_active = Terminal::getSession();
+			Terminal::setSession(&connection->session);
+			on_connect(&connection->session);
+			Terminal::setSession(previously_active);
+		}
+		redraw_requested = true;
+		return &connection->session;
+	}
+#endif
+	;
+
+	/**
+	 * @brief tells the server how big a connection's terminal is, and stops asking it.
+	 *
+	 * @param session session of the connection
+	 * @param size new size in characters
+	 */
+	void setSessionSize(Session* session, Coordinate size)
+#ifdef STUI_IMPLEMENTATION
+	{
+		Connection* connection = findConnection(session);
+		if (connection == nullptr) return;
+		connection->size = size;
+		connection->size_fixed = true;
+		invalidate();
+	}
+#endif
+	;
+
+	/**
+	 * @brief closes a connection once the server has finished what it's doing. safe to call
+	 * from inside a callback, for instance with `Terminal::getSession()` to log someone out.
+	 *
+	 * @param session session of the connection to close
+	 */
+	void disconnect(Session* session)
+#ifdef STUI_IMPLEMENTATION
+	{
+		Connection* connection = findConnection(session);
+		if (connection != nullptr) connection->closing = true;
+	}
+#endif
+	;
+
+	/**
+	 * @returns the number of connections currently being served
+	 */
+	inline size_t getSessionCount() const { return connections.size(); }
+
+	/**
+	 * @brief serves connections until `stop` is called, sleeping whenever there's nothing to
+	 * do. like `Page::run`, everyone's screen is only redrawn when something happens.
+	 *
+	 * @param timer_interval seconds between calls to `timer_callback`. zero or less disables the timer
+	 * @param timer_callback function to call each time the timer fires, just before everything
+	 * is redrawn. may be null
+	 */
+	void run(float timer_interval = 0.0f, void (*timer_callback)() = nullptr)
+#ifdef STUI_IMPLEMENTATION
+	{
+		bool needs_redraw = true;
+		auto timer_duration = chrono::duration_cast<clock_type::duration>(chrono::duration<float>(timer_interval));
+		auto next_timer = clock_type::now() + timer_duration;
+		auto query_duration = chrono::duration_cast<clock_type::duration>(chrono::duration<float>(SIZE_QUERY_INTERVAL));
+		auto next_size_query = clock_type::now() + query_duration;
+		vector<pollfd> fds;
+
+		while (running)
+		{
+			if (redraw_requested.exchange(false) || page->redraw_requested.exchange(false)) needs_redraw = true;
+			if (needs_redraw)
+			{
+				render();
+				needs_redraw = false;
+			}
+			removeClosedConnections();
+			if (!running) break;
+
+			// sleep until something happens, or the next thing we have to do ourselves
+			auto now = clock_type::now();
+			auto wake_at = next_size_query;
+			if (timer_interval > 0.0f) wake_at = min(wake_at, next_timer);
+			for (auto& connection : connections) wake_at = min(wake_at, connection->recheck_input_at);
+			float animation_timeout = Animator::getTimeUntilNext();
+			if (animation_timeout >= 0.0f)
+				wake_at = min(wake_at, now + chrono::duration_cast<clock_type::duration>(chrono::duration<float>(animation_timeout)));
+			int timeout = max(0, static_cast<int>(ceil(chrono::duration<float, milli>(wake_at - now).count())));
+
+			fds.clear();
+			int wakeup_fd = Terminal::getWakeupDescriptor();
+			fds.push_back(pollfd{ wakeup_fd, POLLIN, 0 });
+			for (int fd : listeners) fds.push_back(pollfd{ fd, POLLIN, 0 });
+			for (auto& connection : connections)
+				fds.push_back(pollfd{ connection->fd, static_cast<short>(POLLIN | (connection->unsent.empty() ? 0 : POLLOUT)), 0 });
+			if (poll(fds.data(), fds.size(), timeout) < 0 && errno != EINTR) break;
+
+			if (fds[0].revents & POLLIN)
+			{
+				char buffer[64];
+				while (wakeup_fd >= 0 && ::read(wakeup_fd, buffer, sizeof(buffer)) > 0) { }
+			}
+			for (size_t i = 0; i < listeners.size(); i++)
+			{
+				if (!(fds[1 + i].revents & POLLIN)) continue;
+				int fd = accept4(listeners[i], nullptr, nullptr, SOCK_CLOEXEC);
+				if (fd >= 0) addConnection(fd);
+			}
+
+			now = clock_type::now();
+			size_t first_connection = 1 + listeners.size();
+			for (size_t i = 0; i + first_connection < fds.size() && i < connections.size(); i++)
+			{
+				Connection* connection = connections[i].get();
+				short events = fds[i + first_connection].revents;
+				if ((events & POLLOUT) && !connection->flush()) connection->closing = true;
+				if (events & (POLLIN | POLLHUP | POLLERR))
+				{
+					char buffer[4096];
+					ssize_t bytes = ::read(connection->fd, buffer, sizeof(buffer));
+					if (bytes <= 0) { if (bytes == 0 || (errno != EAGAIN && errno != EINTR)) connection->closing = true; continue; }
+					if (connection->receive(buffer, static_cast<size_t>(bytes))) needs_redraw = true;
+					if (checkInput(connection)) needs_redraw = true;
+					// an escape on its own might be the start of a sequence, so look again shortly
+					connection->recheck_input_at = now + chrono::milliseconds(25);
+				}
+				else if (now >= connection->recheck_input_at)
+				{
+					connection->recheck_input_at = clock_type::time_point::max();
+					if (checkInput(connection)) needs_redraw = true;
+				}
+			}
+
+			if (now >= next_size_query)
+			{
+				for (auto& connection : connections)
+					if (!connection->size_fixed) connection->write("\033[18t", 5);
+				next_size_query = now + query_duration;
+			}
+			if (timer_interval > 0.0f && now >= next_timer)
+			{
+				if (timer_callback != nullptr) timer_callback();
+				needs_redraw = true;
+				next_timer += timer_duration;
+				if (next_timer < now) next_timer = now + timer_duration;
+			}
+			if (Animator::update()) needs_redraw = true;
+		}
+		running = true;
+	}
+#endif
+	;
+
+	/**
+	 * @brief asks a running `run` loop to redraw everyone's screen as soon as possible. safe
+	 * to call from any thread. `Page::invalidate` and `Page::post` work too.
+	 */
+	inline void invalidate()
+	{
+		redraw_requested = true;
+		Terminal::postWakeup();
+	}
+
+	/**
+	 * @brief makes `run` return, after it finishes whatever it's currently doing. safe to
+	 * call from any thread, or from inside a callback. if `run` hasn't started yet, it
+	 * returns as soon as it's called.
+	 */
+	inline void stop()
+	{
+		running = false;
+		Terminal::postWakeup();
+	}
+
+private:
+	/**
+	 * @brief draws the page to every connection, a group at a time, with each group's focus
+	 * applied to the page first.
+	 */
+	void render()
+#ifdef STUI_IMPLEMENTATION
+	{
+		current_page = page;
+		page->processUpdates();
+		if (page->root == nullptr) return;
+
+		size_t own_focus = page->focused_component_index;
+		vector<bool> done(connections.size(), false);
+		vector<Session*> group;
+		for (size_t i = 0; i < connections.size(); i++)
+		{
+			if (done[i] || connections[i]->closing) continue;
+			size_t focus = connections[i]->focused_component_index;
+			group.clear();
+			for (size_t j = i; j < connections.size(); j++)
+			{
+				if (done[j] || connections[j]->closing || connections[j]->focused_component_index != focus) continue;
+				group.push_back(&connections[j]->session);
+				done[j] = true;
+			}
+			page->focused_component_index = focus;
+			page->updateFocus();
+			Renderer::render(page->root, group);
+		}
+		page->focused_component_index = own_focus;
+	}
+#endif
+	;
+
+	/**
+	 * @brief sends a connection's waiting input through the page, with its session and focus
+	 * active.
+	 *
+	 * @returns true if there was any input
+	 */
+	bool checkInput(Connection* connection)
+#ifdef STUI_IMPLEMENTATION
+	{
+		Session* previously_active = Terminal::getSession();
+		size_t own_focus = page->focused_component_index;
+		Terminal::setSession(&connection->session);
+		page->focused_component_index = connection->focused_component_index;
+		page->updateFocus();
+
+		bool had_input = page->checkInput();
+
+		connection->focused_component_index = page->focused_component_index;
+		page->focused_component_index = own_focus;
+		Terminal::setSession(previously_active);
+		return had_input;
+	}
+#endif
+	;
+
+	Connection* findConnection(Session* session)
+#ifdef STUI_IMPLEMENTATION
+	{
+		for (auto& connection : connections)
+			if (&connection->session == session) return connection.get();
+		return nullptr;
+	}
+#endif
+	;
+
+	void removeClosedConnections()
+#ifdef STUI_IMPLEMENTATION
+	{
+		for (size_t i = connections.size(); i > 0; i--)
+			if (connections[i - 1]->closing) closeConnection(i - 1);
+	}
+#endif
+	;
+
+	void closeConnection(size_t index)
+#ifdef STUI_IMPLEMENTATION
+	{
+		Connection* connection = connections[index].get();
+		if (on_disconnect) on_disconnect(&connection->session);
+		if (Terminal::getSession() == &connection->session) Terminal::setSession(nullptr);
+
+		// put the other end's terminal back how it was, if it's still listening. this goes
+		// straight to the socket, since `write` ignores connections which are closing
+		static const char reset[] = "\033[0m\033[?2004l\033[?25h\033[2J\033[H";
+		connection->flush();
+		send(connection->fd, reset, sizeof(reset) - 1, MSG_NOSIGNAL | MSG_DONTWAIT);
+		close(connection->fd);
+		connections.erase(connections.begin() + index);
+	}
+#endif
+	;
+};
+
+#ifdef STUI_IMPLEMENTATION
+void SessionServer::Connection::write(const char* data, size_t length)
+{
+	if (closing) return;
+	if (unsent.empty())
+	{
+		ssize_t sent = send(fd, data, length, MSG_NOSIGNAL | MSG_DONTWAIT);
+		if (sent < 0)
+		{
+			if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) { closing = true; return; }
+			sent = 0;
+		}
+		data += sent;
+		length -= static_cast<size_t>(sent);
+	}
+	if (length == 0) return;
+
+	// whatever the socket wasn't ready for is sent once it is, unless it's fallen too far behind
+	unsent.append(data, length);
+	if (unsent.size() > MAX_UNSENT) closing = true;
+}
+
+bool SessionServer::Connection::flush()
+{
+	while (!unsent.empty())
+	{
+		ssize_t sent = send(fd, unsent.data(), unsent.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+		if (sent < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+		unsent.erase(0, static_cast<size_t>(sent));
+	}
+	return true;
+}
+
+size_t SessionServer::Connection::read(char* buffer, size_t capacity)
+{
+	size_t length = min(capacity, received.size());
+	memcpy(buffer, received.data(), length);
+	received.erase(0, length);
+	return length;
+}
+
+bool SessionServer::Connection::receive(const char* data, size_t length)
+{
+	// pick out the terminal's replies about its size (`ESC[8;rows;columnst`), and pass everything
+	// else on as input. replies are ignored once the size has been fixed. returns true if the size changed
+	raw.append(data, length);
+	bool resized = false;
+	size_t search_from = 0;
+	size_t keep_from = raw.size();
+	while (true)
+	{
+		size_t start = raw.find("\033[8", search_from);
+		if (start == string::npos) break;
+
+		int values[2] = { 0, 0 };
+		int value_index = -1;
+		size_t i = start + 3;
+		bool complete = false;
+		bool valid = true;
+		for (; i < raw.size(); i++)
+		{
+			char c = raw[i];
+			if (c == ';' && value_index < 1) value_index++;
+			else if (c >= '0' && c <= '9' && value_index >= 0) values[value_index] = (values[value_index] * 10) + (c - '0');
+			else if (c == 't' && value_index == 1) { complete = true; break; }
+			else { valid = false; break; }
+		}
+		if (!valid) { search_from = start + 1; continue; }
+		if (!complete) { keep_from = start; break; }
+
+		if (!size_fixed && values[0] > 0 && values[1] > 0 && (values[1] != size.x || values[0] != size.y))
+		{
+			size = Coordinate{ values[1], values[0] };
+			resized = true;
+		}
+		raw.erase(start, i + 1 - start);
+		search_from = start;
+	}
+
+	// a local terminal turns enter into a newline before STUI sees it, so do the same here, except
+	// inside pastes. paste markers (`ESC[200~` and `ESC[201~`) may be split between reads
+	size_t input_start = received.size();
+	received.append(raw, 0, keep_from);
+	raw.erase(0, keep_from);
+	for (size_t i = input_start; i < received.size(); i++)
+	{
+		char c = received[i];
+		if (paste_marker == 4 && (c == '0' || c == '1')) paste_marker = (c == '0') ? 5 : 6;
+		else if (paste_marker >= 5 && c == '~') { in_paste = paste_marker == 5; paste_marker = 0; }
+		else if (paste_marker < 4 && c == "\033[20"[paste_marker]) paste_marker++;
+		else paste_marker = (c == '\033') ? 1 : 0;
+		if (c == '\r' && !in_paste) received[i] = '\n';
+	}
+	return resized;
+}
+#endif
+#endif
+
 /**
  * @brief renders a QR code inside the terminal. data buffer must be an array
  * of booleans, sized to provide enough data for the QR code version selected.
@@ -425,6 +1338,125 @@ public:
 	GETMINSIZE_STUB{ return Coordinate{ (version * 2) - 1, version }; }
 };
 
+/**
+ * @brief shows the measurements from the `Profiler` as they're taken: how long the last frame
+ * took and what it did, a histogram of frame times, and the components which took longest.
+ *
+ * creating one doesn't turn profiling on; call `Profiler::enable(true)` when you want it. the
+ * overlay is marked dirty after every profiled frame, so it's redrawn in the next one (it doesn't
+ * cause frames by itself, so it only changes when something else is redrawn).
+ */
+class ProfilerOverlay : public Component, public Utility
+{
+public:
+	static constexpr int MAX_SLOWEST = 8;
+
+	int slowest_shown;	// number of the slowest components to list, up to `MAX_SLOWEST`
+
+	ProfilerOverlay(int _slowest_shown = 3) : slowest_shown(_slowest_shown)
+	{
+		callback_id = Profiler::addFrameCallback([this](const Profiler::FrameProfile& frame) { takeSnapshot(frame); });
+	}
+
+	ProfilerOverlay(ProfilerOverlay& other) = delete;
+	ProfilerOverlay operator=(ProfilerOverlay& other) = delete;
+
+	~ProfilerOverlay() { Profiler::removeFrameCallback(callback_id); }
+
+	GETTYPENAME_STUB("ProfilerOverlay");
+
+	RENDER_STUB
+#ifdef STUI_IMPLEMENTATION
+	{
+		if (size.y < 1) return;
+		Coordinate line_size{ size.x, 1 };
+		int y = 0;
+		if (!Profiler::isEnabled() && frame.frame == 0)
+		{
+			drawText("profiling is off", Coordinate{ 0,0 }, line_size, output_buffer, size);
+			return;
+		}
+
+		drawText(scratchFormat("frame %zu: %.2fms", frame.frame, frame.total_seconds * 1000.0f), Coordinate{ 0,y++ }, line_size, output_buffer, size);
+		drawText(scratchFormat(" layout %.2f draw %.2f out %.2f", frame.layout_seconds * 1000.0f, frame.draw_seconds * 1000.0f, frame.output_seconds * 1000.0f), Coordinate{ 0,y++ }, line_size, output_buffer, size);
+		drawText(scratchFormat(" laid out %zu drawn %zu allocs %zu", frame.components_laid_out, frame.components_drawn, frame.allocations), Coordinate{ 0,y++ }, line_size, output_buffer, size);
+		drawText(scratchFormat(" %zu bytes %zu cells%s", frame.bytes_emitted, frame.cells_changed, frame.full_repaint ? " (full)" : ""), Coordinate{ 0,y++ }, line_size, output_buffer, size);
+
+		// one column per histogram bucket, scaled so the tallest bucket is a full block
+		if (y < size.y)
+		{
+			const Profiler::FrameHistogram& histogram = Profiler::getHistogram();
+			size_t tallest = 1;
+			for (int b = 0; b < Profiler::FrameHistogram::BUCKETS; b++) tallest = max(tallest, histogram.counts[b]);
+			drawText("<.25ms", Coordinate{ 0,y }, line_size, output_buffer, size);
+			for (int b = 0; b < Profiler::FrameHistogram::BUCKETS && 7 + b < size.x; b++)
+			{
+				size_t level = (histogram.counts[b] * 8 + tallest - 1) / tallest;
+				output_buffer[(y * size.x) + 7 + b] = (level == 0) ? (uint32_t)' ' : UNICODE_BLOCK_1_8 + (static_cast<uint32_t>(level - 1) << 16);
+			}
+			drawText(">64ms", Coordinate{ 8 + Profiler::FrameHistogram::BUCKETS,y }, line_size, output_buffer, size);
+			y++;
+		}
+
+		for (int i = 0; i < slowest_count && y < size.y; i++, y++)
+			drawText(scratchFormat(" %-16s %.3fms", slowest[i].name, slowest[i].seconds * 1000.0f), Coordinate{ 0,y }, line_size, output_buffer, size);
+	}
+#endif
+	;
+
+	GETMINSIZE_STUB { return Coordinate{ 36, 5 + min(max(slowest_shown, 0), MAX_SLOWEST) }; }
+	GETMAXSIZE_STUB { return getMinSize(); }
+
+private:
+	struct SlowComponent
+	{
+		char name[17];
+		float seconds;
+	};
+
+	size_t callback_id = 0;
+	Profiler::FrameProfile frame{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, false };
+	SlowComponent slowest[MAX_SLOWEST];
+	int slowest_count = 0;
+
+	/**
+	 * @brief copies what the overlay needs out of the profile, since components in the timings
+	 * might not exist by the time the overlay is drawn.
+	 */
+	void takeSnapshot(const Profiler::FrameProfile& _frame)
+#ifdef STUI_IMPLEMENTATION
+	{
+		frame = _frame;
+		int wanted = min(max(slowest_shown, 0), MAX_SLOWEST);
+		const Profiler::ComponentTiming* found[MAX_SLOWEST];
+		int found_count = 0;
+		for (const Profiler::ComponentTiming& t : Profiler::getComponentTimings())
+		{
+			if (t.component == this) continue;
+			float seconds = t.layout_seconds + t.render_seconds;
+			// keep the list sorted, slowest first
+			int position = found_count;
+			while (position > 0 && (found[position - 1]->layout_seconds + found[position - 1]->render_seconds) < seconds) position--;
+			if (position >= wanted) continue;
+			if (found_count < wanted) found_count++;
+			for (int i = found_count - 1; i > position; i--) found[i] = found[i - 1];
+			found[position] = &t;
+		}
+
+		slowest_count = found_count;
+		for (int i = 0; i < found_count; i++)
+		{
+			string name = found[i]->component->getTypeName();
+			if (name.empty()) name = "Component";
+			snprintf(slowest[i].name, sizeof(slowest[i].name), "%s", name.c_str());
+			slowest[i].seconds = found[i]->layout_seconds + found[i]->render_seconds;
+		}
+		markDirty();
+	}
+#endif
+	;
+};
+
 }
 
 #define STUI_ONLY_UNDEFS
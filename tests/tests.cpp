@@ -0,0 +1,482 @@
+// checks behaviour which is easy to break without noticing: each test drives the library the way
+// an application would (usually through a `VirtualTerminal`, with key presses fed in as the bytes a
+// terminal would send) and checks what comes out.
+//
+// build and run with `make test`, which builds them twice: once as normal, and once with
+// `STUI_TRUECOLOUR`. pass a test name to only run that one.
+
+#define STUI_IMPLEMENTATION
+#include <stui.h>
+#include <stui_extensions.h>
+
+#include <cstdio>
+#include <cstring>
+
+using namespace stui;
+
+static int failures = 0;
+
+#define CHECK(condition) do { if (!(condition)) { printf("  FAILED: %s (line %d)\n", #condition, __LINE__); failures++; } } while (0)
+
+/**
+ * @brief a `VirtualTerminal` which also hands back key presses, as the bytes a real terminal
+ * would send for them.
+ **/
+class ScriptedTerminal : public VirtualTerminal
+{
+public:
+	string input;
+
+	ScriptedTerminal(Coordinate _size) : VirtualTerminal(_size) { }
+
+	bool providesInput() override { return true; }
+
+	size_t read(char* buffer, size_t capacity) override
+	{
+		size_t length = min(capacity, input.size());
+		memcpy(buffer, input.data(), length);
+		input.erase(0, length);
+		return length;
+	}
+
+	// sends some input through `Renderer::handleInput`, then draws a frame
+	void type(const string& bytes, Component* root, Component* focused)
+	{
+		input += bytes;
+		Renderer::handleInput(focused);
+		Renderer::render(root);
+	}
+};
+
+static void testEditorUndoKeys()
+{
+	ScriptedTerminal terminal(Coordinate{ 40, 6 });
+	Terminal::setBackend(&terminal);
+	TextEditor editor("");
+	editor.focused = true;
+
+	// ctrl+z and ctrl+y are the bytes 0x1a and 0x19
+	terminal.type("hello", &editor, &editor);
+	terminal.type(" world", &editor, &editor);
+	CHECK(editor.getText() == "hello world");
+	terminal.type("\x1a", &editor, &editor);
+	CHECK(editor.getText() == "");
+	CHECK(terminal.getLine(0).find("hello") == string::npos);
+	terminal.type("\x19", &editor, &editor);
+	CHECK(editor.getText() == "hello world");
+	CHECK(terminal.getLine(0).find("hello world") != string::npos);
+
+	// a keymap of the application's own still leaves the editor's shortcuts working
+	bool saved = false;
+	editor.editing_keys.bind(Input::Key{ 'S', Input::ControlKeys::CTRL }, [&]() { saved = true; });
+	terminal.type("\x13\x1a", &editor, &editor);
+	CHECK(saved);
+	CHECK(editor.getText() == "");
+
+	Terminal::setBackend(nullptr);
+}
+
+static void testTextAreaDirectEdit()
+{
+	VirtualTerminal terminal(Coordinate{ 20, 10 });
+	Terminal::setBackend(&terminal);
+	TextArea area("first\nlog\nlog\nlog\nlog\nlog\n", 0);
+	Renderer::render(&area);
+	CHECK(terminal.getLine(0).find("first") == 0);
+
+	// the end of the text looks the same as before, but it wasn't only added to
+	area.text.insert(0, "log\n");
+	area.markDirty();
+	Renderer::render(&area);
+	CHECK(terminal.getLine(0).find("log") == 0);
+	CHECK(terminal.getLine(1).find("first") == 0);
+
+	// whereas text which really is added to the end keeps the rest of the wrapping
+	area.append("last\n");
+	area.markDirty();
+	Renderer::render(&area);
+	CHECK(terminal.getLine(7).find("last") == 0);
+	CHECK(area.getLineCount() == 8);
+
+	Terminal::setBackend(nullptr);
+}
+
+static void testUnfinishedPaste()
+{
+	ScriptedTerminal terminal(Coordinate{ 20, 4 });
+	Terminal::setBackend(&terminal);
+	TextInputBox input("", nullptr, true);
+	input.focused = true;
+	TextEditor editor("");
+	editor.focused = true;
+
+	// a paste with no end marker is handed over once nothing more arrives for a while
+	terminal.type("\x1b[200~abc", &input, &input);
+	CHECK(input.text == "");
+	this_thread::sleep_for(chrono::milliseconds(1100));
+	terminal.type("d\x7f", &input, &input);
+	CHECK(input.text == "abc");
+
+	// and so is one which goes on for far too long, so the typing after it still counts
+	input.text.clear();
+	terminal.type("\x1b[200~" + string(2 << 20, 'x'), &input, &input);
+	terminal.type("\x7f", &input, &input);
+	CHECK(input.text.length() == (2 << 20) - 1);
+
+	Terminal::setBackend(nullptr);
+}
+
+static void testLogViewBytes()
+{
+	// kept under the byte limit long before the line limit, while the ring is still growing
+	LogView log(1000, 100);
+	for (int i = 0; i < 500; i++) log.appendLine("line " + to_string(i));
+	CHECK(log.getByteCount() <= 100);
+	CHECK(log.getLine(log.getLineCount() - 1) == "line 499");
+	for (size_t i = 0; i < log.getLineCount(); i++)
+		CHECK(log.getLine(i) == "line " + to_string(500 - log.getLineCount() + i));
+
+	// and then by lines, once the bytes allow more
+	log.max_bytes = 0;
+	log.max_lines = 40;
+	for (int i = 500; i < 600; i++) log.appendLine("line " + to_string(i));
+	CHECK(log.getLineCount() == 40);
+	CHECK(log.getLine(0) == "line 560");
+	CHECK(log.getLine(39) == "line 599");
+}
+
+// waits for a `TableView` to finish building its order, which arrives through the `Animator`
+static void waitForTable(TableView& table)
+{
+	for (int i = 0; i < 500 && table.isBuilding(); i++)
+	{
+		this_thread::sleep_for(chrono::milliseconds(2));
+		Animator::update();
+	}
+}
+
+static void testTableRefresh()
+{
+	vector<vector<string>> data{ { "apple", "1" }, { "banana", "2" }, { "cherry", "3" }, { "damson", "4" } };
+	TableView table({ { "fruit", 10, -1 }, { "n", 4, 1 } }, [&]() { return data.size(); },
+		[&](size_t row, size_t column) { return data[row][column]; }, 0, 0);
+
+	table.setFilter("an");
+	waitForTable(table);
+	CHECK(!table.isBuilding());
+	CHECK(table.getDisplayedRowCount() == 1);
+
+	// the same number of rows, with different cells, must be searched again
+	data[3][0] = "mango";
+	table.refresh();
+	waitForTable(table);
+	CHECK(table.getDisplayedRowCount() == 2);
+	CHECK(table.getDataRow(1) == 3);
+
+	// and so must re-sorting, which would otherwise start from the old order
+	data[0][1] = "9";
+	table.setFilter("");
+	table.sortBy(1);
+	table.refresh();
+	waitForTable(table);
+	CHECK(table.getDataRow(3) == 0);
+
+	// narrowing the filter afterwards starts from the refreshed order
+	data[2][0] = "cherry and";
+	table.refresh();
+	table.setFilter("an");
+	waitForTable(table);
+	CHECK(table.getDisplayedRowCount() == 3);
+}
+
+static void testEmptyRootClears()
+{
+	VirtualTerminal terminal(Coordinate{ 20, 4 });
+	Terminal::setBackend(&terminal);
+	Label label("hello", -1);
+	Component empty;
+
+	for (bool caching : { false, true })
+	{
+		Renderer::enableCaching(caching);
+		Renderer::render(&label);
+		CHECK(terminal.getLine(0).find("hello") != string::npos);
+		// a root with no size draws nothing, but whatever was there before must still go
+		Renderer::render(&empty);
+		CHECK(terminal.getLine(0).find("hello") == string::npos);
+	}
+
+	Renderer::enableCaching(false);
+	Terminal::setBackend(nullptr);
+}
+
+// takes a while to draw, and notices if it's ever drawn by two threads at once
+class SlowView : public Component
+{
+public:
+	atomic<int> drawing{ 0 };
+	atomic<bool> overlapped{ false };
+
+	Coordinate getMaxSize() override { return Coordinate{ -1, -1 }; }
+
+	void render(Tixel* output_buffer, Coordinate size) override
+	{
+		if (drawing.fetch_add(1) != 0) overlapped = true;
+		this_thread::sleep_for(chrono::milliseconds(3));
+		output_buffer[0] = 'x';
+		drawing.fetch_sub(1);
+	}
+};
+
+static void testParallelSharedChild()
+{
+	VirtualTerminal terminal(Coordinate{ 40, 10 });
+	Terminal::setBackend(&terminal);
+	Renderer::enableParallelRendering(true, 2);
+
+	SlowView first, second;
+	VerticalBox left({ &first });
+	VerticalBox right({ &second });
+	HorizontalBox root({ &left, &right });
+	for (int i = 0; i < 3; i++) Renderer::render(&root);
+
+	// both boxes were worth drawing on their own threads; now they share a child, set directly
+	// rather than through `attachChild`
+	right.children[0] = &first;
+	for (int i = 0; i < 3; i++) Renderer::render(&root);
+	CHECK(!first.overlapped);
+
+	Renderer::enableParallelRendering(false);
+	Terminal::setBackend(nullptr);
+}
+
+// a `ProgressBar` which asks for more height than the one it inherits from `FIXEDSIZE_STUB`
+class TallBar : public ProgressBar
+{
+public:
+	TallBar() : ProgressBar(0.5f) { }
+
+	Coordinate getMinSize() override { return Coordinate{ 5, 6 }; }
+};
+
+static void testStaticLayoutSubclass()
+{
+	CHECK(VBox<TallBar>::has_fixed_size == false);
+	CHECK((HBox<ProgressBar*, Bordered<Label>>::has_fixed_size == false));
+
+	VBox<Bordered<TallBar>, TallBar> layout;
+	TallBar inner, second;
+	BorderedBox bordered(&inner, "");
+	VerticalBox dynamic({ &bordered, &second });
+	CHECK(layout.getLayoutMinSize().x == dynamic.getLayoutMinSize().x);
+	CHECK(layout.getLayoutMinSize().y == dynamic.getLayoutMinSize().y);
+	CHECK(layout.getLayoutMinSize().y == 14);
+	CHECK(layout.getLayoutMaxSize().y == dynamic.getLayoutMaxSize().y);
+}
+
+static void testUtf8Typing()
+{
+	ScriptedTerminal terminal(Coordinate{ 20, 4 });
+	Terminal::setBackend(&terminal);
+	TextInputBox input("", nullptr, true);
+	input.focused = true;
+	TextEditor editor("");
+	editor.focused = true;
+
+	terminal.type("caf\xc3\xa9 \xe2\x82\xac", &input, &input);
+	CHECK(input.text == "caf\xc3\xa9 \xe2\x82\xac");
+	CHECK(terminal.getLine(0).find("> caf\xc3\xa9 \xe2\x82\xac") == 0);
+	// backspace takes off a whole character, not one byte of it
+	terminal.type("\x7f\x7f", &input, &input);
+	CHECK(input.text == "caf\xc3\xa9");
+
+	terminal.type("na\xc3\xafve", &editor, &editor);
+	CHECK(editor.getText() == "na\xc3\xafve");
+	CHECK(terminal.getLine(0).find("na\xc3\xafve") == 0);
+	// left steps over whole characters too
+	terminal.type("\x1b[D\x1b[D\x7f", &editor, &editor);
+	CHECK(editor.getText() == "nave");
+	// moving between lines keeps to the column the cursor is drawn in, not its byte on the line
+	editor.setText("\xc3\xa9\xc3\xa9\xc3\xa9\nabcdef");
+	editor.setCursor(6);
+	terminal.type("\x1b[B", &editor, &editor);
+	CHECK(editor.getCursor() == 10);
+	terminal.type("\x1b[D\x1b[A", &editor, &editor);
+	CHECK(editor.getCursor() == 4);
+
+	// text which is wrapped is measured in characters, not bytes
+	string accents;
+	for (int i = 0; i < 15; i++) accents += "\xc3\xa9";
+	TextArea area(accents, 0);
+	Renderer::render(&area);
+	CHECK(area.getLineCount() == 1);
+	CHECK(terminal.getLine(0).find(accents) == 0);
+
+	Terminal::setBackend(nullptr);
+}
+
+#ifdef STUI_TRUECOLOUR
+// fills itself with a different 24-bit colour in every cell, starting from `first`
+class GradientView : public Component
+{
+public:
+	uint32_t first = 0;
+
+	Coordinate getMaxSize() override { return Coordinate{ -1, -1 }; }
+	void render(Tixel* output_buffer, Coordinate size) override
+	{
+		for (int i = 0; i < size.x * size.y; i++)
+		{
+			output_buffer[i] = Tixel{ 'x', static_cast<Tixel::ColourCommand>(Tixel::ColourCommand::FG_WHITE | Tixel::ColourCommand::BG_BLACK) };
+			output_buffer[i].setTrueColour(first + static_cast<uint32_t>(i), 0xFFFFFF - first - static_cast<uint32_t>(i));
+		}
+	}
+};
+
+// draws itself once in a single 24-bit colour, and then leaves it alone
+class StillView : public Component
+{
+public:
+	Coordinate getMaxSize() override { return Coordinate{ 10, -1 }; }
+	void render(Tixel* output_buffer, Coordinate size) override
+	{
+		for (int i = 0; i < size.x * size.y; i++)
+		{
+			output_buffer[i] = Tixel{ 'y', static_cast<Tixel::ColourCommand>(Tixel::ColourCommand::FG_WHITE | Tixel::ColourCommand::BG_BLACK) };
+			output_buffer[i].setTrueColour(0x123456, 0x654321);
+		}
+	}
+};
+
+static void testTrueColourCount()
+{
+	VirtualTerminal terminal(Coordinate{ 100, 100 });
+	Terminal::setBackend(&terminal);
+	GradientView view;
+	StillView still;
+	HorizontalBox root({ &view, &still });
+
+	for (bool caching : { false, true })
+	{
+		Renderer::enableCaching(caching);
+		// far more than 65536 different colours, which used to run out of palette entries
+		for (uint32_t frame = 0; frame < 12; frame++)
+		{
+			view.first = frame * 10000;
+			view.markDirty();
+			Renderer::render(&root);
+		}
+		const VirtualTerminal::Cell& first = terminal.getCell(Coordinate{ 0, 0 });
+		const VirtualTerminal::Cell& last = terminal.getCell(Coordinate{ 89, 99 });
+		CHECK(first.foreground == (VirtualTerminal::RGB_COLOUR | 110000));
+		CHECK(first.background == (VirtualTerminal::RGB_COLOUR | (0xFFFFFF - 110000)));
+		CHECK(last.foreground == (VirtualTerminal::RGB_COLOUR | (110000 + 8999)));
+		CHECK(last.background == (VirtualTerminal::RGB_COLOUR | (0xFFFFFF - 110000 - 8999)));
+		// whatever was drawn with palette entries from before the palette was last emptied is
+		// drawn again, even if it hasn't changed
+		const VirtualTerminal::Cell& unchanged = terminal.getCell(Coordinate{ 95, 50 });
+		CHECK(unchanged.foreground == (VirtualTerminal::RGB_COLOUR | 0x123456));
+		CHECK(unchanged.background == (VirtualTerminal::RGB_COLOUR | 0x654321));
+	}
+
+	Renderer::enableCaching(false);
+	Terminal::setBackend(nullptr);
+}
+#endif
+
+#if defined(__linux__)
+static SessionServer* running_server = nullptr;
+
+static void stopRunningServer() { running_server->stop(); }
+
+static void testDisconnectReset()
+{
+	Label label("hello", -1);
+	Page page;
+	page.setRoot(&label);
+	SessionServer server(&page);
+	int fds[2];
+	CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+	Session* session = server.addConnection(fds[0]);
+
+	// the connection is closed by the first pass of `run`, which the timer then stops
+	server.disconnect(session);
+	running_server = &server;
+	server.run(0.01f, stopRunningServer);
+	CHECK(server.getSessionCount() == 0);
+
+	// the other end gets its terminal put back how it was before the socket closes
+	string received;
+	char buffer[4096];
+	ssize_t length;
+	while ((length = recv(fds[1], buffer, sizeof(buffer), 0)) > 0) received.append(buffer, static_cast<size_t>(length));
+	CHECK(received.find("\033[0m\033[?2004l\033[?25h\033[2J\033[H") != string::npos);
+	close(fds[1]);
+	running_server = nullptr;
+}
+
+static void testStopBeforeRun()
+{
+	// a stop which comes before the loop starts isn't lost, so both of these return straight away
+	Label label("hello", -1);
+	Page page;
+	page.setRoot(&label);
+	page.stop();
+	page.run();
+	SessionServer server(&page);
+	server.stop();
+	server.run();
+
+	// and the next run goes on until it's stopped again
+	int fds[2];
+	CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+	server.addConnection(fds[0]);
+	running_server = &server;
+	server.run(0.01f, stopRunningServer);
+	CHECK(server.getSessionCount() == 1);
+	close(fds[1]);
+	running_server = nullptr;
+}
+#endif
+
+struct Test
+{
+	const char* name;
+	void (*run)();
+};
+
+static const Test tests[] =
+{
+	{ "editor_undo_keys", testEditorUndoKeys },
+	{ "textarea_direct_edit", testTextAreaDirectEdit },
+	{ "unfinished_paste", testUnfinishedPaste },
+	{ "log_view_bytes", testLogViewBytes },
+	{ "table_refresh", testTableRefresh },
+	{ "static_layout_subclass", testStaticLayoutSubclass },
+	{ "empty_root_clears", testEmptyRootClears },
+	{ "parallel_shared_child", testParallelSharedChild },
+	{ "utf8_typing", testUtf8Typing },
+#if defined(__linux__)
+	{ "disconnect_reset", testDisconnectReset },
+	{ "stop_before_run", testStopBeforeRun },
+#endif
+#ifdef STUI_TRUECOLOUR
+	{ "true_colour_count", testTrueColourCount },
+#endif
+};
+
+int main(int argc, char** argv)
+{
+	const char* only = (argc > 1) ? argv[1] : nullptr;
+	int run = 0;
+	for (const Test& test : tests)
+	{
+		if (only != nullptr && strcmp(only, test.name) != 0) continue;
+		int failures_before = failures;
+		test.run();
+		printf("%s %s\n", (failures == failures_before) ? "ok  " : "FAIL", test.name);
+		run++;
+	}
+	if (run == 0) { printf("no test called %s\n", only); return 1; }
+	return (failures == 0) ? 0 : 1;
+}